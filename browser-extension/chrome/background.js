@@ -91,6 +91,13 @@ chrome.runtime.onMessage.addListener((message, _sender, sendResponse) => {
   return true;
 });
 
+// The server keeps one override per source and drops it when heartbeats stop
+// (e.g. the browser was killed), so it never sticks around forever.
+const CONTEXT_SOURCE = "browser:chrome";
+const CONTEXT_WINDOW_APP_ID = "chrom";
+const CONTEXT_TTL_SECONDS = 150;
+const HEARTBEAT_ALARM = "concentrate-heartbeat";
+
 function sendToServer(data) {
   if (!data || !data.app_id || !data.title) return;
   fetch(serverUrl, {
@@ -98,7 +105,12 @@ function sendToServer(data) {
     headers: {
       "Content-Type": "application/json",
     },
-    body: JSON.stringify(data),
+    body: JSON.stringify({
+      ...data,
+      source: CONTEXT_SOURCE,
+      window_app_id: CONTEXT_WINDOW_APP_ID,
+      ttl: CONTEXT_TTL_SECONDS,
+    }),
   })
     .then((response) => response.json())
     .then((data) => {
@@ -161,4 +173,17 @@ chrome.windows.onFocusChanged.addListener(async (windowId) => {
   }
 });
 
+chrome.alarms.create(HEARTBEAT_ALARM, { periodInMinutes: 1 });
+chrome.alarms.onAlarm.addListener(async (alarm) => {
+  if (alarm.name !== HEARTBEAT_ALARM) return;
+  // Background state may have been unloaded since the last event; ask the browser again.
+  const window = await chrome.windows.getLastFocused({ populate: true });
+  if (!window?.focused) return;
+  const activeTab = window.tabs?.find((tab) => tab.active);
+  if (!activeTab) return;
+  const appid = cleanUrl(activeTab.url);
+  if (appid === "null") return;
+  sendToServer({ app_id: appid, title: activeTab.title, focus: true });
+});
+
 setActionFocused(false);
@@ -84,6 +84,13 @@ browser.runtime.onMessage.addListener(async (message) => {
 });
 
 // Function to send data to the server
+// The server keeps one override per source and drops it when heartbeats stop
+// (e.g. the browser was killed), so it never sticks around forever.
+const CONTEXT_SOURCE = "browser:firefox";
+const CONTEXT_WINDOW_APP_ID = "firefox";
+const CONTEXT_TTL_SECONDS = 150;
+const HEARTBEAT_ALARM = "concentrate-heartbeat";
+
 function sendToServer(data) {
   if (!data || !data.app_id || !data.title) return;
   fetch(serverUrl, {
@@ -91,7 +98,12 @@ function sendToServer(data) {
     headers: {
       "Content-Type": "application/json",
     },
-    body: JSON.stringify(data),
+    body: JSON.stringify({
+      ...data,
+      source: CONTEXT_SOURCE,
+      window_app_id: CONTEXT_WINDOW_APP_ID,
+      ttl: CONTEXT_TTL_SECONDS,
+    }),
   })
     .then((response) => response.json())
     .then((data) => {
@@ -163,4 +175,17 @@ browser.windows.onFocusChanged.addListener(async (windowId) => {
 });
 
 // Initialize UI on background start.
+browser.alarms.create(HEARTBEAT_ALARM, { periodInMinutes: 1 });
+browser.alarms.onAlarm.addListener(async (alarm) => {
+  if (alarm.name !== HEARTBEAT_ALARM) return;
+  // Background state may have been unloaded since the last event; ask the browser again.
+  const window = await browser.windows.getLastFocused({ populate: true });
+  if (!window?.focused) return;
+  const activeTab = window.tabs?.find((tab) => tab.active);
+  if (!activeTab) return;
+  const appid = cleanUrl(activeTab.url);
+  if (appid === "null") return;
+  sendToServer({ app_id: appid, title: activeTab.title, focus: true });
+});
+
 setActionFocused(false);
@@ -1,7 +1,30 @@
 local M = {}
 
+local uv = vim.uv or vim.loop
+
+-- Persistent connection to the daemon's NDJSON command socket.
+local ctl = { pipe = nil, connecting = false, queue = {} }
+
 -- ─────────────────────────────────────
-function M.send_project_status(port, payload)
+local function ctl_socket_path()
+	local runtime_dir = os.getenv("XDG_RUNTIME_DIR")
+	if runtime_dir == nil or runtime_dir == "" then
+		return "/tmp/concentrate-" .. uv.getuid() .. "/ctl.sock"
+	end
+	return runtime_dir .. "/concentrate/ctl.sock"
+end
+
+-- ─────────────────────────────────────
+local function ctl_reset()
+	if ctl.pipe ~= nil and not ctl.pipe:is_closing() then
+		ctl.pipe:close()
+	end
+	ctl.pipe = nil
+	ctl.connecting = false
+end
+
+-- ─────────────────────────────────────
+function M.send_project_status_http(port, payload)
 	vim.fn.jobstart({
 		"curl",
 		"-s",
@@ -13,16 +36,6 @@ function M.send_project_status(port, payload)
 		payload,
 		"http://localhost:" .. port .. "/api/v1/special_project",
 	}, {
-		on_stdout = function(_, data)
-			if data and #data > 0 then
-				local filtered = {}
-				for _, line in ipairs(data) do
-					if line ~= "" then
-						table.insert(filtered, line)
-					end
-				end
-			end
-		end,
 		on_stderr = function(_, data)
 			if data and #data > 0 then
 				local filtered = {}
@@ -39,6 +52,83 @@ function M.send_project_status(port, payload)
 	})
 end
 
+-- ─────────────────────────────────────
+function M.send_project_status(port, status)
+	local payload = vim.fn.json_encode(status)
+	local line = vim.fn.json_encode(vim.tbl_extend("force", { cmd = "special_project" }, status)) .. "\n"
+
+	if ctl.pipe ~= nil and not ctl.connecting then
+		ctl.pipe:write(line)
+		return
+	end
+
+	-- Keep only the newest pending update while connecting; older ones are stale anyway.
+	ctl.queue = { { line = line, payload = payload } }
+	if ctl.connecting then
+		return
+	end
+
+	local pipe = uv.new_pipe(false)
+	if pipe == nil then
+		M.send_project_status_http(port, payload)
+		return
+	end
+	ctl.pipe = pipe
+	ctl.connecting = true
+
+	pipe:connect(ctl_socket_path(), function(err)
+		local pending = ctl.queue
+		ctl.queue = {}
+		if err ~= nil then
+			ctl_reset()
+			vim.schedule(function()
+				for _, item in ipairs(pending) do
+					M.send_project_status_http(port, item.payload)
+				end
+			end)
+			return
+		end
+
+		ctl.connecting = false
+		-- Replies are only drained; EOF means the daemon went away, so reconnect next time.
+		pipe:read_start(function(read_err, data)
+			if read_err ~= nil or data == nil then
+				ctl_reset()
+			end
+		end)
+		for _, item in ipairs(pending) do
+			pipe:write(item.line)
+		end
+	end)
+end
+
+-- ─────────────────────────────────────
+-- Part of the compositor app_id of the terminal running Neovim (matched case-insensitively), so
+-- the override only applies while that terminal is focused. nil when it cannot be told.
+local function terminal_app_id()
+	local program = os.getenv("TERM_PROGRAM")
+	if program == "vscode" then
+		return "code"
+	end
+	if program ~= nil and program ~= "" and program ~= "tmux" and program ~= "screen" then
+		return program
+	end
+	if os.getenv("KITTY_WINDOW_ID") ~= nil then
+		return "kitty"
+	end
+	if os.getenv("ALACRITTY_WINDOW_ID") ~= nil then
+		return "alacritty"
+	end
+	if os.getenv("WEZTERM_PANE") ~= nil then
+		return "wezterm"
+	end
+	local term = os.getenv("TERM") or ""
+	if term:find("^foot") then
+		return "foot"
+	end
+	return nil
+end
+
 -- ─────────────────────────────────────
 function M.setup(config)
 	local port
@@ -48,48 +138,75 @@ function M.setup(config)
 		port = 7079
 	end
 
+	-- One override per Neovim instance; the server forgets it if heartbeats stop.
+	local source = "neovim:" .. vim.fn.getpid()
+	local ttl = 120
+	local focused = false
+	-- config.window_app_id overrides the detected terminal; false sends none (always applies).
+	local window_app_id = config.window_app_id
+	if window_app_id == nil then
+		window_app_id = terminal_app_id()
+	end
+	if window_app_id == nil then
+		vim.notify(
+			"focusservice: cannot tell the terminal's app_id; set window_app_id so the override "
+				.. "only applies while it is focused",
+			vim.log.levels.WARN
+		)
+	end
+
+	local function status(focus)
+		return {
+			source = source,
+			ttl = ttl,
+			app_id = "Neovim",
+			window_app_id = window_app_id or nil,
+			title = vim.fn.fnamemodify(vim.fn.getcwd(), ":t"),
+			mode = vim.api.nvim_get_mode().mode,
+			focus = focus,
+		}
+	end
+
+	local heartbeat = uv.new_timer()
+	if heartbeat ~= nil then
+		heartbeat:start(
+			(ttl / 2) * 1000,
+			(ttl / 2) * 1000,
+			vim.schedule_wrap(function()
+				if focused then
+					M.send_project_status(port, status(true))
+				end
+			end)
+		)
+	end
+
 	-- Autocmds for focus/unfocus
 	vim.api.nvim_create_autocmd("FocusGained", {
 		callback = function()
-			local project_name = vim.fn.fnamemodify(vim.fn.getcwd(), ":t")
-			local payload = vim.fn.json_encode({ app_id = "Neovim", title = project_name, focus = true })
-			M.send_project_status(port, payload)
+			focused = true
+			M.send_project_status(port, status(true))
 		end,
 	})
 
 	vim.api.nvim_create_autocmd("FocusLost", {
 		callback = function()
-			local project_name = vim.fn.fnamemodify(vim.fn.getcwd(), ":t")
-			local payload = vim.fn.json_encode({ app_id = "Neovim", title = project_name, focus = false })
-			M.send_project_status(port, payload)
+			focused = false
+			M.send_project_status(port, status(false))
 		end,
 	})
 
 	vim.api.nvim_create_autocmd("VimLeavePre", {
 		callback = function()
-			local project_name = vim.fn.fnamemodify(vim.fn.getcwd(), ":t")
-			local payload = vim.fn.json_encode({
-				title = project_name,
-				app_id = "Neovim",
-				focus = false,
-			})
-			M.send_project_status(port, payload)
+			focused = false
+			-- Neovim is exiting: the event loop will not run the async socket callbacks.
+			M.send_project_status_http(port, vim.fn.json_encode(status(false)))
 		end,
 	})
 
 	vim.api.nvim_create_autocmd("ModeChanged", {
 		callback = function()
-			local project_name = vim.fn.fnamemodify(vim.fn.getcwd(), ":t")
-			local current_mode = vim.api.nvim_get_mode().mode
-
-			local payload = vim.fn.json_encode({
-				title = project_name,
-				app_id = "Neovim",
-				mode = current_mode,
-				focus = true,
-			})
-
-			M.send_project_status(port, payload)
+			focused = true
+			M.send_project_status(port, status(true))
 		end,
 	})
 end
@@ -0,0 +1,443 @@
+#!/usr/bin/env python3
+"""
+Stand-in for the Niri and Hyprland IPC sockets, so NiriIPC and HyprlandIPC can be exercised and
+benchmarked without a compositor session (e.g. on a headless CI box).
+
+    niri       $NIRI_SOCKET: one JSON request per line ("FocusedWindow", "Windows",
+               "Workspaces", "EventStream"), one JSON reply line each. After "EventStream" the
+               connection carries WorkspacesChanged and WindowsChanged, then WindowFocusChanged,
+               WindowOpenedOrChanged and WindowClosed events.
+    hyprland   $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE/.socket.sock answers
+               "j/activewindow", "j/activeworkspace" and "j/clients", then closes.
+               .socket2.sock streams activewindow, activewindowv2, openwindow, closewindow,
+               windowtitle and windowtitlev2 lines.
+
+The sockets live in a fresh temporary directory (or --dir); the environment that points
+Concentrate at them is printed on startup. Every --interval seconds (0 = as fast as the clients
+read) focus moves to another window, and with some probability a title changes or a window
+opens or closes.
+
+Faults, for the framing and reconnect paths:
+    --partial-writes   every write goes out in small chunks with short pauses in between
+    --huge-every N     every Nth event is a title change of --huge-bytes (by default past the
+                       4 MiB line limit, so the client has to drop the stream and reconnect)
+    --drop-after N     event streams are closed after N events
+    --stamp            titles of newly focused windows end in "@<CLOCK_MONOTONIC ns>", so a
+                       consumer can measure how long a focus change took to reach it
+
+Usage:
+    python3 resources/fake-compositor.py niri --interval 0.01 --env-file /tmp/fake.env &
+    . /tmp/fake.env && ./concentrate --loginfo
+    python3 resources/fake-compositor.py hyprland --interval 0 --partial-writes --huge-every 1000
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import socket
+import tempfile
+import threading
+import time
+
+APPS = ["firefox", "kitty", "org.gnome.Nautilus", "neovim", "zotero", "Anytype"]
+SIGNATURE = "fake_compositor"
+
+
+# ─────────────────────────────────────
+class Desktop:
+    """Windows on workspaces; at most one of them has focus."""
+
+    def __init__(self, windows, workspaces, rng, stamp):
+        self.lock = threading.Lock()
+        self.rng = rng
+        self.stamp = stamp
+        self.workspaces = workspaces
+        self.next_id = 1
+        self.windows = {}
+        self.focused = None
+        for _ in range(windows):
+            self.open()
+        if self.windows:
+            self.focused = next(iter(self.windows))
+
+    def open(self):
+        window = {
+            "id": self.next_id,
+            "app_id": self.rng.choice(APPS),
+            "title": f"Window {self.next_id}",
+            "workspace": self.rng.randint(1, self.workspaces),
+        }
+        self.next_id += 1
+        self.windows[window["id"]] = window
+        return window
+
+    def focused_window(self):
+        return self.windows.get(self.focused)
+
+    def retitle(self, window, title=None):
+        base = window["title"].split(" — ")[0].split(" @")[0]
+        window["title"] = title if title is not None else f"{base} — {self.rng.randint(1, 999)}"
+
+    def step(self):
+        """Applies one random change; returns it as a list of (change, window) tuples."""
+        with self.lock:
+            roll = self.rng.random()
+            current = self.focused_window()
+
+            if roll < 0.15 and current is not None:
+                self.retitle(current)
+                return [("title", current)]
+
+            if roll < 0.22 and current is not None and len(self.windows) > 1:
+                del self.windows[current["id"]]
+                self.focused = self.rng.choice(list(self.windows))
+                return [("close", current), ("focus", self.focused_window())]
+
+            if roll < 0.29:
+                window = self.open()
+                self.focused = window["id"]
+                return [("open", window), ("focus", window)]
+
+            candidates = [w for w in self.windows.values() if w["id"] != self.focused]
+            if not candidates:
+                return []
+            window = self.rng.choice(candidates)
+            changes = []
+            if self.stamp:
+                base = window["title"].split(" @")[0]
+                window["title"] = f"{base} @{time.monotonic_ns()}"
+                changes.append(("title", window))
+            self.focused = window["id"]
+            changes.append(("focus", window))
+            return changes
+
+    def huge(self, size):
+        """A title change of `size` bytes on the focused window, and the change back."""
+        with self.lock:
+            window = self.focused_window()
+            if window is None:
+                return []
+            original = window["title"]
+            window["title"] = "x" * size
+            huge = ("title", dict(window))
+            window["title"] = original
+            return [huge, ("title", window)]
+
+
+# ─────────────────────────────────────
+class Niri:
+    """niri msg --json: newline-delimited JSON on one socket."""
+
+    def __init__(self, desktop, directory):
+        self.desktop = desktop
+        self.socket_path = os.path.join(directory, "niri.sock")
+
+    def environment(self):
+        return {"NIRI_SOCKET": self.socket_path}
+
+    def window(self, w):
+        return {"id": w["id"], "title": w["title"], "app_id": w["app_id"], "pid": None,
+                "workspace_id": w["workspace"], "is_focused": w["id"] == self.desktop.focused,
+                "is_floating": False, "is_urgent": False}
+
+    def workspaces(self):
+        active = self.desktop.focused_window()
+        active_ws = active["workspace"] if active else 1
+        return [{"id": n, "idx": n, "name": None, "output": "FAKE-1", "is_active": n == active_ws,
+                 "is_focused": n == active_ws, "active_window_id": None}
+                for n in range(1, self.desktop.workspaces + 1)]
+
+    def encode(self, payload):
+        return (json.dumps(payload) + "\n").encode()
+
+    def reply(self, request):
+        with self.desktop.lock:
+            if request == "FocusedWindow":
+                w = self.desktop.focused_window()
+                return {"Ok": {"FocusedWindow": self.window(w) if w else None}}
+            if request == "Windows":
+                return {"Ok": {"Windows": [self.window(w) for w in self.desktop.windows.values()]}}
+            if request == "Workspaces":
+                return {"Ok": {"Workspaces": self.workspaces()}}
+        return {"Err": f"unsupported in fake-compositor: {request!r}"}
+
+    def initial_events(self):
+        with self.desktop.lock:
+            return [self.encode({"WorkspacesChanged": {"workspaces": self.workspaces()}}),
+                    self.encode({"WindowsChanged": {
+                        "windows": [self.window(w) for w in self.desktop.windows.values()]}})]
+
+    def events(self, changes):
+        lines = []
+        for change, w in changes:
+            if change in ("title", "open"):
+                lines.append(self.encode({"WindowOpenedOrChanged": {"window": self.window(w)}}))
+            elif change == "close":
+                lines.append(self.encode({"WindowClosed": {"id": w["id"]}}))
+            elif change == "focus":
+                lines.append(self.encode({"WindowFocusChanged": {"id": w["id"] if w else None}}))
+        return lines
+
+    def bind(self):
+        self.listener = listen(self.socket_path)
+
+    def serve(self, server):
+        while True:
+            conn, _ = self.listener.accept()
+            threading.Thread(target=self.handle, args=(server, conn), daemon=True).start()
+
+    def handle(self, server, conn):
+        server.count("connections")
+        try:
+            reader = conn.makefile("rb")
+            for raw in reader:
+                server.count("requests")
+                try:
+                    request = json.loads(raw)
+                except ValueError:
+                    server.write(conn, self.encode({"Err": "invalid JSON"}))
+                    continue
+                if request == "EventStream":
+                    server.write(conn, self.encode({"Ok": "Handled"}))
+                    server.subscribe(conn, self.initial_events())
+                    continue
+                server.write(conn, self.encode(self.reply(request)))
+        except OSError:
+            pass
+        finally:
+            server.unsubscribe(conn)
+            conn.close()
+
+
+# ─────────────────────────────────────
+class Hyprland:
+    """hyprctl -j on .socket.sock (one request per connection), events on .socket2.sock."""
+
+    def __init__(self, desktop, directory):
+        self.desktop = desktop
+        self.runtime_dir = directory
+        self.folder = os.path.join(directory, "hypr", SIGNATURE)
+        os.makedirs(self.folder, exist_ok=True)
+
+    def environment(self):
+        return {"XDG_RUNTIME_DIR": self.runtime_dir, "HYPRLAND_INSTANCE_SIGNATURE": SIGNATURE}
+
+    @staticmethod
+    def address(w):
+        return f"{0x55550000 + w['id']:x}"
+
+    def client(self, w):
+        return {"address": "0x" + self.address(w), "mapped": True, "hidden": False,
+                "workspace": {"id": w["workspace"], "name": str(w["workspace"])},
+                "floating": False, "class": w["app_id"], "title": w["title"],
+                "initialClass": w["app_id"], "initialTitle": w["title"], "pid": -1,
+                "focusHistoryID": 0 if w["id"] == self.desktop.focused else 1}
+
+    def reply(self, request):
+        with self.desktop.lock:
+            w = self.desktop.focused_window()
+            if request == "j/activewindow":
+                return self.client(w) if w else {}
+            if request == "j/clients":
+                return [self.client(c) for c in self.desktop.windows.values()]
+            if request == "j/activeworkspace":
+                ws = w["workspace"] if w else 1
+                return {"id": ws, "name": str(ws), "monitor": "FAKE-1",
+                        "windows": sum(1 for c in self.desktop.windows.values()
+                                       if c["workspace"] == ws),
+                        "lastwindow": "0x" + self.address(w) if w else "0x0",
+                        "lastwindowtitle": w["title"] if w else ""}
+        return None
+
+    def events(self, changes):
+        lines = []
+        for change, w in changes:
+            if change == "title":
+                lines.append(f"windowtitle>>{self.address(w)}")
+                lines.append(f"windowtitlev2>>{self.address(w)},{w['title']}")
+            elif change == "open":
+                lines.append(f"openwindow>>{self.address(w)},{w['workspace']},"
+                             f"{w['app_id']},{w['title']}")
+            elif change == "close":
+                lines.append(f"closewindow>>{self.address(w)}")
+            elif change == "focus" and w is None:
+                lines += ["activewindow>>,", "activewindowv2>>"]
+            elif change == "focus":
+                lines.append(f"activewindow>>{w['app_id']},{w['title']}")
+                lines.append(f"activewindowv2>>{self.address(w)}")
+        return [(line + "\n").encode() for line in lines]
+
+    def bind(self):
+        self.requests = listen(os.path.join(self.folder, ".socket.sock"))
+        self.events_listener = listen(os.path.join(self.folder, ".socket2.sock"))
+
+    def serve(self, server):
+        threading.Thread(target=self.accept_events, args=(server, self.events_listener),
+                         daemon=True).start()
+        while True:
+            conn, _ = self.requests.accept()
+            threading.Thread(target=self.handle_request, args=(server, conn),
+                             daemon=True).start()
+
+    def handle_request(self, server, conn):
+        server.count("connections")
+        try:
+            request = conn.recv(4096).decode(errors="replace").strip()
+            server.count("requests")
+            payload = self.reply(request)
+            body = json.dumps(payload) if payload is not None else "unknown request"
+            server.write(conn, body.encode())
+        except OSError:
+            pass
+        finally:
+            conn.close()
+
+    def accept_events(self, server, listener):
+        while True:
+            conn, _ = listener.accept()
+            server.count("connections")
+            server.subscribe(conn, [])
+            threading.Thread(target=self.wait_closed, args=(server, conn), daemon=True).start()
+
+    def wait_closed(self, server, conn):
+        try:
+            while conn.recv(4096):
+                pass
+        except OSError:
+            pass
+        finally:
+            server.unsubscribe(conn)
+            conn.close()
+
+
+# ─────────────────────────────────────
+def listen(path):
+    if os.path.exists(path):
+        os.unlink(path)
+    listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    listener.bind(path)
+    listener.listen(16)
+    return listener
+
+
+# ─────────────────────────────────────
+class Server:
+    def __init__(self, options, protocol, desktop):
+        self.options = options
+        self.protocol = protocol
+        self.desktop = desktop
+        self.rng = random.Random(options.seed)
+        self.subscribers = []  # [conn, events sent]
+        self.lock = threading.Lock()
+        self.stats = {"connections": 0, "requests": 0, "events": 0, "drops": 0, "huge": 0}
+
+    def count(self, what, n=1):
+        with self.lock:
+            self.stats[what] += n
+
+    def write(self, conn, data):
+        if not self.options.partial_writes:
+            conn.sendall(data)
+            return
+        offset = 0
+        while offset < len(data):
+            size = self.rng.randint(1, 64)
+            conn.sendall(data[offset:offset + size])
+            offset += size
+            time.sleep(0.0002)
+
+    def subscribe(self, conn, initial):
+        with self.lock:
+            for line in initial:
+                self.write(conn, line)
+            self.subscribers.append([conn, 0])
+
+    def unsubscribe(self, conn):
+        with self.lock:
+            self.subscribers = [s for s in self.subscribers if s[0] is not conn]
+
+    def broadcast(self, lines):
+        with self.lock:
+            for subscriber in list(self.subscribers):
+                conn = subscriber[0]
+                try:
+                    for line in lines:
+                        self.write(conn, line)
+                        subscriber[1] += 1
+                        self.stats["events"] += 1
+                    if self.options.drop_after and subscriber[1] >= self.options.drop_after:
+                        conn.shutdown(socket.SHUT_RDWR)
+                        self.subscribers.remove(subscriber)
+                        self.stats["drops"] += 1
+                except OSError:
+                    self.subscribers.remove(subscriber)
+
+    def script(self):
+        steps = 0
+        while True:
+            if self.options.interval > 0:
+                time.sleep(self.options.interval)
+            steps += 1
+            if self.options.huge_every and steps % self.options.huge_every == 0:
+                changes = self.desktop.huge(self.options.huge_bytes)
+                self.count("huge")
+            else:
+                changes = self.desktop.step()
+            self.broadcast(self.protocol.events(changes))
+            if self.options.interval <= 0 and not self.subscribers:
+                time.sleep(0.01)  # nobody listening; do not spin
+
+
+# ─────────────────────────────────────
+def main():
+    parser = argparse.ArgumentParser(description="Fake Niri/Hyprland IPC sockets")
+    parser.add_argument("protocol", choices=["niri", "hyprland"])
+    parser.add_argument("--dir", help="directory for the sockets (default: a new temporary one)")
+    parser.add_argument("--env-file", help="also write the exports to this file")
+    parser.add_argument("--windows", type=int, default=20, help="number of windows at startup")
+    parser.add_argument("--workspaces", type=int, default=5)
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="seconds between scripted changes (0 = no pause)")
+    parser.add_argument("--partial-writes", action="store_true",
+                        help="send every write in small chunks")
+    parser.add_argument("--huge-every", type=int, default=0,
+                        help="make every Nth change a huge title (0 = never)")
+    parser.add_argument("--huge-bytes", type=int, default=5 * 1024 * 1024)
+    parser.add_argument("--drop-after", type=int, default=0,
+                        help="close event streams after this many events (0 = never)")
+    parser.add_argument("--stamp", action="store_true",
+                        help="end titles of newly focused windows in @<monotonic ns>")
+    parser.add_argument("--seed", type=int, default=1)
+    options = parser.parse_args()
+
+    directory = options.dir or tempfile.mkdtemp(prefix="fake-compositor-")
+    os.makedirs(directory, exist_ok=True)
+    desktop = Desktop(options.windows, options.workspaces, random.Random(options.seed),
+                      options.stamp)
+    protocol = (Niri if options.protocol == "niri" else Hyprland)(desktop, directory)
+    server = Server(options, protocol, desktop)
+    # Listen before announcing, so whoever waits for the exports can connect right away.
+    protocol.bind()
+
+    exports = "\n".join(f"export {k}={v}" for k, v in protocol.environment().items())
+    if options.env_file:
+        with open(options.env_file, "w") as f:
+            f.write(exports + "\n")
+    print(exports, flush=True)
+    print(f"# fake {options.protocol} in {directory} ({options.windows} windows)", flush=True)
+
+    threading.Thread(target=server.script, daemon=True).start()
+    try:
+        protocol.serve(server)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        print(f"# {server.stats}", flush=True)
+        if not options.dir:
+            shutil.rmtree(directory, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+Stand-in for systemd-logind, so idle detection can be exercised without a real seat or session.
+
+Owns org.freedesktop.login1 on whatever bus DBUS_SYSTEM_BUS_ADDRESS (or --address) points at and
+implements what Concentrate uses:
+    Manager  GetSession(s) -> o, GetSessionByPID(u) -> o
+    Session  IdleHint, IdleSinceHint, IdleSinceHintMonotonic, LockedHint (PropertiesChanged)
+             SetIdleHint(b), SetLockedHint(b)
+
+The session goes idle/active on a script (--idle-after / --active-after, repeated with
+--cycles), or on commands typed on stdin: idle, active, lock, unlock.
+
+Usage (a private bus, so nothing touches the real system bus):
+    dbus-daemon --session --print-address --fork > /tmp/fake-system-bus
+    export DBUS_SYSTEM_BUS_ADDRESS=$(head -1 /tmp/fake-system-bus)
+    python3 resources/fake-logind.py --idle-after 10 --active-after 30
+    ./concentrate --idle-after 5
+"""
+
+import argparse
+import asyncio
+import os
+import sys
+import time
+
+from dbus_next import BusType
+from dbus_next.aio import MessageBus
+from dbus_next.service import PropertyAccess, ServiceInterface, dbus_property, method
+
+SESSION_ID = "fake1"
+SESSION_PATH = f"/org/freedesktop/login1/session/{SESSION_ID}"
+
+
+# ─────────────────────────────────────
+def now_usec():
+    return time.clock_gettime_ns(time.CLOCK_REALTIME) // 1000, \
+        time.clock_gettime_ns(time.CLOCK_MONOTONIC) // 1000
+
+
+# ─────────────────────────────────────
+class Manager(ServiceInterface):
+    def __init__(self):
+        super().__init__("org.freedesktop.login1.Manager")
+
+    @method()
+    def GetSession(self, session_id: "s") -> "o":
+        return SESSION_PATH
+
+    @method()
+    def GetSessionByPID(self, pid: "u") -> "o":
+        return SESSION_PATH
+
+
+# ─────────────────────────────────────
+class Session(ServiceInterface):
+    def __init__(self):
+        super().__init__("org.freedesktop.login1.Session")
+        self.idle = False
+        self.locked = False
+        self.idle_since, self.idle_since_monotonic = now_usec()
+
+    @dbus_property(access=PropertyAccess.READ)
+    def Id(self) -> "s":
+        return SESSION_ID
+
+    @dbus_property(access=PropertyAccess.READ)
+    def IdleHint(self) -> "b":
+        return self.idle
+
+    @dbus_property(access=PropertyAccess.READ)
+    def IdleSinceHint(self) -> "t":
+        return self.idle_since
+
+    @dbus_property(access=PropertyAccess.READ)
+    def IdleSinceHintMonotonic(self) -> "t":
+        return self.idle_since_monotonic
+
+    @dbus_property(access=PropertyAccess.READ)
+    def LockedHint(self) -> "b":
+        return self.locked
+
+    @method()
+    def SetIdleHint(self, idle: "b"):
+        self.set_idle(idle)
+
+    @method()
+    def SetLockedHint(self, locked: "b"):
+        self.set_locked(locked)
+
+    def set_idle(self, idle):
+        if idle == self.idle:
+            return
+        # Like logind: the timestamps mark the last change of the hint.
+        self.idle = idle
+        self.idle_since, self.idle_since_monotonic = now_usec()
+        self.emit_properties_changed({
+            "IdleHint": self.idle,
+            "IdleSinceHint": self.idle_since,
+            "IdleSinceHintMonotonic": self.idle_since_monotonic,
+        })
+        print(f"IdleHint={self.idle}", flush=True)
+
+    def set_locked(self, locked):
+        if locked == self.locked:
+            return
+        self.locked = locked
+        self.emit_properties_changed({"LockedHint": self.locked})
+        print(f"LockedHint={self.locked}", flush=True)
+
+
+# ─────────────────────────────────────
+async def run_script(session, options):
+    cycles = 0
+    while options.cycles == 0 or cycles < options.cycles:
+        await asyncio.sleep(options.idle_after)
+        session.set_idle(True)
+        await asyncio.sleep(options.active_after)
+        session.set_idle(False)
+        cycles += 1
+
+
+# ─────────────────────────────────────
+async def read_commands(session):
+    loop = asyncio.get_running_loop()
+    reader = asyncio.StreamReader()
+    await loop.connect_read_pipe(lambda: asyncio.StreamReaderProtocol(reader), sys.stdin)
+    actions = {
+        "idle": lambda: session.set_idle(True),
+        "active": lambda: session.set_idle(False),
+        "lock": lambda: session.set_locked(True),
+        "unlock": lambda: session.set_locked(False),
+    }
+    while line := await reader.readline():
+        action = actions.get(line.decode().strip())
+        if action:
+            action()
+        else:
+            print("commands: idle, active, lock, unlock", flush=True)
+
+
+# ─────────────────────────────────────
+async def main():
+    parser = argparse.ArgumentParser(description="Fake systemd-logind session")
+    parser.add_argument("--address", default=os.environ.get("DBUS_SYSTEM_BUS_ADDRESS"),
+                        help="bus to serve on (default: $DBUS_SYSTEM_BUS_ADDRESS)")
+    parser.add_argument("--idle-after", type=float, default=0.0,
+                        help="seconds of activity before the scripted idle hint (0 = no script)")
+    parser.add_argument("--active-after", type=float, default=30.0,
+                        help="seconds the scripted idle period lasts")
+    parser.add_argument("--cycles", type=int, default=0, help="scripted idle periods (0 = forever)")
+    options = parser.parse_args()
+
+    if not options.address:
+        sys.exit("No bus: set DBUS_SYSTEM_BUS_ADDRESS or pass --address "
+                 "(refusing to claim org.freedesktop.login1 on the real system bus)")
+
+    bus = await MessageBus(bus_address=options.address, bus_type=BusType.SYSTEM).connect()
+    session = Session()
+    bus.export("/org/freedesktop/login1", Manager())
+    bus.export(SESSION_PATH, session)
+    await bus.request_name("org.freedesktop.login1")
+    print(f"Fake logind on {options.address}, session {SESSION_PATH}", flush=True)
+
+    tasks = [asyncio.create_task(read_commands(session))]
+    if options.idle_after > 0:
+        tasks.append(asyncio.create_task(run_script(session, options)))
+    await bus.wait_for_disconnect()
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
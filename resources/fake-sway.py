@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""
+Stand-in for the Sway/i3 IPC socket, so the Sway backend can be exercised without running Sway.
+
+Speaks the i3 binary protocol ("i3-ipc" magic, native-endian u32 length and type, JSON payload)
+and implements the messages Concentrate uses:
+    0  RUN_COMMAND        accepted and ignored
+    1  GET_WORKSPACES
+    2  SUBSCRIBE          "window", "workspace" and "shutdown"
+    4  GET_TREE
+
+Subscribers get a scripted stream: every --interval seconds focus moves to another window
+(window "focus"), and with some probability a title changes, a window closes/opens or focus
+moves to an empty workspace (workspace "focus" with no focused window).
+
+Usage:
+    python3 resources/fake-sway.py --socket /tmp/fake-sway.sock --windows 200 --interval 0.5
+    SWAYSOCK=/tmp/fake-sway.sock ./concentrate
+
+The socket path is also printed on startup; --drop-after N closes every event stream after N
+events to exercise reconnects.
+"""
+
+import argparse
+import json
+import os
+import random
+import socket
+import struct
+import threading
+import time
+
+MAGIC = b"i3-ipc"
+HEADER = struct.Struct("=II")
+EVENT_FLAG = 0x80000000
+EVENT_TYPES = {"workspace": 0, "window": 3, "shutdown": 6}
+APPS = ["firefox", "kitty", "org.gnome.Nautilus", "neovim", "zotero", "Anytype"]
+
+
+# ─────────────────────────────────────
+def encode(message_type, payload):
+    body = json.dumps(payload).encode()
+    return MAGIC + HEADER.pack(len(body), message_type) + body
+
+
+# ─────────────────────────────────────
+def read_exact(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+
+# ─────────────────────────────────────
+class Desktop:
+    """Workspaces with tiled windows; exactly one window (or an empty workspace) has focus."""
+
+    def __init__(self, windows, workspaces, rng):
+        self.lock = threading.Lock()
+        self.rng = rng
+        self.next_id = 100
+        self.workspaces = {n: [] for n in range(1, workspaces + 1)}
+        self.focused_ws = 1
+        self.focused = None
+        for _ in range(windows):
+            self.open(self.rng.randint(1, workspaces))
+        if self.workspaces[1]:
+            self.focused = self.workspaces[1][0]["id"]
+
+    def open(self, ws):
+        window = {
+            "id": self.next_id,
+            "type": "con",
+            "app_id": self.rng.choice(APPS),
+            "name": f"Window {self.next_id}",
+            "nodes": [],
+            "floating_nodes": [],
+        }
+        self.next_id += 1
+        self.workspaces[ws].append(window)
+        return window
+
+    def find(self, window_id):
+        for ws, windows in self.workspaces.items():
+            for window in windows:
+                if window["id"] == window_id:
+                    return ws, window
+        return None, None
+
+    def container(self, window):
+        return dict(window, focused=window["id"] == self.focused)
+
+    def workspace_node(self, ws):
+        return {
+            "id": ws,
+            "type": "workspace",
+            "name": str(ws),
+            "focused": ws == self.focused_ws and self.focused is None,
+            "nodes": [self.container(w) for w in self.workspaces[ws]],
+            "floating_nodes": [],
+        }
+
+    def tree(self):
+        with self.lock:
+            output = {
+                "id": 2,
+                "type": "output",
+                "name": "FAKE-1",
+                "focused": False,
+                "nodes": [self.workspace_node(ws) for ws in self.workspaces],
+                "floating_nodes": [],
+            }
+            return {"id": 1, "type": "root", "name": "root", "focused": False,
+                    "nodes": [output], "floating_nodes": []}
+
+    def workspace_list(self):
+        with self.lock:
+            return [{"num": ws, "name": str(ws), "focused": ws == self.focused_ws,
+                     "visible": ws == self.focused_ws} for ws in self.workspaces]
+
+    def step(self):
+        """Applies one random change and returns the events it produces as (name, payload)."""
+        with self.lock:
+            roll = self.rng.random()
+            _, current = self.find(self.focused) if self.focused is not None else (None, None)
+
+            if roll < 0.15 and current is not None:
+                current["name"] = f"{current['name'].split(' — ')[0]} — {self.rng.randint(1, 999)}"
+                return [("window", {"change": "title", "container": self.container(current)})]
+
+            if roll < 0.22 and current is not None:
+                ws, _ = self.find(current["id"])
+                self.workspaces[ws].remove(current)
+                self.focused = None
+                events = [("window", {"change": "close",
+                                      "container": dict(current, focused=False)})]
+                if self.workspaces[ws]:
+                    self.focused = self.workspaces[ws][-1]["id"]
+                    events.append(("window", {"change": "focus",
+                                              "container": self.container(self.workspaces[ws][-1])}))
+                return events
+
+            if roll < 0.29:
+                window = self.open(self.focused_ws)
+                self.focused = window["id"]
+                return [("window", {"change": "new", "container": self.container(window)}),
+                        ("window", {"change": "focus", "container": self.container(window)})]
+
+            empty = [ws for ws, windows in self.workspaces.items() if not windows]
+            if roll < 0.34 and empty:
+                old = self.focused_ws
+                self.focused_ws = self.rng.choice(empty)
+                self.focused = None
+                return [("workspace", {"change": "focus",
+                                       "current": self.workspace_node(self.focused_ws),
+                                       "old": self.workspace_node(old)})]
+
+            candidates = [w for windows in self.workspaces.values() for w in windows]
+            if not candidates:
+                return []
+            window = self.rng.choice(candidates)
+            ws, _ = self.find(window["id"])
+            events = []
+            if ws != self.focused_ws:
+                old = self.focused_ws
+                self.focused_ws = ws
+                self.focused = window["id"]
+                events.append(("workspace", {"change": "focus",
+                                             "current": self.workspace_node(ws),
+                                             "old": self.workspace_node(old)}))
+            self.focused = window["id"]
+            events.append(("window", {"change": "focus", "container": self.container(window)}))
+            return events
+
+
+# ─────────────────────────────────────
+class Server:
+    def __init__(self, options):
+        self.options = options
+        self.desktop = Desktop(options.windows, options.workspaces, random.Random(options.seed))
+        self.subscribers = []  # (conn, set of event names, events sent)
+        self.sub_lock = threading.Lock()
+        self.stats = {"connections": 0, "requests": 0, "events": 0}
+
+    def handle(self, conn):
+        self.stats["connections"] += 1
+        try:
+            while True:
+                header = read_exact(conn, len(MAGIC) + HEADER.size)
+                if header is None or header[:len(MAGIC)] != MAGIC:
+                    return
+                length, message_type = HEADER.unpack(header[len(MAGIC):])
+                body = read_exact(conn, length) if length else b""
+                if body is None:
+                    return
+                self.stats["requests"] += 1
+                if self.options.verbose:
+                    print(f"request type={message_type} payload={body[:80]!r}")
+
+                if message_type == 4:
+                    conn.sendall(encode(4, self.desktop.tree()))
+                elif message_type == 1:
+                    conn.sendall(encode(1, self.desktop.workspace_list()))
+                elif message_type == 2:
+                    names = set(json.loads(body or b"[]"))
+                    ok = names <= set(EVENT_TYPES)
+                    conn.sendall(encode(2, {"success": ok}))
+                    if ok:
+                        with self.sub_lock:
+                            self.subscribers.append([conn, names, 0])
+                elif message_type == 0:
+                    conn.sendall(encode(0, [{"success": True}]))
+                else:
+                    conn.sendall(encode(message_type, {"success": False,
+                                                       "error": "unsupported in fake-sway"}))
+        except OSError:
+            pass
+        finally:
+            with self.sub_lock:
+                self.subscribers = [s for s in self.subscribers if s[0] is not conn]
+            conn.close()
+
+    def broadcast(self, events):
+        with self.sub_lock:
+            for subscriber in list(self.subscribers):
+                conn, names, _ = subscriber
+                try:
+                    for name, payload in events:
+                        if name in names:
+                            conn.sendall(encode(EVENT_FLAG | EVENT_TYPES[name], payload))
+                            subscriber[2] += 1
+                            self.stats["events"] += 1
+                    if self.options.drop_after and subscriber[2] >= self.options.drop_after:
+                        conn.shutdown(socket.SHUT_RDWR)
+                        self.subscribers.remove(subscriber)
+                except OSError:
+                    self.subscribers.remove(subscriber)
+
+    def script(self):
+        while True:
+            time.sleep(self.options.interval)
+            self.broadcast(self.desktop.step())
+
+
+# ─────────────────────────────────────
+def main():
+    parser = argparse.ArgumentParser(description="Fake Sway/i3 IPC socket")
+    parser.add_argument("--socket", default=os.path.join(
+        os.environ.get("XDG_RUNTIME_DIR", "/tmp"), "fake-sway.sock"))
+    parser.add_argument("--windows", type=int, default=20, help="number of windows at startup")
+    parser.add_argument("--workspaces", type=int, default=5)
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="seconds between scripted changes")
+    parser.add_argument("--drop-after", type=int, default=0,
+                        help="close event streams after this many events (0 = never)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    options = parser.parse_args()
+
+    if os.path.exists(options.socket):
+        os.unlink(options.socket)
+    listener = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    listener.bind(options.socket)
+    listener.listen(16)
+
+    server = Server(options)
+    threading.Thread(target=server.script, daemon=True).start()
+    print(f"Fake sway IPC on {options.socket} ({options.windows} windows, "
+          f"{options.workspaces} workspaces)", flush=True)
+    try:
+        while True:
+            conn, _ = listener.accept()
+            threading.Thread(target=server.handle, args=(conn,), daemon=True).start()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        os.unlink(options.socket)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,356 @@
+#!/usr/bin/env python3
+"""
+Stand-in for the Anytype desktop local API (http://localhost:31009), so the Anytype integration
+can be exercised and benchmarked without Anytype running.
+
+Implements the endpoints Concentrate uses:
+    GET  /                                        (connectivity probe)
+    POST /v1/auth/challenges
+    POST /v1/auth/api_keys
+    GET  /v1/spaces
+    POST /v1/spaces/{space}/search                (types, offset, limit, sort)
+    GET  /v1/spaces/{space}/objects/{id}
+    GET  /v1/spaces/{space}/properties/{id}/tags
+
+plus a few control endpoints for tests:
+    GET  /mock/stats                              request counts per endpoint
+    POST /mock/touch    {"count": n}              bump last_modified_date of n tasks
+    POST /mock/delete   {"count": n}              delete n tasks
+    POST /mock/reset                              clear the stats
+
+Usage:
+    python3 resources/mock-anytype.py --tasks 500 --latency-ms 20 --error-rate 0.05
+    CONCENTRATE_ANYTYPE_URL=http://127.0.0.1:31009 ./concentrate
+
+Any login code is accepted; the API key is "mock-api-key" and the space id "mock-space".
+"""
+
+import argparse
+import json
+import random
+import re
+import threading
+import time
+from datetime import datetime, timedelta, timezone
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+API_KEY = "mock-api-key"
+SPACE_ID = "mock-space"
+CATEGORY_PROPERTY_ID = "mock-prop-category"
+
+CATEGORIES = ["Work", "Study", "Writing", "Admin", "Music"]
+PRIORITIES = ["High", "Medium", "Low"]
+APPS = ["firefox", "org.gnome.Nautilus", "neovim", "kitty", "zotero", "anytype"]
+
+
+# ─────────────────────────────────────
+def iso(dt):
+    return dt.astimezone(timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+
+
+# ─────────────────────────────────────
+class Dataset:
+    def __init__(self, count, done_ratio, markdown_bytes, rng):
+        self.lock = threading.Lock()
+        self.rng = rng
+        self.markdown_bytes = markdown_bytes
+        self.tasks = {}
+        self.next_id = 0
+        base = datetime.now(timezone.utc) - timedelta(days=30)
+        for _ in range(count):
+            modified = base + timedelta(seconds=rng.randint(0, 30 * 24 * 3600))
+            self.add(done=rng.random() < done_ratio, modified=modified)
+
+    def add(self, done, modified):
+        task_id = f"mock-task-{self.next_id:05d}"
+        self.next_id += 1
+        rng = self.rng
+        self.tasks[task_id] = {
+            "id": task_id,
+            "name": f"Task {self.next_id}",
+            "done": done,
+            "category": rng.choice(CATEGORIES),
+            "priority": rng.choice(PRIORITIES),
+            "apps": rng.sample(APPS, rng.randint(0, 3)),
+            "titles": rng.sample(["README", "Inbox", "Draft", "Slides"], rng.randint(0, 2)),
+            "modified": modified,
+        }
+
+    def touch(self, count):
+        with self.lock:
+            ids = self.rng.sample(sorted(self.tasks), min(count, len(self.tasks)))
+            now = datetime.now(timezone.utc)
+            for task_id in ids:
+                self.tasks[task_id]["modified"] = now
+        return ids
+
+    def delete(self, count):
+        with self.lock:
+            ids = self.rng.sample(sorted(self.tasks), min(count, len(self.tasks)))
+            for task_id in ids:
+                del self.tasks[task_id]
+        return ids
+
+    def search(self, offset, limit, newest_first):
+        with self.lock:
+            tasks = list(self.tasks.values())
+        if newest_first:
+            tasks.sort(key=lambda t: (t["modified"], t["id"]), reverse=True)
+        else:
+            tasks.sort(key=lambda t: t["id"])
+        return len(tasks), [to_object(t) for t in tasks[offset : offset + limit]]
+
+    def get(self, task_id):
+        with self.lock:
+            task = self.tasks.get(task_id)
+            return dict(task) if task else None
+
+    def markdown(self, task):
+        line = f"- [ ] step for {task['name']}\n"
+        repeat = max(1, self.markdown_bytes // len(line))
+        return f"# {task['name']}\n\n" + line * repeat
+
+
+# ─────────────────────────────────────
+def to_object(task):
+    return {
+        "object": "object",
+        "id": task["id"],
+        "name": task["name"],
+        "space_id": SPACE_ID,
+        "type": {"key": "task", "name": "Task"},
+        "properties": [
+            {"key": "done", "format": "checkbox", "checkbox": task["done"]},
+            {
+                "key": "category",
+                "id": CATEGORY_PROPERTY_ID,
+                "format": "select",
+                "select": {"id": "tag-" + task["category"].lower(), "name": task["category"]},
+            },
+            {
+                "key": "priority",
+                "format": "select",
+                "select": {"id": "prio-" + task["priority"].lower(), "name": task["priority"]},
+            },
+            {
+                "key": "apps_allowed",
+                "format": "multi_select",
+                "multi_select": [{"name": a} for a in task["apps"]],
+            },
+            {
+                "key": "app_title",
+                "format": "multi_select",
+                "multi_select": [{"name": t} for t in task["titles"]],
+            },
+            {"key": "last_modified_date", "format": "date", "date": iso(task["modified"])},
+        ],
+    }
+
+
+# ─────────────────────────────────────
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive, like the real server
+
+    OBJECT_RE = re.compile(r"^/v1/spaces/([^/]+)/objects/([^/]+)$")
+    SEARCH_RE = re.compile(r"^/v1/spaces/([^/]+)/search$")
+    TAGS_RE = re.compile(r"^/v1/spaces/([^/]+)/properties/([^/]+)/tags$")
+
+    def log_message(self, fmt, *args):
+        if self.server.options.verbose:
+            super().log_message(fmt, *args)
+
+    # ─────────────────────────────────────
+    def send_json(self, status, payload):
+        body = json.dumps(payload).encode()
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def read_json(self):
+        length = int(self.headers.get("Content-Length") or 0)
+        if length == 0:
+            return {}
+        try:
+            return json.loads(self.rfile.read(length))
+        except json.JSONDecodeError:
+            return None
+
+    def count(self, endpoint):
+        with self.server.stats_lock:
+            self.server.stats[endpoint] = self.server.stats.get(endpoint, 0) + 1
+
+    # Latency and error injection for everything under /v1.
+    def simulate(self):
+        opts = self.server.options
+        delay = opts.latency_ms + random.uniform(0, opts.jitter_ms)
+        if delay > 0:
+            time.sleep(delay / 1000.0)
+        if opts.error_rate > 0 and random.random() < opts.error_rate:
+            self.count("injected_error")
+            self.send_json(500, {"object": "error", "code": "internal_server_error",
+                                 "message": "injected failure"})
+            return False
+        return True
+
+    def authorized(self):
+        if not self.server.options.require_auth:
+            return True
+        if self.headers.get("Authorization") == f"Bearer {API_KEY}":
+            return True
+        self.send_json(401, {"object": "error", "code": "unauthorized",
+                             "message": "missing or invalid API key"})
+        return False
+
+    # ─────────────────────────────────────
+    def do_GET(self):
+        path = self.path.split("?", 1)[0]
+        if path == "/":
+            self.send_json(200, {"status": "ok"})
+            return
+        if path == "/mock/stats":
+            with self.server.stats_lock:
+                self.send_json(200, dict(self.server.stats))
+            return
+        if not path.startswith("/v1/"):
+            self.send_json(404, {"error": "not found"})
+            return
+        if not self.simulate() or not self.authorized():
+            return
+
+        if path == "/v1/spaces":
+            self.count("spaces")
+            self.send_json(200, {
+                "data": [{"object": "space", "id": SPACE_ID, "name": "Mock space"}],
+                "pagination": {"total": 1, "offset": 0, "limit": 100, "has_more": False},
+            })
+            return
+
+        m = self.OBJECT_RE.match(path)
+        if m:
+            self.count("object")
+            task = self.server.dataset.get(m.group(2))
+            if m.group(1) != SPACE_ID or task is None:
+                self.send_json(404, {"object": "error", "code": "object_not_found"})
+                return
+            obj = to_object(task)
+            obj["markdown"] = self.server.dataset.markdown(task)
+            self.send_json(200, {"object": obj})
+            return
+
+        m = self.TAGS_RE.match(path)
+        if m:
+            self.count("tags")
+            tags = [{"object": "tag", "id": "tag-" + c.lower(), "name": c} for c in CATEGORIES]
+            self.send_json(200, {
+                "data": tags,
+                "pagination": {"total": len(tags), "offset": 0, "limit": 100, "has_more": False},
+            })
+            return
+
+        self.send_json(404, {"error": "not found"})
+
+    # ─────────────────────────────────────
+    def do_POST(self):
+        path = self.path.split("?", 1)[0]
+        body = self.read_json()
+        if body is None:
+            self.send_json(400, {"error": "invalid JSON"})
+            return
+
+        if path.startswith("/mock/"):
+            self.handle_control(path, body)
+            return
+        if not self.simulate():
+            return
+
+        if path == "/v1/auth/challenges":
+            self.count("auth_challenges")
+            self.send_json(201, {"challenge_id": "mock-challenge"})
+            return
+        if path == "/v1/auth/api_keys":
+            self.count("auth_api_keys")
+            self.send_json(201, {"api_key": API_KEY})
+            return
+
+        if not self.authorized():
+            return
+
+        m = self.SEARCH_RE.match(path)
+        if m:
+            self.count("search")
+            if m.group(1) != SPACE_ID:
+                self.send_json(404, {"object": "error", "code": "space_not_found"})
+                return
+            offset = max(0, int(body.get("offset", 0)))
+            limit = max(1, min(1000, int(body.get("limit", 100))))
+            sort = body.get("sort") or {}
+            newest_first = (sort.get("property_key") == "last_modified_date"
+                            and sort.get("direction", "asc") == "desc")
+            total, objects = self.server.dataset.search(offset, limit, newest_first)
+            self.send_json(200, {
+                "data": objects,
+                "pagination": {"total": total, "offset": offset, "limit": limit,
+                               "has_more": offset + len(objects) < total},
+            })
+            return
+
+        self.send_json(404, {"error": "not found"})
+
+    # ─────────────────────────────────────
+    def handle_control(self, path, body):
+        dataset = self.server.dataset
+        if path == "/mock/touch":
+            self.send_json(200, {"touched": dataset.touch(int(body.get("count", 1)))})
+        elif path == "/mock/delete":
+            self.send_json(200, {"deleted": dataset.delete(int(body.get("count", 1)))})
+        elif path == "/mock/reset":
+            with self.server.stats_lock:
+                self.server.stats.clear()
+            self.send_json(200, {"status": "ok"})
+        else:
+            self.send_json(404, {"error": "not found"})
+
+
+# ─────────────────────────────────────
+def main():
+    parser = argparse.ArgumentParser(description="Mock Anytype local API server")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=31009)
+    parser.add_argument("--tasks", type=int, default=200, help="number of tasks in the space")
+    parser.add_argument("--done-ratio", type=float, default=0.3,
+                        help="fraction of tasks that are already done")
+    parser.add_argument("--markdown-bytes", type=int, default=2048,
+                        help="approximate size of each task's markdown body")
+    parser.add_argument("--latency-ms", type=float, default=0.0,
+                        help="fixed delay added to every /v1 request")
+    parser.add_argument("--jitter-ms", type=float, default=0.0,
+                        help="random extra delay, uniform in [0, jitter]")
+    parser.add_argument("--error-rate", type=float, default=0.0,
+                        help="probability of answering a /v1 request with HTTP 500")
+    parser.add_argument("--require-auth", action="store_true",
+                        help=f"reject requests without 'Bearer {API_KEY}'")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    options = parser.parse_args()
+
+    random.seed(options.seed)
+    server = ThreadingHTTPServer((options.host, options.port), Handler)
+    server.daemon_threads = True
+    server.options = options
+    server.dataset = Dataset(options.tasks, options.done_ratio, options.markdown_bytes,
+                             random.Random(options.seed))
+    server.stats = {}
+    server.stats_lock = threading.Lock()
+
+    print(f"Mock Anytype API on http://{options.host}:{options.port} "
+          f"({options.tasks} tasks, space '{SPACE_ID}')")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
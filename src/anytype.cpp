@@ -1,61 +1,251 @@
 #include "anytype.hpp"
-
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
+static constexpr const char *kDefaultBaseUrl = "http://localhost:31009";
+static constexpr const char *kApiVersion = "2025-11-08";
+static constexpr std::size_t kMaxIdleClients = 4;
+// Startup probing: every 2 s, for as long as the old blocking wait lasted.
+static constexpr int kConnectAttempts = 15;
+static constexpr std::chrono::seconds kConnectInterval{2};
+static constexpr std::chrono::seconds kDegradedInterval{10};
+static constexpr std::chrono::seconds kReadyInterval{30};
+
 // ─────────────────────────────────────
 Anytype::Anytype() {
     m_Secrets = Secrets();
+}
+
+// ─────────────────────────────────────
+Anytype::~Anytype() {
+    Stop();
+}
+
+// ─────────────────────────────────────
+void Anytype::Start(StateCallback onChange) {
+    if (m_ProbeThread.joinable()) {
+        return;
+    }
+    m_OnStateChange = std::move(onChange);
+    m_ProbeThread = std::thread([this] { RunProbe(); });
+}
+
+// ─────────────────────────────────────
+void Anytype::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_ProbeMutex);
+        m_StopProbe = true;
+    }
+    m_ProbeCv.notify_all();
+    if (m_ProbeThread.joinable()) {
+        m_ProbeThread.join();
+    }
+}
 
-    const char *BASE_URL = "http://localhost:31009";
-    const char *API_VERSION = "2025-11-08";
-    httplib::Client client(BASE_URL);
-    client.set_default_headers({
-        {"Anytype-Version", API_VERSION},
+// ─────────────────────────────────────
+Anytype::State Anytype::GetState() const {
+    return m_State.load(std::memory_order_acquire);
+}
+
+// ─────────────────────────────────────
+const char *Anytype::StateName(State state) {
+    switch (state) {
+    case State::Connecting:
+        return "connecting";
+    case State::Ready:
+        return "ready";
+    case State::Degraded:
+        return "degraded";
+    }
+    return "unknown";
+}
+
+// ─────────────────────────────────────
+bool Anytype::Probe() const {
+    // A dedicated short-lived client: a failed probe must not go through Send(), which would
+    // just schedule another probe.
+    auto client = MakeClient();
+    client->set_keep_alive(false);
+    client->set_read_timeout(3, 0);
+    return static_cast<bool>(client->Get("/"));
+}
+
+// ─────────────────────────────────────
+void Anytype::RequestProbe() {
+    {
+        std::lock_guard<std::mutex> lock(m_ProbeMutex);
+        m_ProbeWanted = true;
+    }
+    m_ProbeCv.notify_one();
+}
+
+// ─────────────────────────────────────
+void Anytype::RunProbe() {
+    int failures = 0;
+    State reported = State::Connecting;
+
+    std::unique_lock<std::mutex> lock(m_ProbeMutex);
+    while (!m_StopProbe) {
+        m_ProbeWanted = false;
+        lock.unlock();
+
+        const bool ok = Probe();
+        failures = ok ? 0 : failures + 1;
+
+        State next = State::Ready;
+        if (!ok) {
+            next = reported == State::Connecting && failures < kConnectAttempts
+                       ? State::Connecting
+                       : State::Degraded;
+        }
+        m_State.store(next, std::memory_order_release);
+
+        if (next != reported) {
+            reported = next;
+            if (next == State::Ready) {
+                spdlog::info("Anytype: API reachable at {}", BaseUrl());
+            } else {
+                spdlog::warn("Anytype: API at {} unreachable; Anytype features are degraded",
+                             BaseUrl());
+            }
+            Metrics::Instance()
+                .GetCounter("concentrate_anytype_state_changes_total",
+                            "Transitions of the Anytype connectivity state.",
+                            Metrics::Labels({{"state", StateName(next)}}))
+                .Inc();
+            if (m_OnStateChange) {
+                m_OnStateChange(next);
+            }
+        } else if (next == State::Connecting) {
+            spdlog::debug("Anytype: waiting for the API (attempt {})", failures);
+        }
+
+        const auto interval = next == State::Ready        ? kReadyInterval
+                              : next == State::Connecting ? kConnectInterval
+                                                          : kDegradedInterval;
+        lock.lock();
+        m_ProbeCv.wait_for(lock, interval, [&] { return m_StopProbe || m_ProbeWanted; });
+    }
+}
+
+// ─────────────────────────────────────
+std::string Anytype::BaseUrl() {
+    // Lets resources/ tooling point Concentrate at a stand-in server.
+    const char *env = std::getenv("CONCENTRATE_ANYTYPE_URL");
+    return env && *env ? env : kDefaultBaseUrl;
+}
+
+// ─────────────────────────────────────
+std::unique_ptr<httplib::Client> Anytype::MakeClient() const {
+    auto client = std::make_unique<httplib::Client>(BaseUrl());
+    client->set_default_headers({
+        {"Anytype-Version", kApiVersion},
         {"Content-Type", "application/json"},
     });
+    client->set_keep_alive(true);
+    client->set_connection_timeout(3, 0);
+    client->set_read_timeout(30, 0);
+    client->set_write_timeout(30, 0);
+    return client;
+}
 
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
-
-    int Attemps = 0;
-    while (true) {
-        Attemps++;
-        if (auto res = client.Get("/")) {
-            spdlog::info("Serving on: http://localhost:31009");
-            break;
-        } else {
-            spdlog::warn("Waiting for Anytype Server...");
+// ─────────────────────────────────────
+std::unique_ptr<httplib::Client> Anytype::AcquireClient() {
+    {
+        std::lock_guard<std::mutex> lock(m_ClientsMutex);
+        if (!m_IdleClients.empty()) {
+            auto client = std::move(m_IdleClients.back());
+            m_IdleClients.pop_back();
+            return client;
         }
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-        if (Attemps > 15) {
-            spdlog::error("Waited too long for the Anytype Server. Exiting...");
-            exit(1);
+    }
+    return MakeClient();
+}
+
+// ─────────────────────────────────────
+void Anytype::ReleaseClient(std::unique_ptr<httplib::Client> client) {
+    std::lock_guard<std::mutex> lock(m_ClientsMutex);
+    if (m_IdleClients.size() < kMaxIdleClients) {
+        m_IdleClients.push_back(std::move(client));
+    }
+}
+
+// ─────────────────────────────────────
+static Metrics::Histogram &RequestTiming(std::string_view endpoint) {
+    static constexpr std::string_view kHelp = "Round trip of requests to the Anytype local API.";
+    static constexpr std::string_view kName = "concentrate_anytype_request_duration_seconds";
+    // The endpoint set is fixed, so resolve every handle once instead of per request.
+    static const auto timings = [] {
+        std::unordered_map<std::string_view, Metrics::Histogram *> map;
+        for (std::string_view name : {"auth_challenges", "auth_api_keys", "spaces", "object",
+                                      "search", "property_tags"}) {
+            map.emplace(name, &Metrics::Instance().GetHistogram(
+                                  kName, kHelp, Metrics::Labels({{"endpoint", name}})));
         }
+        return map;
+    }();
+    if (auto it = timings.find(endpoint); it != timings.end()) {
+        return *it->second;
     }
+    return Metrics::Instance().GetHistogram(kName, kHelp,
+                                            Metrics::Labels({{"endpoint", endpoint}}));
 }
 
 // ─────────────────────────────────────
-Anytype::~Anytype() {}
+httplib::Result Anytype::Send(std::string_view endpoint,
+                              const std::function<httplib::Result(httplib::Client &)> &call,
+                              bool idempotent) {
+    Metrics::ScopedTimer timer(RequestTiming(endpoint));
+
+    auto client = AcquireClient();
+    auto res = call(*client);
+    if (!res && idempotent) {
+        // The pooled connection may have been closed by the server; try once on a new one.
+        client = MakeClient();
+        res = call(*client);
+    }
+
+    if (res) {
+        ReleaseClient(std::move(client));
+    } else if (GetState() == State::Ready) {
+        // Let the probe confirm the outage and move the state machine along.
+        RequestProbe();
+    }
+    return res;
+}
+
+// ─────────────────────────────────────
+httplib::Headers Anytype::AuthHeaders() {
+    std::lock_guard<std::mutex> lock(m_AuthMutex);
+    if (m_AuthKey.empty()) {
+        m_AuthKey = m_Secrets.LoadSecret("api_key");
+        if (m_AuthKey.empty()) {
+            return {};
+        }
+        m_AuthHeaders = {{"Authorization", "Bearer " + m_AuthKey}};
+    }
+    return m_AuthHeaders;
+}
 
 // ─────────────────────────────────────
 std::string Anytype::LoginChallengeId() {
-    const char *BASE_URL = "http://localhost:31009";
-    const char *API_VERSION = "2025-11-08";
     const char *APP_NAME = "Concentrate";
 
-    httplib::Client client(BASE_URL);
-    client.set_default_headers({
-        {"Anytype-Version", API_VERSION},
-        {"Content-Type", "application/json"},
-    });
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
-
     nlohmann::json body = {{"app_name", APP_NAME}};
     spdlog::info("Anytype: Requesting login challenge for app '{}'", APP_NAME);
-    auto res = client.Post("/v1/auth/challenges", body.dump(), "application/json");
+    auto res = Send(
+        "auth_challenges",
+        [&](httplib::Client &client) {
+            return client.Post("/v1/auth/challenges", body.dump(), "application/json");
+        },
+        false);
 
     if (!res) {
         spdlog::error("Anytype: Failed to connect to server for login challenge");
@@ -76,21 +266,14 @@ std::string Anytype::LoginChallengeId() {
 
 // ─────────────────────────────────────
 std::string Anytype::CreateApiKey(const std::string &challenge_id, const std::string &code) {
-    const char *BASE_URL = "http://localhost:31009";
-    const char *API_VERSION = "2025-11-08";
-
-    httplib::Client client(BASE_URL);
-    client.set_default_headers({
-        {"Anytype-Version", API_VERSION},
-        {"Content-Type", "application/json"},
-    });
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
-
     nlohmann::json body = {{"challenge_id", challenge_id}, {"code", code}};
     spdlog::info("Anytype: Creating API key for challenge ID: {}", challenge_id);
-    auto res = client.Post("/v1/auth/api_keys", body.dump(), "application/json");
+    auto res = Send(
+        "auth_api_keys",
+        [&](httplib::Client &client) {
+            return client.Post("/v1/auth/api_keys", body.dump(), "application/json");
+        },
+        false);
 
     if (!res) {
         spdlog::error("Anytype: Failed to connect to server for API key creation");
@@ -106,29 +289,22 @@ std::string Anytype::CreateApiKey(const std::string &challenge_id, const std::st
     auto j = nlohmann::json::parse(res->body);
     std::string api_key = j.at("api_key").get<std::string>();
     m_Secrets.SaveSecret("api_key", api_key);
+    {
+        std::lock_guard<std::mutex> lock(m_AuthMutex);
+        m_AuthKey = api_key;
+        m_AuthHeaders = {{"Authorization", "Bearer " + api_key}};
+    }
     spdlog::info("Anytype: API key created and saved successfully");
     return api_key;
 }
 
 // ─────────────────────────────────────
 nlohmann::json Anytype::GetSpaces() {
-    const char *BASE_URL = "http://localhost:31009";
-    const char *API_VERSION = "2025-11-08";
-    std::string api_key = m_Secrets.LoadSecret("api_key");
-    std::string space_id = m_Secrets.LoadSecret("space_id");
-
-    httplib::Client client(BASE_URL);
-    client.set_default_headers({
-        {"Anytype-Version", API_VERSION},
-        {"Authorization", "Bearer " + api_key},
-        {"Content-Type", "application/json"},
-    });
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
+    const httplib::Headers headers = AuthHeaders();
 
     spdlog::info("Anytype: Fetching available spaces");
-    auto res = client.Get("/v1/spaces");
+    auto res = Send("spaces",
+                    [&](httplib::Client &client) { return client.Get("/v1/spaces", headers); });
 
     if (!res) {
         spdlog::error("Anytype: Failed to connect to server for spaces");
@@ -152,14 +328,11 @@ void Anytype::SetDefaultSpace(std::string space_id) {
 
 // ─────────────────────────────────────
 nlohmann::json Anytype::GetPage(const std::string &id) {
-    const std::string base = "http://localhost:31009";
-    const std::string api_version = "2025-11-08";
-
     // Load secrets
-    std::string api_key = m_Secrets.LoadSecret("api_key");
+    const httplib::Headers headers = AuthHeaders();
     std::string space_id = m_Secrets.LoadSecret("default_space_id");
 
-    if (api_key.empty() || space_id.empty()) {
+    if (headers.empty() || space_id.empty()) {
         spdlog::error("Anytype: API key or default space ID is missing");
         return nlohmann::json::object();
     }
@@ -167,18 +340,9 @@ nlohmann::json Anytype::GetPage(const std::string &id) {
     // Build URL
     std::string url = "/v1/spaces/" + space_id + "/objects/" + id;
 
-    httplib::Client client(base);
-    client.set_default_headers({
-        {"Authorization", "Bearer " + api_key},
-        {"Anytype-Version", api_version},
-        {"Content-Type", "application/json"},
-    });
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
-
     spdlog::debug("Anytype: Fetching page with ID: {}", id);
-    if (auto res = client.Get(url.c_str())) {
+    if (auto res = Send("object",
+                        [&](httplib::Client &client) { return client.Get(url, headers); })) {
         if (res->status == 200) {
             try {
                 nlohmann::json page_json = nlohmann::json::parse(res->body);
@@ -201,100 +365,299 @@ nlohmann::json Anytype::GetPage(const std::string &id) {
 }
 
 // ─────────────────────────────────────
-nlohmann::json Anytype::GetTasks() {
-    const std::string base = "http://localhost:31009";
-    const std::string api_version = "2025-11-08";
-    const int limit = 50;
+std::optional<nlohmann::json> Anytype::FetchTaskPage(const std::string &space_id,
+                                                     const httplib::Headers &headers, int offset,
+                                                     int limit, int &total, bool newestFirst) {
+    nlohmann::json body = nlohmann::json::object();
+    body["types"] = nlohmann::json::array({"task"});
+    body["offset"] = offset;
+    body["limit"] = limit;
+    if (newestFirst) {
+        body["sort"] = {{"property_key", "last_modified_date"}, {"direction", "desc"}};
+    }
+
+    const std::string path = "/v1/spaces/" + space_id + "/search";
+    spdlog::debug("Anytype: Fetching tasks batch with offset: {}, limit: {}", offset, limit);
+    auto res = Send("search", [&](httplib::Client &client) {
+        return client.Post(path, headers, body.dump(), "application/json");
+    });
+    if (!res) {
+        spdlog::error("Anytype: Connection failed during task retrieval");
+        return std::nullopt;
+    }
+    if (res->status < 200 || res->status >= 300) {
+        spdlog::error("Anytype: Task retrieval failed with HTTP {}: {}", res->status, res->body);
+        return std::nullopt;
+    }
 
-    std::string api_key = m_Secrets.LoadSecret("api_key");
-    std::string space_id = m_Secrets.LoadSecret("default_space_id");
+    try {
+        nlohmann::json payload = nlohmann::json::parse(res->body);
+        total = GetExtractLength(payload);
+        return GetAnytypeObjects(payload);
+    } catch (const nlohmann::json::parse_error &e) {
+        spdlog::error("Anytype: Invalid task search response at offset {}: {}", offset, e.what());
+        return std::nullopt;
+    }
+}
 
-    if (api_key.empty() || space_id.empty()) {
-        throw std::runtime_error("Missing Anytype API key or space ID");
+// ─────────────────────────────────────
+nlohmann::json Anytype::ProcessTaskPage(const nlohmann::json &objects, int offset) {
+    nlohmann::json tasks = nlohmann::json::array();
+    if (!objects.is_array()) {
+        return tasks;
     }
 
-    httplib::Client client(base);
-    client.set_default_headers({
-        {"Authorization", "Bearer " + api_key},
-        {"Anytype-Version", api_version},
-        {"Content-Type", "application/json"},
-    });
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
+    int idx = 0;
+    for (const auto &obj : objects) {
+        nlohmann::json task = NormalizeTask(obj, offset + idx);
+        idx += 1;
 
-    spdlog::info("Anytype: Starting task retrieval from space: {}", space_id);
-    nlohmann::json tasks = nlohmann::json::array();
-    std::unordered_set<std::string> seen_task_ids;
-    int offset = 0;
+        const std::string task_id = task["id"].get<std::string>();
+        spdlog::debug("Anytype: Processing task ID: {}", task_id);
+
+        bool done = task.contains("done") && task["done"].is_boolean() ? task["done"].get<bool>()
+                                                                        : false;
+        if (done) {
+            continue;
+        }
+
+        tasks.push_back(std::move(task));
+    }
+    return tasks;
+}
+
+// ─────────────────────────────────────
+std::string Anytype::SpaceId() {
+    return m_Secrets.LoadSecret("default_space_id");
+}
+
+// ─────────────────────────────────────
+nlohmann::json Anytype::GetTasks(const std::string &space_id) {
+    const int limit = 50;
     constexpr int kMaxTasks = 2000;
-    while (true) {
-        nlohmann::json body = nlohmann::json::object();
-        body["types"] = nlohmann::json::array({"task"});
-        body["offset"] = offset;
-        body["limit"] = limit;
-
-        std::string path = "/v1/spaces/" + space_id + "/search";
-        spdlog::debug("Anytype: Fetching tasks batch with offset: {}, limit: {}", offset, limit);
-        auto res = client.Post(path.c_str(), body.dump(), "application/json");
-        if (!res) {
-            spdlog::error("Anytype: Connection failed during task retrieval");
-            return tasks;
+    // Matches the connection pool size, so every worker reuses a warm connection.
+    constexpr std::size_t kMaxWorkers = 4;
+
+    const httplib::Headers headers = AuthHeaders();
+    if (headers.empty() || space_id.empty()) {
+        throw std::runtime_error("Missing Anytype API key or space ID");
+    }
+
+    spdlog::info("Anytype: Starting task retrieval from space: {}", space_id);
+
+    // The first page tells how many tasks there are; the rest can then be fetched (and
+    // normalized) concurrently and merged back in offset order. Task bodies (markdown) are not
+    // part of the list: only the current task's is needed, and its resolution fetches it.
+    int total = -1;
+    // A failed page aborts the whole fetch: callers treat the result as the complete task list.
+    std::optional<nlohmann::json> first = FetchTaskPage(space_id, headers, 0, limit, total);
+    if (!first) {
+        throw std::runtime_error("Anytype task search failed");
+    }
+
+    // Walks the pages one by one; also the fallback when a concurrent fetch fails.
+    std::vector<nlohmann::json> pages;
+    auto fetchSequential = [&] {
+        pages.clear();
+        pages.push_back(ProcessTaskPage(*first, 0));
+        for (int offset = limit; offset < kMaxTasks; offset += limit) {
+            int ignored = -1;
+            auto objects = FetchTaskPage(space_id, headers, offset, limit, ignored);
+            if (!objects) {
+                throw std::runtime_error("Anytype task search failed");
+            }
+            const bool full = objects->is_array() && objects->size() >= static_cast<size_t>(limit);
+            pages.push_back(ProcessTaskPage(*objects, offset));
+            if (!full) {
+                break;
+            }
         }
-        if (res->status < 200 || res->status >= 300) {
-            spdlog::error("Anytype: Task retrieval failed with HTTP {}: {}", res->status,
-                          res->body);
-            return tasks;
+    };
+
+    const bool firstPageFull = first->is_array() && first->size() >= static_cast<size_t>(limit);
+    if (firstPageFull && total >= 0) {
+        std::vector<int> offsets;
+        for (int offset = limit; offset < std::min(total, kMaxTasks); offset += limit) {
+            offsets.push_back(offset);
         }
+        pages.resize(offsets.size() + 1);
 
-        nlohmann::json payload = nlohmann::json::parse(res->body);
-        nlohmann::json objects = GetAnytypeObjects(payload);
-        int total = GetExtractLength(payload);
-        if (objects.is_array()) {
-            int idx = 0;
-            for (const auto &obj : objects) {
-                nlohmann::json task = NormalizeTask(obj, offset + idx);
-                spdlog::debug("Anytype: Processing task ID: {}", task["id"].get<std::string>());
-
-                const std::string task_id = task["id"].get<std::string>();
-                if (seen_task_ids.find(task_id) != seen_task_ids.end()) {
-                    spdlog::debug("Anytype: Skipping duplicate task ID: {}", task_id);
-                    idx += 1;
-                    continue;
+        std::atomic<std::size_t> next{0};
+        std::atomic<bool> failed{false};
+        auto worker = [&] {
+            try {
+                for (std::size_t i = next++; i < offsets.size() && !failed; i = next++) {
+                    int ignored = -1;
+                    auto objects = FetchTaskPage(space_id, headers, offsets[i], limit, ignored);
+                    if (!objects) {
+                        failed = true;
+                        break;
+                    }
+                    pages[i + 1] = ProcessTaskPage(*objects, offsets[i]);
                 }
+            } catch (const std::exception &e) {
+                spdlog::error("Anytype: Task page worker failed: {}", e.what());
+                failed = true;
+            }
+        };
+
+        {
+            // jthreads join on scope exit, so no worker outlives `pages` or the locals it uses.
+            std::vector<std::jthread> workers;
+            const std::size_t count = std::min(kMaxWorkers, offsets.size());
+            for (std::size_t w = 1; w < count; ++w) {
+                workers.emplace_back(worker);
+            }
+            try {
+                pages[0] = ProcessTaskPage(*first, 0);
+            } catch (const std::exception &e) {
+                spdlog::error("Anytype: Failed to process the first task page: {}", e.what());
+                failed = true;
+            }
+            worker();
+        }
+        if (failed) {
+            spdlog::warn("Anytype: Concurrent task fetch failed, retrying page by page");
+            fetchSequential();
+        }
+    } else if (firstPageFull) {
+        // No total in the response.
+        fetchSequential();
+    } else {
+        pages.push_back(ProcessTaskPage(*first, 0));
+    }
 
-                bool done = task.contains("done") && task["done"].is_boolean()
-                                ? task["done"].get<bool>()
-                                : false;
-                if (!done) {
-                    // get markdown
-                    nlohmann::json page = GetPage(task_id);
-                    task["markdown"] = page["object"]["markdown"].get<std::string>();
-                    tasks.push_back(task);
-                    seen_task_ids.insert(task_id);
-                }
-                idx += 1;
+    nlohmann::json tasks = nlohmann::json::array();
+    std::unordered_set<std::string> seen_task_ids;
+    for (auto &page : pages) {
+        for (auto &task : page) {
+            const std::string task_id = task["id"].get<std::string>();
+            if (!seen_task_ids.insert(task_id).second) {
+                spdlog::debug("Anytype: Skipping duplicate task ID: {}", task_id);
+                continue;
             }
+            tasks.push_back(std::move(task));
         }
+    }
 
-        if (tasks.size() >= static_cast<size_t>(kMaxTasks)) {
-            spdlog::warn("Anytype: Reached maximum task limit of {}", kMaxTasks);
-            break;
+    if (tasks.size() >= static_cast<size_t>(kMaxTasks)) {
+        spdlog::warn("Anytype: Reached maximum task limit of {}", kMaxTasks);
+    }
+
+    spdlog::info("Anytype: Completed task retrieval, found {} active tasks", tasks.size());
+    return tasks;
+}
+
+// ─────────────────────────────────────
+nlohmann::json Anytype::GetTasksModifiedSince(const std::string &space_id, std::int64_t since,
+                                              std::int64_t &newest) {
+    const int limit = 50;
+    constexpr int kMaxTasks = 2000;
+
+    const httplib::Headers headers = AuthHeaders();
+    if (headers.empty() || space_id.empty()) {
+        throw std::runtime_error("Missing Anytype API key or space ID");
+    }
+
+    newest = since;
+
+    // Pages come newest first, so the walk stops at the first task older than the watermark,
+    // usually within the first search request. Tasks from the watermark's own second are
+    // fetched again (another edit may have landed in it) and simply upserted over their rows.
+    // A task without a usable timestamp cannot be placed after the watermark, so it stops the
+    // walk as well; full sweeps still pick it up.
+    nlohmann::json tasks = nlohmann::json::array();
+    for (int offset = 0; offset < kMaxTasks; offset += limit) {
+        int ignored = -1;
+        auto objects = FetchTaskPage(space_id, headers, offset, limit, ignored, true);
+        if (!objects) {
+            throw std::runtime_error("Anytype task search failed");
         }
 
-        if (!objects.is_array() || objects.size() < static_cast<size_t>(limit)) {
-            break;
+        int idx = 0;
+        for (const auto &obj : *objects) {
+            nlohmann::json task = NormalizeTask(obj, offset + idx);
+            idx += 1;
+
+            const nlohmann::json &modifiedAt = task["modified_at"];
+            if (!modifiedAt.is_number_integer() || modifiedAt.get<std::int64_t>() < since) {
+                spdlog::debug("Anytype: {} changed tasks since {}", tasks.size(), since);
+                return tasks;
+            }
+            newest = std::max(newest, modifiedAt.get<std::int64_t>());
+            tasks.push_back(std::move(task));
         }
-        if (total >= 0 && offset + limit >= total) {
+
+        if (!objects->is_array() || objects->size() < static_cast<size_t>(limit)) {
             break;
         }
-        offset += limit;
     }
 
-    spdlog::info("Anytype: Completed task retrieval, found {} active tasks", tasks.size());
+    spdlog::debug("Anytype: {} changed tasks since {}", tasks.size(), since);
     return tasks;
 }
 
+// ─────────────────────────────────────
+std::optional<std::int64_t> Anytype::ParseTimestamp(std::string_view text) {
+    // YYYY-MM-DDTHH:MM:SS[.fraction][Z|±HH:MM]
+    const auto digits = [&](std::size_t pos, std::size_t count) -> std::optional<int> {
+        if (pos + count > text.size()) {
+            return std::nullopt;
+        }
+        int value = 0;
+        for (std::size_t i = pos; i < pos + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') {
+                return std::nullopt;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return value;
+    };
+    const auto at = [&](std::size_t pos, char c) { return pos < text.size() && text[pos] == c; };
+
+    const auto year = digits(0, 4);
+    const auto month = digits(5, 2);
+    const auto day = digits(8, 2);
+    const auto hour = digits(11, 2);
+    const auto minute = digits(14, 2);
+    const auto second = digits(17, 2);
+    if (!year || !month || !day || !hour || !minute || !second || !at(4, '-') || !at(7, '-') ||
+        !(at(10, 'T') || at(10, ' ')) || !at(13, ':') || !at(16, ':') || *month < 1 ||
+        *month > 12 || *day < 1 || *day > 31 || *hour > 23 || *minute > 59 || *second > 60) {
+        return std::nullopt;
+    }
+
+    std::size_t pos = 19;
+    if (at(pos, '.')) {
+        ++pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+            ++pos;
+        }
+    }
+    std::int64_t offset = 0;
+    if (at(pos, 'Z')) {
+        ++pos;
+    } else if (at(pos, '+') || at(pos, '-')) {
+        const auto offHour = digits(pos + 1, 2);
+        const auto offMinute = digits(pos + 4, 2);
+        if (!offHour || !offMinute || !at(pos + 3, ':')) {
+            return std::nullopt;
+        }
+        offset = (*offHour * 60 + *offMinute) * 60 * (text[pos] == '-' ? -1 : 1);
+        pos += 6;
+    }
+    if (pos != text.size()) {
+        return std::nullopt;
+    }
+
+    const std::chrono::sys_days date =
+        std::chrono::year{*year} / std::chrono::month{static_cast<unsigned>(*month)} /
+        std::chrono::day{static_cast<unsigned>(*day)};
+    const std::int64_t seconds = date.time_since_epoch().count() * 86400LL + *hour * 3600LL +
+                                 *minute * 60LL + *second;
+    return seconds - offset;
+}
+
 // ─────────────────────────────────────
 nlohmann::json Anytype::GetAnytypeObjects(const nlohmann::json &payload) {
     if (payload.contains("data") && payload["data"].is_object()) {
@@ -346,15 +709,12 @@ int Anytype::GetExtractLength(const nlohmann::json &payload) {
 
 // ─────────────────────────────────────
 nlohmann::json Anytype::GetCategoriesOfTasks() {
-    const std::string base = "http://localhost:31009";
-    const std::string api_version = "2025-11-08";
-
     // Load secrets
-    std::string api_key = m_Secrets.LoadSecret("api_key");
+    const httplib::Headers headers = AuthHeaders();
     std::string space_id = m_Secrets.LoadSecret("default_space_id");
     std::string prop_id = m_Secrets.LoadSecret("task_categories_id");
 
-    if (api_key.empty() || space_id.empty()) {
+    if (headers.empty() || space_id.empty()) {
         spdlog::error("Anytype: API key or default space ID is missing");
         return nlohmann::json::object();
     }
@@ -362,18 +722,8 @@ nlohmann::json Anytype::GetCategoriesOfTasks() {
     // Build URL
     std::string url = "/v1/spaces/" + space_id + "/properties/" + prop_id + "/tags";
 
-    httplib::Client client(base);
-    client.set_default_headers({
-        {"Authorization", "Bearer " + api_key},
-        {"Anytype-Version", api_version},
-        {"Content-Type", "application/json"},
-    });
-
-    client.set_connection_timeout(3, 0);
-    client.set_read_timeout(30, 0);
-    client.set_write_timeout(30, 0);
-
-    if (auto res = client.Get(url.c_str())) {
+    if (auto res = Send("property_tags",
+                        [&](httplib::Client &client) { return client.Get(url, headers); })) {
         if (res->status == 200) {
             try {
                 nlohmann::json page_json = nlohmann::json::parse(res->body);
@@ -489,6 +839,7 @@ nlohmann::json Anytype::NormalizeTask(const nlohmann::json &obj, int fallback_id
     nlohmann::json apps_allowed_prop = PropertyByKey(properties, "apps_allowed");
     nlohmann::json app_title_prop = PropertyByKey(properties, "app_title");
     nlohmann::json priority_key = PropertyByKey(properties, "priority");
+    nlohmann::json last_modified_prop = PropertyByKey(properties, "last_modified_date");
 
     if (m_Secrets.LoadSecret("task_categories_id").empty()) {
         for (auto prop : properties) {
@@ -519,6 +870,13 @@ nlohmann::json Anytype::NormalizeTask(const nlohmann::json &obj, int fallback_id
     out["priority"] = priority_key["select"]; //["name"];
     out["allowed_app_ids"] = ExtractArray(apps_allowed_prop);
     out["allowed_titles"] = ExtractArray(app_title_prop);
+    out["last_modified"] = GetString(last_modified_prop, "date", "");
+    // The same instant in UTC seconds (null when malformed); sync watermarks compare these.
+    if (const auto modifiedAt = ParseTimestamp(out["last_modified"].get<std::string>())) {
+        out["modified_at"] = *modifiedAt;
+    } else {
+        out["modified_at"] = nullptr;
+    }
 
     spdlog::debug("Anytype: Normalized task {}: title='{}', done={}", id, title, done);
     return out;
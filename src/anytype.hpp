@@ -1,6 +1,18 @@
+#pragma once
+
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
 
 #include <httplib.h>
 #include <nlohmann/json.hpp>
@@ -10,9 +22,21 @@
 
 class Anytype {
   public:
+    // Connectivity to the local API, maintained by a background probe so that nothing has to
+    // wait for Anytype at startup. Connecting: not reached yet since Start(). Ready: the last
+    // probe succeeded. Degraded: Anytype went away or never came up; probing continues slower.
+    enum class State { Connecting, Ready, Degraded };
+    using StateCallback = std::function<void(State)>;
+
     Anytype();
     ~Anytype();
 
+    // `onChange` runs on the probe thread after every state transition.
+    void Start(StateCallback onChange = {});
+    void Stop();
+    State GetState() const;
+    static const char *StateName(State state);
+
     // Login
     std::string LoginChallengeId();
     std::string CreateApiKey(const std::string &challenge_id, const std::string &code);
@@ -23,11 +47,43 @@ class Anytype {
 
     // Get
     nlohmann::json GetSpaces();
-    nlohmann::json GetTasks();
+    std::string SpaceId();
+    nlohmann::json GetTasks(const std::string &space_id);
+    // Tasks (done ones included) whose "modified_at" (UTC seconds) is at or after `since`,
+    // newest first. `newest` is set to the most recent one seen, or to `since` when none is.
+    nlohmann::json GetTasksModifiedSince(const std::string &space_id, std::int64_t since,
+                                         std::int64_t &newest);
+    // Seconds since the epoch of an ISO 8601 timestamp ("2025-01-31T08:00:00Z", fractions and
+    // UTC offsets allowed); nullopt when it is empty or malformed.
+    static std::optional<std::int64_t> ParseTimestamp(std::string_view text);
     nlohmann::json GetCategoriesOfTasks();
     nlohmann::json GetPage(const std::string &id);
 
   private:
+    void RunProbe();
+    bool Probe() const;
+    void RequestProbe();
+
+    // Keep-alive connections to the local API. httplib::Client is not safe for concurrent
+    // requests, so each call leases one from the pool and gives it back afterwards.
+    std::unique_ptr<httplib::Client> AcquireClient();
+    void ReleaseClient(std::unique_ptr<httplib::Client> client);
+    std::unique_ptr<httplib::Client> MakeClient() const;
+
+    // Runs `call` on a pooled connection and records its latency under `endpoint`. A transport
+    // error on a reused connection (e.g. Anytype restarted) is retried once on a fresh one when
+    // `idempotent`.
+    httplib::Result Send(std::string_view endpoint,
+                         const std::function<httplib::Result(httplib::Client &)> &call,
+                         bool idempotent = true);
+
+    httplib::Headers AuthHeaders();
+    static std::string BaseUrl();
+
+    std::optional<nlohmann::json> FetchTaskPage(const std::string &space_id,
+                                                const httplib::Headers &headers, int offset,
+                                                int limit, int &total, bool newestFirst = false);
+    nlohmann::json ProcessTaskPage(const nlohmann::json &objects, int offset);
     nlohmann::json GetAnytypeObjects(const nlohmann::json &payload);
     int GetExtractLength(const nlohmann::json &payload);
     nlohmann::json NormalizeTask(const nlohmann::json &obj, int fallback_id);
@@ -37,4 +93,19 @@ class Anytype {
                           const std::string &fallback);
 
     Secrets m_Secrets;
+
+    std::mutex m_ClientsMutex;
+    std::vector<std::unique_ptr<httplib::Client>> m_IdleClients;
+
+    std::atomic<State> m_State{State::Connecting};
+    StateCallback m_OnStateChange;
+    std::mutex m_ProbeMutex;
+    std::condition_variable m_ProbeCv;
+    bool m_ProbeWanted = false;
+    bool m_StopProbe = false;
+    std::thread m_ProbeThread;
+
+    std::mutex m_AuthMutex;
+    std::string m_AuthKey;
+    httplib::Headers m_AuthHeaders;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <filesystem>
 #include <string>
 
 enum FocusState { FOCUSED = 1, UNFOCUSED = 2, IDLE = 3 , DISABLE = 4};
@@ -8,6 +10,29 @@ enum MonitoringState { MONITORING_ENABLE = 1, MONITORING_DISABLE = 2 };
 
 enum LogLevel { LOG_DEBUG, LOG_INFO, LOG_OFF };
 
+// Command line tunables, see main.cpp for the flags.
+struct RuntimeOptions {
+    unsigned port = 7079;
+    unsigned ping = 1; // Seconds between focus polls when no event stream is available
+    LogLevel logLevel = LOG_OFF;
+    // Quiet period after the last special_project update before a burst is committed.
+    std::chrono::milliseconds contextSettle{300};
+    // How often the Anytype task list is refreshed in the background.
+    std::chrono::seconds anytypeRefresh{60};
+    // How long a newly focused window must keep focus before the tracker switches to it.
+    std::chrono::milliseconds focusSettle{2000};
+    // How long the logind session must be idle before the user counts as away.
+    std::chrono::seconds idleAfter{0};
+    // Compositor IPC tape (IpcTape): written while tracking with --record, or fed through the
+    // tracking pipeline instead of the live session with --replay.
+    std::filesystem::path recordPath;
+    std::filesystem::path replayPath;
+    // Replay pace as a multiple of the recorded one; 0 replays as fast as possible.
+    unsigned replaySpeed = 0;
+    // Database a replay writes to; empty means a scratch database, removed afterwards.
+    std::filesystem::path replayDb;
+};
+
 struct FocusedWindow {
     int window_id = -1;
     std::string title;
@@ -6,11 +6,17 @@
 #include <thread>
 #include <chrono>
 #include <algorithm>
+#include <array>
+#include <ctime>
+#include <iostream>
 #include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
 
 // ─────────────────────────────────────
-Concentrate::Concentrate(const unsigned port, const unsigned ping, LogLevel log_level)
-    : m_Port(port), m_Ping(ping) {
+Concentrate::Concentrate(const RuntimeOptions &options)
+    : m_Options(options), m_Port(options.port), m_Ping(options.ping) {
+    const LogLevel log_level = options.logLevel;
 
     if (log_level == LOG_DEBUG) {
         spdlog::set_level(spdlog::level::debug);
@@ -20,6 +26,17 @@ Concentrate::Concentrate(const unsigned port, const unsigned ping, LogLevel log_
         spdlog::set_level(spdlog::level::off);
     }
 
+    // Empty rule set until the current task and daily activities are loaded.
+    RebuildFocusRules();
+    m_TitleCanon = std::make_unique<const TitleCanonicalizer>(
+        TitleCanonicalizer::LoadRules(GetConfigDir() / "titles.json"));
+
+    // Replay (--replay): only the tracking pipeline, fed from a tape instead of the session.
+    if (!m_Options.replayPath.empty()) {
+        RunReplay();
+        return;
+    }
+
     // Server
     m_Root = GetBinaryPath();
     if (!std::filesystem::exists(m_Root)) {
@@ -35,10 +52,14 @@ Concentrate::Concentrate(const unsigned port, const unsigned ping, LogLevel log_
 
     // Secrets
     m_Secrets = std::make_unique<Secrets>();
+    m_Secrets->Preload();
     spdlog::info("Secrets manager initialized");
 
-    // Server
-    InitServer();
+    // Restored before the server starts, so the API never reports an empty current task.
+    {
+        std::lock_guard<std::mutex> lock(m_TaskResolveMutex);
+        m_RequestedTaskId = m_Secrets->LoadSecret("current_task_id");
+    }
 
     // SQlite
     m_SQLite = std::make_unique<SQLite>(dbpath);
@@ -46,15 +67,59 @@ Concentrate::Concentrate(const unsigned port, const unsigned ping, LogLevel log_
 
     // Anytype
     m_Anytype = std::make_unique<Anytype>();
+    m_TaskCache =
+        std::make_unique<AnytypeTaskCache>(*m_Anytype, dbpath, m_Options.anytypeRefresh);
+    m_TaskCache->Start();
+    // Connectivity is probed in the background; tracking and the API do not wait for it.
+    m_Anytype->Start([this](Anytype::State state) {
+        if (state != Anytype::State::Ready) {
+            return;
+        }
+        m_TaskCache->RequestRefresh();
+
+        // The current task (or its body) could not be resolved while Anytype was away.
+        bool unresolved = false;
+        {
+            std::lock_guard<std::mutex> lock(m_GlobalMutex);
+            unresolved = m_TaskTitle.empty() || m_TaskMarkdown.empty();
+        }
+        if (unresolved) {
+            RequestTaskResolve();
+        }
+    });
     spdlog::info("Anytype client initialized");
 
+    // Notifications
+    m_Notification = std::make_unique<Notification>(m_Reactor);
+    spdlog::info("Notification system initialized");
+
+    // Time
+    std::string monitoring_str = m_Secrets->LoadSecret("monitoring_enabled");
+    m_MonitoringEnabled.store(monitoring_str.empty() ? true : (monitoring_str == "true"));
+
+    // Server. Everything the request handlers touch exists before the listeners start; none
+    // of it blocks (Anytype is probed and synced in the background).
+    InitServer();
+
     // Windows API (get AppID, Title)
     m_Window = std::make_unique<Window>();
     spdlog::info("Window API initialized");
 
+    if (!m_Options.recordPath.empty()) {
+        if (!m_Window->SupportsTape()) {
+            spdlog::warn("IPC recording is only supported on niri and Hyprland; not recording");
+        } else if (auto tape = std::make_unique<IpcTape::Recorder>(m_Options.recordPath,
+                                                                   m_Window->BackendName());
+                   tape->IsOpen()) {
+            m_Tape = std::move(tape);
+            m_Window->SetRecorder(m_Tape.get());
+            spdlog::info("Recording compositor IPC to {}", m_Options.recordPath.string());
+        }
+    }
+
     // Prefer event-driven focus updates via Niri IPC EventStream; fall back to polling when not
     // available.
-    if (m_Window && m_Window->StartEventStream([this]() {
+    if (m_Window && m_Window->StartEventStream(m_Reactor, [this]() {
             // Avoid wake storms: if we're already dirty, the main loop will refresh soon anyway.
             const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
             if (!wasDirty) {
@@ -68,36 +133,36 @@ Concentrate::Concentrate(const unsigned port, const unsigned ping, LogLevel log_
         spdlog::warn("Niri IPC event stream unavailable; falling back to polling mode");
     }
 
-    // Notifications
-    m_Notification = std::make_unique<Notification>();
-    spdlog::info("Notification system initialized");
-
     // Tray icon (DBus StatusNotifierItem)
     m_Tray = std::make_unique<TrayIcon>();
-    if (m_Tray->Start("Concentrate")) {
+    if (m_Tray->Start("Concentrate", m_Reactor, [this] { WakeScheduler(); })) {
         m_Tray->SetTrayIcon(IDLE);
         spdlog::info("Tray icon initialized");
     } else {
         spdlog::warn("Tray icon not available (no DBus watcher or session bus)");
     }
 
+    // Idle detection (logind session IdleHint/LockedHint on the system bus)
+    m_Idle = std::make_unique<IdleMonitor>(m_Reactor, m_Options.idleAfter,
+                                           [this] { WakeScheduler(); });
+    if (!m_Idle->Start()) {
+        spdlog::warn("Idle detection unavailable (no logind session); retrying in background");
+    }
+
     // HydrationService
     m_Hydration = std::make_unique<HydrationService>();
 
-    // Time
-    std::string monitoring_str = m_Secrets->LoadSecret("monitoring_enabled");
-    m_MonitoringEnabled.store(monitoring_str.empty() ? true : (monitoring_str == "true"));
-
     // monitoring
     if (!m_MonitoringEnabled.load()) {
         m_Notification->SendNotification("concentrate-off", "Concentrate",
                                          "Apps monitoring is off");
     }
 
-    UpdateAllowedApps();
+    m_TaskResolveThread = std::thread([this] { RunTaskResolver(); });
+    RequestTaskResolve();
     RefreshDailyActivities();
 
-    InitLoopState();
+    InitLoopState(std::chrono::steady_clock::now());
     RunMainLoop();
 }
 
@@ -123,6 +188,18 @@ Concentrate::~Concentrate() {
     if (m_Window) {
         m_Window->StopEventStream();
     }
+    {
+        std::lock_guard<std::mutex> lock(m_TaskResolveMutex);
+        m_TaskResolveStop = true;
+    }
+    m_TaskResolveCv.notify_all();
+    if (m_TaskResolveThread.joinable()) {
+        m_TaskResolveThread.join();
+    }
+    // Its state callback touches the task cache, which is destroyed first.
+    if (m_Anytype) {
+        m_Anytype->Stop();
+    }
 
     if (hasLastRecordSnapshot && lastStateSnapshot != IDLE) {
         auto now = std::chrono::steady_clock::now();
@@ -147,6 +224,16 @@ Concentrate::~Concentrate() {
         }
     }
 
+    m_CommandSocket.reset();
+    m_UnixServer.stop();
+    if (m_UnixThread.joinable()) {
+        m_UnixThread.join();
+    }
+    if (!m_UnixSocketPath.empty()) {
+        std::error_code ec;
+        std::filesystem::remove(m_UnixSocketPath, ec);
+    }
+
     m_Server.stop();
     if (m_Thread.joinable()) {
         m_Thread.join();
@@ -154,9 +241,7 @@ Concentrate::~Concentrate() {
 }
 
 // ─────────────────────────────────────
-void Concentrate::InitLoopState() {
-    const auto now = std::chrono::steady_clock::now();
-
+void Concentrate::InitLoopState(std::chrono::steady_clock::time_point now) {
     // Hydration
     m_HydrationIntervalMinutes = 10.0;
     const double dailyLiters = m_Hydration ? m_Hydration->GetLiters() : 0.0;
@@ -198,9 +283,6 @@ void Concentrate::InitLoopState() {
     // Focus refresh timing
     m_LastFocusQueryAt = now - std::chrono::seconds(m_Ping);
 
-    // Tray polling
-    m_NextTrayPollAt = now;
-
     // Last tracked interval snapshot
     {
         std::lock_guard<std::mutex> lock(m_GlobalMutex);
@@ -237,23 +319,26 @@ void Concentrate::RefreshFocusSnapshotIfNeeded(std::chrono::steady_clock::time_p
     FocusedWindow fresh = m_Window ? m_Window->GetFocusedWindow() : FocusedWindow{};
     {
         std::lock_guard<std::mutex> lock(m_GlobalMutex);
+        m_WindowFw = fresh;
         m_Fw = fresh;
     }
 }
 
 // ─────────────────────────────────────
 FocusedWindow Concentrate::LoadFocusedWindowSnapshot() {
+    // The compositor's view, before any integration override was applied to it.
     std::lock_guard<std::mutex> lock(m_GlobalMutex);
-    return m_Fw;
+    return m_WindowFw;
 }
 
 // ─────────────────────────────────────
 FocusState Concentrate::ComputeFocusStateAndPersist(FocusedWindow &fw_local) {
-    if (m_SpecialProjectFocused) {
-        fw_local.app_id = m_SpecialAppId;
-        fw_local.title = m_SpecialProjectTitle;
-        spdlog::debug("Special project focus override: app_id='{}', title='{}'", fw_local.app_id,
-                      fw_local.title);
+    if (auto context = ContextRegistry::Select(*m_CommittedContexts, fw_local.app_id,
+                                               std::chrono::steady_clock::now())) {
+        spdlog::debug("Special project focus override from '{}': app_id='{}', title='{}'",
+                      context->source, context->app_id, context->title);
+        fw_local.app_id = std::move(context->app_id);
+        fw_local.title = std::move(context->title);
     }
 
     FocusState currentState = AmIFocused(fw_local);
@@ -383,6 +468,7 @@ void Concentrate::CloseOpenFocusInterval(std::chrono::steady_clock::time_point n
 // ─────────────────────────────────────
 void Concentrate::ResetOpenFocusIntervalToIdle() {
     m_HasOpenInterval = false;
+    m_HasPendingFocus = false;
     m_OpenState = IDLE;
     m_OpenAppId.clear();
     m_OpenTitle.clear();
@@ -498,9 +584,66 @@ void Concentrate::UpdateHydrationIfDue(std::chrono::steady_clock::time_point now
     m_LastHydrationNotification = now;
 }
 
+// ─────────────────────────────────────
+std::chrono::steady_clock::time_point
+Concentrate::SettleFocusChange(std::chrono::steady_clock::time_point now, FocusState &state,
+                               FocusedWindow &fw) {
+    static auto &committed = Metrics::Instance().GetCounter(
+        "concentrate_focus_changes_total", "Focus changes by settle outcome.",
+        Metrics::Labels({{"result", "committed"}}));
+    static auto &folded = Metrics::Instance().GetCounter(
+        "concentrate_focus_changes_total", "Focus changes by settle outcome.",
+        Metrics::Labels({{"result", "folded"}}));
+
+    // Nothing to fold into: the first interval after idle/disabled starts right away.
+    if (!m_HasOpenInterval || m_Options.focusSettle.count() == 0) {
+        m_HasPendingFocus = false;
+        return now;
+    }
+
+    if (state == m_OpenState && fw.app_id == m_OpenAppId && fw.title == m_OpenTitle &&
+        fw.category == m_OpenCategory) {
+        if (m_HasPendingFocus) {
+            // Back before the settle window ran out (alt-tab and back, a popup).
+            folded.Inc();
+            m_HasPendingFocus = false;
+        }
+        return now;
+    }
+
+    if (!m_HasPendingFocus || state != m_PendingState || fw.app_id != m_PendingAppId ||
+        fw.title != m_PendingTitle || fw.category != m_PendingCategory) {
+        if (m_HasPendingFocus) {
+            folded.Inc();
+        }
+        m_HasPendingFocus = true;
+        m_PendingState = state;
+        m_PendingAppId = fw.app_id;
+        m_PendingTitle = fw.title;
+        m_PendingCategory = fw.category;
+        m_PendingSince = now;
+    }
+
+    if (now - m_PendingSince >= m_Options.focusSettle) {
+        committed.Inc();
+        m_HasPendingFocus = false;
+        return m_PendingSince;
+    }
+
+    state = m_OpenState;
+    fw.app_id = m_OpenAppId;
+    fw.title = m_OpenTitle;
+    fw.category = m_OpenCategory;
+    return now;
+}
+
 // ─────────────────────────────────────
 void Concentrate::UpdateFocusInterval(std::chrono::steady_clock::time_point now,
-                                      FocusState currentState, const FocusedWindow &fw_local) {
+                                      FocusState currentState, const FocusedWindow &fw_local,
+                                      std::chrono::steady_clock::time_point changedAt) {
+    static auto &intervals = Metrics::Instance().GetCounter(
+        "concentrate_focus_intervals_total", "Focus intervals started (focus_log inserts).");
+
     const std::string currAppId = fw_local.app_id;
     const std::string currTitle = fw_local.title;
     const std::string currCategory = fw_local.category;
@@ -517,6 +660,7 @@ void Concentrate::UpdateFocusInterval(std::chrono::steady_clock::time_point now,
         const double startUnix = ToUnixTime(m_IntervalStart);
         m_SQLite->InsertEventNew(m_OpenAppId, m_OpenTitle, m_OpenCategory, startUnix, startUnix,
                                  0.0, m_OpenState);
+        intervals.Inc();
         return;
     }
 
@@ -524,20 +668,23 @@ void Concentrate::UpdateFocusInterval(std::chrono::steady_clock::time_point now,
                          (currTitle != m_OpenTitle) || (currCategory != m_OpenCategory);
 
     if (changed) {
-        // Close previous interval with a final UPDATE.
-        CloseOpenFocusInterval(now, "changed");
+        // Close previous interval with a final UPDATE. A settled change is dated from when the
+        // new window got focus, not from when the settle window ran out.
+        const auto boundary = std::clamp(changedAt, m_IntervalStart, now);
+        CloseOpenFocusInterval(boundary, "changed");
 
         // Start next interval and INSERT.
         m_OpenState = currentState;
         m_OpenAppId = currAppId;
         m_OpenTitle = currTitle;
         m_OpenCategory = currCategory;
-        m_IntervalStart = now;
+        m_IntervalStart = boundary;
         m_LastDbFlush = now;
 
         const double startUnix2 = ToUnixTime(m_IntervalStart);
         m_SQLite->InsertEventNew(m_OpenAppId, m_OpenTitle, m_OpenCategory, startUnix2, startUnix2,
                                  0.0, m_OpenState);
+        intervals.Inc();
         return;
     }
 
@@ -553,6 +700,37 @@ void Concentrate::UpdateFocusInterval(std::chrono::steady_clock::time_point now,
     }
 }
 
+// ─────────────────────────────────────
+const std::string &Concentrate::CanonicalTitle(const std::string &appId,
+                                               const std::string &title) {
+    // kept: the raw title change survives canonicalization (a new interval, if nothing else
+    // differs); collapsed: it only touched volatile parts and the interval continues.
+    static auto &kept = Metrics::Instance().GetCounter(
+        "concentrate_title_changes_total", "Raw window title changes by canonicalization outcome.",
+        Metrics::Labels({{"result", "kept"}}));
+    static auto &collapsed = Metrics::Instance().GetCounter(
+        "concentrate_title_changes_total", "Raw window title changes by canonicalization outcome.",
+        Metrics::Labels({{"result", "collapsed"}}));
+
+    if (title == m_CanonRawTitle && appId == m_CanonAppId) {
+        return m_CanonTitle;
+    }
+
+    std::string canonical = m_TitleCanon ? m_TitleCanon->Apply(appId, title) : title;
+    if (appId == m_CanonAppId) {
+        if (canonical == m_CanonTitle) {
+            collapsed.Inc();
+        } else {
+            kept.Inc();
+        }
+    }
+
+    m_CanonAppId = appId;
+    m_CanonRawTitle = title;
+    m_CanonTitle = std::move(canonical);
+    return m_CanonTitle;
+}
+
 // ─────────────────────────────────────
 void Concentrate::PublishLastTrackedIntervalSnapshot() {
     std::lock_guard<std::mutex> lock(m_GlobalMutex);
@@ -574,19 +752,12 @@ void Concentrate::PublishLastTrackedIntervalSnapshot() {
 }
 
 // ─────────────────────────────────────
-bool Concentrate::PumpTrayIfDue(std::chrono::steady_clock::time_point now, bool eventDriven) {
+bool Concentrate::HandleTrayRequests() {
     if (!m_Tray) {
         return false;
     }
 
-    const auto trayPollEvery = eventDriven ? std::chrono::seconds(1) : std::chrono::seconds(m_Ping);
-    if (now < m_NextTrayPollAt) {
-        return false;
-    }
-
-    m_Tray->Poll();
-    m_NextTrayPollAt = now + trayPollEvery;
-
+    // Raised while the reactor dispatched the tray's DBus calls; each one also woke the loop.
     if (m_Tray->TakeOpenUiRequested()) {
         int result =
             std::system(("xdg-open http://127.0.0.1:" + std::to_string(m_Port) + "/ &").c_str());
@@ -608,56 +779,81 @@ bool Concentrate::PumpTrayIfDue(std::chrono::steady_clock::time_point now, bool
 }
 
 // ─────────────────────────────────────
-bool Concentrate::UpdateTray(std::chrono::steady_clock::time_point now, FocusState iconState,
-                             bool eventDriven) {
+bool Concentrate::UpdateTray(FocusState iconState) {
     if (!m_Tray) {
         return false;
     }
 
     m_Tray->SetTrayIcon(iconState);
-    return PumpTrayIfDue(now, eventDriven);
+    return HandleTrayRequests();
 }
 
 // ─────────────────────────────────────
-void Concentrate::WaitUntilNextDeadline(FocusState currentState, bool monitoringEnabledNow,
-                                        bool eventDriven) {
-    const auto now2 = std::chrono::steady_clock::now();
+std::pair<std::chrono::steady_clock::time_point, Concentrate::WakeCause>
+Concentrate::NextDeadline(std::chrono::steady_clock::time_point now2, FocusState currentState,
+                          bool monitoringEnabledNow, bool eventDriven) const {
     auto deadline = now2 + std::chrono::hours(24);
+    WakeCause cause = WakeCause::MaxSleep;
+
+    // Remember which deadline is the earliest so wakeups can be attributed in /metrics.
+    const auto consider = [&](std::chrono::steady_clock::time_point tp, WakeCause what) {
+        if (tp < deadline) {
+            deadline = tp;
+            cause = what;
+        }
+    };
 
-    // Tray polling
-    if (m_Tray) {
-        deadline = std::min(deadline, m_NextTrayPollAt);
+    // Integration overrides lapse without any event; re-evaluate focus when one does.
+    if (auto expiry = ContextRegistry::NextExpiry(*m_CommittedContexts, now2)) {
+        consider(*expiry, WakeCause::ContextExpiry);
+    }
+    if (auto settle = ContextSettleDeadline()) {
+        consider(*settle, WakeCause::ContextSettle);
     }
 
-    // Focus refresh cadence
-    if (!eventDriven) {
-        deadline = std::min(deadline, m_LastFocusQueryAt + std::chrono::seconds(m_Ping));
-    } else {
-        deadline = std::min(deadline, m_LastFocusQueryAt + kSafetyPollEvery);
+    // Focus refresh cadence. While the user is away nothing is recorded, so there is nothing to
+    // poll for; the idle monitor wakes the loop when they are back.
+    const bool away = m_Idle && m_Idle->IsAway();
+    if (!away) {
+        if (!eventDriven) {
+            consider(m_LastFocusQueryAt + std::chrono::seconds(m_Ping), WakeCause::FocusPoll);
+        } else {
+            consider(m_LastFocusQueryAt + kSafetyPollEvery, WakeCause::SafetyPoll);
+        }
     }
 
     // Hydration/climate
     // These tasks are only processed when monitoring is enabled and we're not idle.
     // In IDLE, their timestamps are not advanced, so including them here can create an
     // always-expired deadline and cause a tight loop.
+    // Without the services (replay) nothing advances them either.
     if (monitoringEnabledNow && currentState != IDLE) {
-        deadline = std::min(
-            deadline, m_LastHydrationNotification +
-                          std::chrono::minutes(static_cast<int>(m_HydrationIntervalMinutes)));
-        deadline = std::min(deadline, m_LastClimateUpdate + std::chrono::hours(3));
+        if (m_Notification && m_SQLite) {
+            consider(m_LastHydrationNotification +
+                         std::chrono::minutes(static_cast<int>(m_HydrationIntervalMinutes)),
+                     WakeCause::Hydration);
+        }
+        if (m_Hydration) {
+            consider(m_LastClimateUpdate + std::chrono::hours(3), WakeCause::Climate);
+        }
     }
 
     // Monitoring disabled reminder
-    if (!monitoringEnabledNow) {
-        deadline = std::min(deadline, m_LastMonitoringNotification + std::chrono::minutes(1));
+    if (!monitoringEnabledNow && !away) {
+        consider(m_LastMonitoringNotification + std::chrono::minutes(1), WakeCause::MonitoringReminder);
+    }
+
+    // A held-back focus change commits when its settle window runs out.
+    if (m_HasPendingFocus) {
+        consider(m_PendingSince + m_Options.focusSettle, WakeCause::FocusSettle);
     }
 
     // Periodic DB flushes
     if (m_HasOpenInterval && m_OpenState != IDLE) {
-        deadline = std::min(deadline, m_LastDbFlush + kDbFlushEvery);
+        consider(m_LastDbFlush + kDbFlushEvery, WakeCause::DbFlush);
     }
     if (m_HasOpenMonitoringInterval) {
-        deadline = std::min(deadline, m_LastMonitoringDbFlush + kDbFlushEvery);
+        consider(m_LastMonitoringDbFlush + kDbFlushEvery, WakeCause::MonitoringFlush);
     }
 
     // Unfocused warning timing
@@ -666,134 +862,355 @@ void Concentrate::WaitUntilNextDeadline(FocusState currentState, bool monitoring
                                   ? (now2 + kUnfocusedWarnEvery)
                                   : std::max(m_UnfocusedSince + kUnfocusedWarnEvery,
                                              m_LastUnfocusedWarningAt + kUnfocusedWarnEvery);
-        deadline = std::min(deadline, nextWarn);
+        consider(nextWarn, WakeCause::UnfocusedWarning);
     }
 
-    const auto seq = m_WakeupSeq.load(std::memory_order_relaxed);
-    std::unique_lock<std::mutex> lk(m_SchedulerMutex);
-    m_SchedulerCv.wait_until(lk, deadline, [&] {
-        if (m_ShutdownRequested.load()) {
-            return true;
-        }
-        if (m_WakeupSeq.load(std::memory_order_relaxed) != seq) {
-            return true;
-        }
+    return {deadline, cause};
+}
 
-        // Only check focus dirty ONCE per wakeup sequence
-        // Don't keep checking it on spurious wakeups
-        return false;
-    });
+// ─────────────────────────────────────
+void Concentrate::WaitUntilNextDeadline(FocusState currentState, bool monitoringEnabledNow,
+                                        bool eventDriven) {
+    static auto &iterationTime = Metrics::Instance().GetHistogram(
+        "concentrate_loop_iteration_duration_seconds",
+        "Time spent doing work in one main loop iteration, excluding the wait.");
+
+    const auto now = std::chrono::steady_clock::now();
+    iterationTime.Observe(now - m_LoopIterationStart);
+    const auto [deadline, cause] =
+        NextDeadline(now, currentState, monitoringEnabledNow, eventDriven);
+
+    // Compositor events, DBus calls and reactor timers are handled inside RunUntil(); it only
+    // returns for a WakeScheduler() or the deadline.
+    const bool notified = m_ShutdownRequested.load() || m_Reactor.RunUntil(deadline);
+
+    CountLoopWakeup(notified ? WakeCause::Notify : cause);
+}
+
+// ─────────────────────────────────────
+const char *Concentrate::WakeCauseName(WakeCause cause) {
+    switch (cause) {
+    case WakeCause::MaxSleep:
+        return "max_sleep";
+    case WakeCause::ContextExpiry:
+        return "context_expiry";
+    case WakeCause::ContextSettle:
+        return "context_settle";
+    case WakeCause::FocusPoll:
+        return "focus_poll";
+    case WakeCause::SafetyPoll:
+        return "safety_poll";
+    case WakeCause::Hydration:
+        return "hydration";
+    case WakeCause::Climate:
+        return "climate";
+    case WakeCause::MonitoringReminder:
+        return "monitoring_reminder";
+    case WakeCause::FocusSettle:
+        return "focus_settle";
+    case WakeCause::DbFlush:
+        return "db_flush";
+    case WakeCause::MonitoringFlush:
+        return "monitoring_flush";
+    case WakeCause::UnfocusedWarning:
+        return "unfocused_warning";
+    case WakeCause::Notify:
+        return "notify";
+    case WakeCause::Count:
+        break;
+    }
+    return "unknown";
+}
+
+// ─────────────────────────────────────
+void Concentrate::CountLoopWakeup(WakeCause cause) {
+    // The set of causes is fixed; every counter is resolved once, on the first wakeup.
+    static const auto counters = [] {
+        std::array<Metrics::Counter *, static_cast<std::size_t>(WakeCause::Count)> resolved{};
+        for (std::size_t i = 0; i < resolved.size(); ++i) {
+            resolved[i] = &Metrics::Instance().GetCounter(
+                "concentrate_loop_wakeups_total",
+                "Main loop wakeups by cause (deadline that fired, or notify).",
+                Metrics::Labels({{"cause", WakeCauseName(static_cast<WakeCause>(i))}}));
+        }
+        return resolved;
+    }();
+    counters[static_cast<std::size_t>(cause)]->Inc();
 }
 
 // ─────────────────────────────────────
 void Concentrate::RunMainLoop() {
-    bool running = true;
-    while (running) {
+    auto &iterations = Metrics::Instance().GetCounter("concentrate_loop_iterations_total",
+                                                      "Main loop iterations.");
+    while (true) {
+        iterations.Inc();
         const auto now = std::chrono::steady_clock::now();
-        if (m_Notification) {
-            m_Notification->Poll();
-        }
+        m_LoopIterationStart = now;
         const bool eventDriven = m_EventDriven.load();
-        RefreshFocusSnapshotIfNeeded(now, eventDriven);
 
-        HandleMonitoringToggleSplit(now);
-        bool monitoringEnabledNow = m_MonitoringEnabled.load();
+        FocusState currentState = IDLE;
+        bool monitoringEnabledNow = true;
+        if (RunLoopIteration(now, eventDriven, currentState, monitoringEnabledNow)) {
+            break;
+        }
+        WaitUntilNextDeadline(currentState, monitoringEnabledNow, eventDriven);
+    }
+}
+
+// ─────────────────────────────────────
+bool Concentrate::RunLoopIteration(std::chrono::steady_clock::time_point now, bool eventDriven,
+                                   FocusState &currentState, bool &monitoringEnabledNow) {
+    RefreshFocusSnapshotIfNeeded(now, eventDriven);
 
-        // Auto-enable monitoring if it stays disabled for too long.
-        if (!monitoringEnabledNow) {
-            if (!m_MonitoringDisabledStreak) {
-                m_MonitoringDisabledStreak = true;
-                m_MonitoringDisabledSince = now;
-            }
+    HandleMonitoringToggleSplit(now);
+    monitoringEnabledNow = m_MonitoringEnabled.load();
 
-            if ((now - m_MonitoringDisabledSince) >= std::chrono::minutes(15)) {
-                spdlog::warn("Monitoring disabled for >= 15 minutes; auto-enabling");
-                m_MonitoringEnabled.store(true);
-                m_MonitoringTogglePending.store(true, std::memory_order_relaxed);
-                HandleMonitoringToggleSplit(now);
-                if (m_Secrets) {
-                    m_Secrets->SaveSecret("monitoring_enabled", "true");
-                }
-                if (m_Notification) {
-                    m_Notification->SendNotification(
-                        "dialog-warning", "Monitoring Auto-Enabled",
-                        "Monitoring was disabled for a long time (15 minutes). Enabling it automatically.");
-                }
-                m_MonitoringDisabledStreak = false;
-                m_LastMonitoringNotification = now;
-                monitoringEnabledNow = true;
+    // Auto-enable monitoring if it stays disabled for too long.
+    if (!monitoringEnabledNow) {
+        if (!m_MonitoringDisabledStreak) {
+            m_MonitoringDisabledStreak = true;
+            m_MonitoringDisabledSince = now;
+        }
+
+        if ((now - m_MonitoringDisabledSince) >= std::chrono::minutes(15)) {
+            spdlog::warn("Monitoring disabled for >= 15 minutes; auto-enabling");
+            m_MonitoringEnabled.store(true);
+            m_MonitoringTogglePending.store(true, std::memory_order_relaxed);
+            HandleMonitoringToggleSplit(now);
+            if (m_Secrets) {
+                m_Secrets->SaveSecret("monitoring_enabled", "true");
+            }
+            if (m_Notification) {
+                m_Notification->SendNotification(
+                    "dialog-warning", "Monitoring Auto-Enabled",
+                    "Monitoring was disabled for a long time (15 minutes). Enabling it automatically.");
             }
-        } else {
             m_MonitoringDisabledStreak = false;
+            m_LastMonitoringNotification = now;
+            monitoringEnabledNow = true;
         }
+    } else {
+        m_MonitoringDisabledStreak = false;
+    }
 
-        FocusedWindow fw_local = LoadFocusedWindowSnapshot();
-        FocusState currentState = ComputeFocusStateAndPersist(fw_local);
+    CommitSettledContexts(now);
+    FocusedWindow fw_local = LoadFocusedWindowSnapshot();
+    currentState = ComputeFocusStateAndPersist(fw_local);
 
+    const auto awaySince = m_Idle ? m_Idle->AwaySince() : std::nullopt;
+    if (!awaySince) {
         MaybeNotifyMonitoringDisabled(now, monitoringEnabledNow);
+    }
 
+    // IDLE: Always close any open focus interval AND any open monitoring interval.
+    // Monitoring time is NOT counted while idle.
+    if (currentState == IDLE) {
+        // When the user walked away, the intervals end where the session went idle rather
+        // than when the idle hint reached us.
+        const auto focusEnd = awaySince ? std::clamp(*awaySince, m_IntervalStart, now) : now;
+        const auto monitoringEnd =
+            awaySince ? std::clamp(*awaySince, m_MonitoringIntervalStart, now) : now;
+        // Close any open focus interval (focus_log)
+        CloseOpenFocusInterval(focusEnd, awaySince ? "away" : "idle");
+        // Close any open monitoring interval (monitoring_log)
+        CloseOpenMonitoringInterval(monitoringEnd);
+        // Reset interval state
+        ResetOpenFocusIntervalToIdle();
+        ResetOpenMonitoringInterval();
+        ResetLastTrackedSnapshot(IDLE);
+        // Do NOT start a new monitoring session while idle
+        return UpdateTray(IDLE);
+    }
+
+    // Monitoring sessions are recorded only when NOT idle.
+    UpdateMonitoringSession(now, monitoringEnabledNow);
+    if (!monitoringEnabledNow) {
+        // Reset unfocused streak tracking while monitoring is disabled.
+        m_InUnfocusedStreak = false;
+        m_UnfocusedSince = now;
+        m_LastUnfocusedWarningAt = now;
 
-        // IDLE: Always close any open focus interval AND any open monitoring interval.
-        // Monitoring time is NOT counted while idle.
-        if (currentState == IDLE) {
-            // Close any open focus interval (focus_log)
-            CloseOpenFocusInterval(now, "idle");
-            // Close any open monitoring interval (monitoring_log)
-            CloseOpenMonitoringInterval(now);
-            // Reset interval state
-            ResetOpenFocusIntervalToIdle();
-            ResetOpenMonitoringInterval();
-            ResetLastTrackedSnapshot(IDLE);
-            if (UpdateTray(now, IDLE, eventDriven)) {
-                break;
-            }
-            // Do NOT start a new monitoring session while idle
-            WaitUntilNextDeadline(currentState, monitoringEnabledNow, eventDriven);
-            continue;
-        }
+        // Close any open interval before entering the disabled/idle state.
+        CloseOpenFocusInterval(now, "disabled");
+        ResetOpenFocusIntervalToIdle();
+        m_OpenState = DISABLE;
+        ResetLastTrackedSnapshot(DISABLE);
 
-        // Monitoring sessions are recorded only when NOT idle.
-        UpdateMonitoringSession(now, monitoringEnabledNow);
-        if (!monitoringEnabledNow) {
-            // Reset unfocused streak tracking while monitoring is disabled.
-            m_InUnfocusedStreak = false;
-            m_UnfocusedSince = now;
-            m_LastUnfocusedWarningAt = now;
+        return UpdateTray(DISABLE);
+    }
 
-            // Close any open interval before entering the disabled/idle state.
-            CloseOpenFocusInterval(now, "disabled");
-            ResetOpenFocusIntervalToIdle();
-            m_OpenState = DISABLE;
-            ResetLastTrackedSnapshot(DISABLE);
+    // Interval tracking sees canonical titles and only settled focus changes; a blip keeps
+    // reporting the open interval, for the unfocused warning as well.
+    fw_local.title = CanonicalTitle(fw_local.app_id, fw_local.title);
+    const auto changedAt = SettleFocusChange(now, currentState, fw_local);
 
-            if (UpdateTray(now, DISABLE, eventDriven)) {
-                break;
-            }
+    UpdateUnfocusedWarning(now, currentState);
+    EnsureTaskCategory();
+    UpdateClimateIfDue(now);
+    UpdateHydrationIfDue(now, currentState);
 
-            WaitUntilNextDeadline(currentState, monitoringEnabledNow, eventDriven);
-            continue;
-        }
+    UpdateFocusInterval(now, currentState, fw_local, changedAt);
+    PublishLastTrackedIntervalSnapshot();
 
-        UpdateUnfocusedWarning(now, currentState);
-        EnsureTaskCategory();
-        UpdateClimateIfDue(now);
-        UpdateHydrationIfDue(now, currentState);
+    return UpdateTray(currentState);
+}
+
+// ─────────────────────────────────────
+void Concentrate::RunReplay() {
+    using Clock = std::chrono::steady_clock;
+
+    std::string backend;
+    std::string error;
+    std::vector<IpcTape::Record> records;
+    if (!IpcTape::Load(m_Options.replayPath, backend, records, error)) {
+        std::cerr << "Cannot replay: " << error << std::endl;
+        exit(1);
+    }
+    const auto wm = Window::ParseBackendName(backend);
+    if (!wm) {
+        std::cerr << "Cannot replay: unsupported backend '" << backend << "'" << std::endl;
+        exit(1);
+    }
 
-        UpdateFocusInterval(now, currentState, fw_local);
-        PublishLastTrackedIntervalSnapshot();
+    const bool scratchDb = m_Options.replayDb.empty();
+    const std::filesystem::path dbpath =
+        scratchDb ? std::filesystem::temp_directory_path() /
+                        fmt::format("concentrate-replay-{}.db", static_cast<long>(getpid()))
+                  : m_Options.replayDb;
+    m_SQLite = std::make_unique<SQLite>(dbpath.string());
+    // Daily activities classify windows as in the live tracker when replaying into a copy of
+    // the real database.
+    RefreshDailyActivities();
 
-        if (UpdateTray(now, currentState, eventDriven)) {
-            break;
+    // Virtual clock: the tape is laid out so that it ends now, and focus_log rows get plausible
+    // timestamps. It only moves with the records and with the deadlines in between.
+    const auto span = records.empty() ? std::chrono::milliseconds(0) : records.back().at;
+    const auto origin = Clock::now() - span;
+    auto virtualNow = origin;
+    InitLoopState(origin);
+    m_EventDriven.store(true);
+
+    // The latest recorded reply to each request answers the queries made in replay. Replies
+    // recorded before the first event belong to connecting (Hyprland's clients snapshot).
+    std::unordered_map<std::string, std::string> replies;
+    std::size_t next = 0;
+    for (; next < records.size() && records[next].kind == IpcTape::Kind::Query; ++next) {
+        replies[records[next].request] = records[next].data;
+    }
+
+    m_Window = std::make_unique<Window>(*wm);
+    m_Window->StartReplay([this] { m_FocusDirty.store(true, std::memory_order_relaxed); },
+                          [&replies](std::string_view request) -> std::optional<std::string> {
+                              auto it = replies.find(std::string(request));
+                              if (it == replies.end()) {
+                                  return std::nullopt;
+                              }
+                              return it->second;
+                          });
+
+    auto &intervals = Metrics::Instance().GetCounter(
+        "concentrate_focus_intervals_total", "Focus intervals started (focus_log inserts).");
+    const std::uint64_t intervalsBefore = intervals.value.load(std::memory_order_relaxed);
+    const std::uint64_t writesBefore = m_SQLite->GetWriteGeneration();
+
+    FocusState currentState = IDLE;
+    bool monitoringEnabledNow = true;
+    std::size_t events = 0;
+    std::size_t deadlineIterations = 0;
+    std::vector<double> latencies; // microseconds
+    latencies.reserve(records.size());
+
+    // Runs the iterations the live loop would have woken up for before `until`.
+    const auto runDeadlines = [&](Clock::time_point until) {
+        while (true) {
+            const auto deadline =
+                NextDeadline(virtualNow, currentState, monitoringEnabledNow, true).first;
+            // A deadline that is already due would not move the clock; the live loop only
+            // sees those while something outside the pipeline is pending.
+            if (deadline > until || deadline <= virtualNow) {
+                return;
+            }
+            virtualNow = deadline;
+            ++deadlineIterations;
+            RunLoopIteration(virtualNow, true, currentState, monitoringEnabledNow);
+        }
+    };
+
+    const auto wallStart = Clock::now();
+    RunLoopIteration(virtualNow, true, currentState, monitoringEnabledNow);
+    for (; next < records.size(); ++next) {
+        const IpcTape::Record &record = records[next];
+        const auto at = origin + record.at;
+        runDeadlines(at);
+        virtualNow = std::max(virtualNow, at);
+
+        if (m_Options.replaySpeed > 0) {
+            std::this_thread::sleep_until(
+                wallStart +
+                std::chrono::duration_cast<Clock::duration>(record.at) / m_Options.replaySpeed);
         }
 
-        WaitUntilNextDeadline(currentState, monitoringEnabledNow, eventDriven);
+        if (record.kind == IpcTape::Kind::Query) {
+            replies[record.request] = record.data;
+            continue;
+        }
+
+        // End to end: from the raw line entering the backend to the focus interval update.
+        const auto injected = Clock::now();
+        m_Window->ReplayEvent(record.data);
+        RunLoopIteration(virtualNow, true, currentState, monitoringEnabledNow);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - injected)
+                                .count());
+        ++events;
+    }
+
+    // Let a change held back by the settle window commit, then end the intervals with the tape.
+    runDeadlines(virtualNow + m_Options.focusSettle);
+    CloseOpenFocusInterval(virtualNow, "replay end");
+    CloseOpenMonitoringInterval(virtualNow);
+    ResetOpenFocusIntervalToIdle();
+    ResetOpenMonitoringInterval();
+    ResetLastTrackedSnapshot(IDLE);
+
+    const double wall = std::chrono::duration<double>(Clock::now() - wallStart).count();
+    const std::uint64_t writes = m_SQLite->GetWriteGeneration() - writesBefore;
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        if (latencies.empty()) {
+            return 0.0;
+        }
+        const auto index = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+        return latencies[index];
+    };
+
+    std::cout << fmt::format(
+        "Replayed {} ({}): {} events, {} replies, {:.1f} s recorded\n"
+        "Wall time: {:.3f} s, {:.0f} events/s\n"
+        "Loop iterations: {} on events, {} on deadlines\n"
+        "DB writes: {} ({:.2f} per event), focus intervals: {}\n"
+        "Event to interval update: p50 {:.1f} us, p90 {:.1f} us, p99 {:.1f} us, max {:.1f} us\n"
+        "Database: {}\n",
+        m_Options.replayPath.string(), backend, events, records.size() - events,
+        std::chrono::duration<double>(span).count(), wall,
+        wall > 0.0 ? static_cast<double>(events) / wall : 0.0, events, deadlineIterations, writes,
+        events > 0 ? static_cast<double>(writes) / static_cast<double>(events) : 0.0,
+        intervals.value.load(std::memory_order_relaxed) - intervalsBefore, percentile(0.5),
+        percentile(0.9), percentile(0.99), percentile(1.0),
+        scratchDb ? "scratch (removed)" : dbpath.string());
+
+    m_Window.reset();
+    m_SQLite.reset();
+    if (scratchDb) {
+        std::error_code ec;
+        std::filesystem::remove(dbpath, ec);
+        std::filesystem::remove(dbpath.string() + "-wal", ec);
+        std::filesystem::remove(dbpath.string() + "-shm", ec);
     }
 }
 
 // ─────────────────────────────────────
 void Concentrate::WakeScheduler() {
-    m_WakeupSeq.fetch_add(1, std::memory_order_relaxed);
-    m_SchedulerCv.notify_one();
+    m_Reactor.Wake();
 }
 
 // ─────────────────────────────────────
@@ -809,7 +1226,13 @@ double Concentrate::ToUnixTime(std::chrono::steady_clock::time_point steady_tp)
 
 // ─────────────────────────────────────
 FocusState Concentrate::AmIFocused(FocusedWindow &Fw) {
-    // If the focused window is invalid (no app_id and no title), treat as IDLE
+    // Away from the machine (logind idle/locked), or no valid focused window: IDLE
+    if (m_Idle && m_Idle->IsAway()) {
+        spdlog::debug("FOCUSED: IDLE (user away)");
+        Fw.category.clear();
+        m_CurrentLiveTaskCategory.clear();
+        return IDLE;
+    }
     if (Fw.app_id.empty() && Fw.title.empty()) {
         spdlog::debug("FOCUSED: IDLE (no app_id or title)");
         Fw.category.clear();
@@ -818,91 +1241,105 @@ FocusState Concentrate::AmIFocused(FocusedWindow &Fw) {
         return IDLE;
     }
 
-    bool isFocusedWindow = true;
+    static auto &hits = Metrics::Instance().GetCounter(
+        "concentrate_classification_cache_total", "Window classification cache lookups.",
+        Metrics::Labels({{"result", "hit"}}));
+    static auto &misses = Metrics::Instance().GetCounter(
+        "concentrate_classification_cache_total", "Window classification cache lookups.",
+        Metrics::Labels({{"result", "miss"}}));
 
-    if (!m_AllowedApps.empty() || !m_AllowedWindowTitles.empty()) {
-        isFocusedWindow = false;
+    const auto rules = m_FocusRules.load(std::memory_order_acquire);
+    ClassificationKey key{Fw.app_id, Fw.title, rules->generation};
 
-        // Check allowed apps
-        for (const auto &allowedApp : m_AllowedApps) {
-            if (Fw.app_id.find(allowedApp) != std::string::npos) {
-                isFocusedWindow = true;
-                spdlog::trace("Window matches allowed app: {}", allowedApp);
-                break;
-            }
-        }
-
-        // Check allowed titles
-        if (!isFocusedWindow && !m_AllowedWindowTitles.empty()) {
-            for (const auto &allowedTitle : m_AllowedWindowTitles) {
-                if (Fw.title.find(allowedTitle) != std::string::npos) {
-                    isFocusedWindow = true;
-                    spdlog::trace("Window matches allowed title: {}", allowedTitle);
-                    break;
-                }
-            }
-        }
+    Classification result;
+    if (const Classification *cached = m_ClassificationCache.Find(key)) {
+        hits.Inc();
+        result = *cached;
+    } else {
+        misses.Inc();
+        result = Classify(*rules, Fw);
+        m_ClassificationCache.Put(key, result);
     }
 
-    if (!isFocusedWindow) {
-        if (AmIDoingDailyActivities(Fw)) {
-            spdlog::debug("FOCUSED: DAILY ACTIVITY");
-            Fw.category = m_CurrentDailyTaskCategory;
-            m_CurrentLiveTaskCategory = Fw.category;
-            spdlog::debug("Daily activity category set: '{}'", Fw.category);
-            return FOCUSED;
-        }
+    if (result.dailyActivity) {
+        spdlog::debug("FOCUSED: DAILY ACTIVITY");
+        m_CurrentDailyTaskCategory = result.category;
+        spdlog::debug("Daily activity category set: '{}'", result.category);
+    } else {
+        m_CurrentDailyTaskCategory.clear();
     }
-
-    const std::string taskCategory =
-        m_CurrentTaskCategory.empty() ? "Uncategorized" : m_CurrentTaskCategory;
-    m_CurrentDailyTaskCategory.clear();
-    Fw.category = taskCategory;
+    Fw.category = result.category;
     m_CurrentLiveTaskCategory = Fw.category;
 
-    return isFocusedWindow ? FOCUSED : UNFOCUSED;
+    return result.state;
+}
+
+// ─────────────────────────────────────
+Concentrate::Classification Concentrate::Classify(const FocusRules &rules,
+                                                  const FocusedWindow &Fw) const {
+    // One pass over app_id and title: rule 0 is the task allow-list, 1 + i daily activity i.
+    Classification result;
+    result.rule = rules.matcher->Match(Fw.app_id, Fw.title);
+    const bool isFocusedWindow = !rules.hasAllowList || result.rule == kAllowListRule;
+
+    if (!isFocusedWindow && result.rule != RuleMatcher::kNoMatch) {
+        result.state = FOCUSED;
+        result.category = rules.activityNames[result.rule - kFirstActivityRule];
+        result.dailyActivity = true;
+        return result;
+    }
+
+    result.state = isFocusedWindow ? FOCUSED : UNFOCUSED;
+    result.category = rules.taskCategory;
+    return result;
 }
 
 // ─────────────────────────────────────
-bool Concentrate::AmIDoingDailyActivities(FocusedWindow &Fw) {
-    std::vector<DailyActivity> snapshot;
+void Concentrate::RebuildFocusRules() {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_focus_rules_compile_duration_seconds",
+        "Time to compile the allow-list and daily activities into the rule matcher.");
+    Metrics::ScopedTimer timer(timing);
+
+    // Serializes rebuilds so an older rule set can never be published over a newer one.
+    std::lock_guard<std::mutex> rebuildLock(m_FocusRulesMutex);
+
+    auto rules = std::make_shared<FocusRules>();
+    rules->generation = ++m_FocusRulesGeneration;
+    RuleMatcher::Builder builder;
     {
         std::lock_guard<std::mutex> lock(m_GlobalMutex);
-        snapshot = m_DailyActivities;
-    }
-
-    if (snapshot.empty()) {
-        return false;
-    }
-
-    for (const auto &activity : snapshot) {
-        bool matches = false;
-        for (const auto &appId : activity.appIds) {
-            if (!appId.empty() && Fw.app_id.find(appId) != std::string::npos) {
-                matches = true;
-                break;
-            }
+        rules->taskCategory =
+            m_CurrentTaskCategory.empty() ? "Uncategorized" : m_CurrentTaskCategory;
+        rules->hasAllowList = !m_AllowedApps.empty() || !m_AllowedWindowTitles.empty();
+        for (const auto &app : m_AllowedApps) {
+            builder.AddAppId(app, kAllowListRule);
+        }
+        for (const auto &title : m_AllowedWindowTitles) {
+            builder.AddTitle(title, kAllowListRule);
         }
 
-        if (!matches) {
-            for (const auto &title : activity.appTitles) {
-                if (!title.empty() && Fw.title.find(title) != std::string::npos) {
-                    matches = true;
-                    break;
+        std::uint32_t rule = kFirstActivityRule;
+        for (const auto &activity : m_DailyActivities) {
+            for (const auto &appId : activity.appIds) {
+                if (!appId.empty()) {
+                    builder.AddAppId(appId, rule);
                 }
             }
-        }
-
-        if (matches) {
-            if (!activity.name.empty()) {
-                m_CurrentDailyTaskCategory = activity.name;
-                spdlog::debug("Matched daily activity category: '{}'", m_CurrentDailyTaskCategory);
+            for (const auto &title : activity.appTitles) {
+                if (!title.empty()) {
+                    builder.AddTitle(title, rule);
+                }
             }
-            return true;
+            rules->activityNames.push_back(activity.name);
+            ++rule;
         }
     }
+    rules->matcher = builder.Build();
 
-    return false;
+    spdlog::debug("Focus rules compiled: {} patterns, {} daily activities",
+                  rules->matcher->PatternCount(), rules->activityNames.size());
+    m_FocusRules.store(std::move(rules), std::memory_order_release);
 }
 
 // ─────────────────────────────────────
@@ -947,34 +1384,73 @@ void Concentrate::RefreshDailyActivities() {
         std::lock_guard<std::mutex> lock(m_GlobalMutex);
         m_DailyActivities = std::move(updated);
     }
+    RebuildFocusRules();
 }
 
 // ─────────────────────────────────────
-void Concentrate::UpdateAllowedApps() {
-    // Update the current task from page id
-    std::string id = m_Secrets->LoadSecret("current_task_id");
-    spdlog::info("Anytype: Updating allowed apps for task ID: {}", id);
+std::optional<Concentrate::TaskRules> Concentrate::ResolveTaskRules(const std::string &id) {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_task_resolve_duration_seconds",
+        "Time to resolve the allowed apps/titles of the current task.");
+    Metrics::ScopedTimer timer(timing);
+
+    TaskRules rules;
+    rules.id = id;
+
+    // The task mirror already has everything needed but the body; only tasks it does not know yet (or a
+    // mirror that was never synced) cost a round trip to Anytype.
+    const nlohmann::json mirrored =
+        m_SQLite->FetchAnytypeTask(m_Secrets->LoadSecret("default_space_id"), id);
+    if (mirrored.is_object() && mirrored.contains("id")) {
+        for (const auto &name : mirrored.value("allowed_app_ids", nlohmann::json::array())) {
+            if (name.is_string()) {
+                rules.allowedApps.push_back(name.get<std::string>());
+            }
+        }
+        for (const auto &name : mirrored.value("allowed_titles", nlohmann::json::array())) {
+            if (name.is_string()) {
+                rules.allowedTitles.push_back(name.get<std::string>());
+            }
+        }
+        const nlohmann::json category = mirrored.value("category", nlohmann::json());
+        if (category.is_object() && category.contains("select") &&
+            category["select"].is_object() && category["select"].contains("name") &&
+            category["select"]["name"].is_string()) {
+            rules.category = category["select"]["name"].get<std::string>();
+        }
+        rules.title = mirrored.value("title", "");
+        // The task list does not carry bodies; this is the one page request a mirrored task costs.
+        if (m_Anytype->GetState() == Anytype::State::Ready) {
+            const nlohmann::json page = m_Anytype->GetPage(id);
+            if (page.contains("object") && page["object"].is_object()) {
+                rules.markdown = page["object"].value("markdown", "");
+            }
+        }
+        return rules;
+    }
 
-    if (id.empty()) {
-        spdlog::warn("Anytype: No current task ID set; skipping allowed apps update");
-        std::lock_guard<std::mutex> lock(m_GlobalMutex);
-        m_TaskTitle.clear();
-        m_AllowedApps.clear();
-        m_AllowedWindowTitles.clear();
-        return;
+    // Pages fetched recently, so switching back and forth between tasks stays instant.
+    {
+        std::lock_guard<std::mutex> lock(m_TaskPageCacheMutex);
+        if (const TaskRules *cached = m_TaskPageCache.Find(id)) {
+            if (std::chrono::steady_clock::now() - cached->resolvedAt < kTaskPageTtl) {
+                return *cached;
+            }
+            m_TaskPageCache.Erase(id);
+        }
     }
 
-    nlohmann::json currentTaskPage = m_Anytype->GetPage(id);
-    std::vector<std::string> allowedApps;
-    std::vector<std::string> allowedWindowTitles;
+    if (m_Anytype->GetState() != Anytype::State::Ready) {
+        spdlog::warn("Anytype: Task {} is not mirrored and Anytype is {}; allowed apps will be "
+                     "loaded once it is reachable",
+                     id, Anytype::StateName(m_Anytype->GetState()));
+        return std::nullopt;
+    }
 
+    nlohmann::json currentTaskPage = m_Anytype->GetPage(id);
     if (!currentTaskPage.contains("object") || !currentTaskPage["object"].is_object()) {
         spdlog::warn("Anytype: Task page is missing object data; skipping allowed apps update");
-        std::lock_guard<std::mutex> lock(m_GlobalMutex);
-        m_TaskTitle.clear();
-        m_AllowedApps.clear();
-        m_AllowedWindowTitles.clear();
-        return;
+        return std::nullopt;
     }
 
     if (currentTaskPage["object"].contains("properties") &&
@@ -990,7 +1466,7 @@ void Concentrate::UpdateAllowedApps() {
                 prop["multi_select"].is_array()) {
                 for (const auto &tag : prop["multi_select"]) {
                     if (tag.contains("name") && tag["name"].is_string()) {
-                        allowedApps.push_back(tag["name"].get<std::string>());
+                        rules.allowedApps.push_back(tag["name"].get<std::string>());
                     }
                 }
             }
@@ -999,7 +1475,7 @@ void Concentrate::UpdateAllowedApps() {
                 prop["multi_select"].is_array()) {
                 for (const auto &tag : prop["multi_select"]) {
                     if (tag.contains("name") && tag["name"].is_string()) {
-                        allowedWindowTitles.push_back(tag["name"].get<std::string>());
+                        rules.allowedTitles.push_back(tag["name"].get<std::string>());
                     }
                 }
             }
@@ -1007,50 +1483,360 @@ void Concentrate::UpdateAllowedApps() {
             if (key == "category") {
                 if (prop.contains("select") && prop["select"].is_object() &&
                     prop["select"].contains("name") && prop["select"]["name"].is_string()) {
-                    m_CurrentTaskCategory = prop["select"]["name"].get<std::string>();
-                    spdlog::info("Current category is {}", m_CurrentTaskCategory);
+                    rules.category = prop["select"]["name"].get<std::string>();
                 }
             }
         }
     }
 
+    if (currentTaskPage["object"].contains("name") &&
+        currentTaskPage["object"]["name"].is_string()) {
+        rules.title = currentTaskPage["object"]["name"].get<std::string>();
+    }
+    rules.markdown = currentTaskPage["object"].value("markdown", "");
+    rules.resolvedAt = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_TaskPageCacheMutex);
+        m_TaskPageCache.Put(id, rules);
+    }
+    return rules;
+}
+
+// ─────────────────────────────────────
+void Concentrate::ApplyTaskRules(const TaskRules *rules) {
     {
         std::lock_guard<std::mutex> lock(m_GlobalMutex);
-        if (currentTaskPage["object"].contains("name") &&
-            currentTaskPage["object"]["name"].is_string()) {
-            m_TaskTitle = currentTaskPage["object"]["name"].get<std::string>();
-        } else {
+        if (!rules) {
             m_TaskTitle.clear();
+            m_TaskId.clear();
+            m_TaskMarkdown.clear();
+            m_AllowedApps.clear();
+            m_AllowedWindowTitles.clear();
+        } else {
+
+            m_TaskTitle = rules->title;
+            m_TaskId = rules->id;
+            m_TaskMarkdown = rules->markdown;
+            m_AllowedApps = rules->allowedApps;
+            m_AllowedWindowTitles = rules->allowedTitles;
+            if (!rules->category.empty()) {
+                m_CurrentTaskCategory = rules->category;
+                spdlog::info("Current category is {}", m_CurrentTaskCategory);
+            }
+
+            spdlog::info("Anytype: Task '{}' allows {} apps and {} window titles", m_TaskTitle,
+                         m_AllowedApps.size(), m_AllowedWindowTitles.size());
         }
-        m_AllowedApps = allowedApps;
-        m_AllowedWindowTitles = allowedWindowTitles;
+    }
+    RebuildFocusRules();
 
-        spdlog::info("Anytype: Task '{}' allows {} apps and {} window titles", m_TaskTitle,
-                     m_AllowedApps.size(), m_AllowedWindowTitles.size());
+    const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
+    if (!wasDirty) {
+        WakeScheduler();
+    }
+}
+
+// ─────────────────────────────────────
+bool Concentrate::ScheduleCurrentTask(const std::string &id) {
+    {
+        std::lock_guard<std::mutex> lock(m_TaskResolveMutex);
+        // Avoid expensive Anytype calls when clients re-send the same task id.
+        // This also prevents log spam if the UI posts repeatedly.
+        if (id == m_RequestedTaskId) {
+            return false;
+        }
+        m_RequestedTaskId = id;
+        ++m_TaskRequestSeq;
+    }
+    m_TaskResolveCv.notify_one();
+    return true;
+}
+
+// ─────────────────────────────────────
+void Concentrate::RequestTaskResolve() {
+    {
+        std::lock_guard<std::mutex> lock(m_TaskResolveMutex);
+        ++m_TaskRequestSeq;
+    }
+    m_TaskResolveCv.notify_one();
+}
+
+// ─────────────────────────────────────
+void Concentrate::RunTaskResolver() {
+    std::uint64_t handled = 0;
+    std::unique_lock<std::mutex> lock(m_TaskResolveMutex);
+    while (true) {
+        m_TaskResolveCv.wait(lock,
+                             [&] { return m_TaskResolveStop || m_TaskRequestSeq != handled; });
+        if (m_TaskResolveStop) {
+            break;
+        }
+
+        const std::string id = m_RequestedTaskId;
+        handled = m_TaskRequestSeq;
+        lock.unlock();
+
+        if (!m_Secrets->SaveSecret("current_task_id", id)) {
+            spdlog::error("Failed to save current_task_id");
+        }
+        std::optional<TaskRules> rules;
+        if (id.empty()) {
+            spdlog::info("Anytype: No current task set; clearing allowed apps");
+        } else {
+            spdlog::info("Anytype: Updating allowed apps for task ID: {}", id);
+            rules = ResolveTaskRules(id);
+        }
+
+        lock.lock();
+        // Latest wins: a selection made while this one was resolving replaces it.
+        if (handled != m_TaskRequestSeq) {
+            spdlog::debug("Task {} superseded before it was applied", id);
+            continue;
+        }
+        ApplyTaskRules(rules ? &*rules : nullptr);
     }
 }
 
+// ─────────────────────────────────────
+bool Concentrate::RequireAnytype(httplib::Response &res) {
+    const auto state = m_Anytype->GetState();
+    if (state == Anytype::State::Ready) {
+        return true;
+    }
+    res.status = 503;
+    res.set_header("Retry-After", "5");
+    res.set_content(
+        nlohmann::json{{"error", std::string("Anytype is ") + Anytype::StateName(state)}}.dump(),
+        "application/json");
+    return false;
+}
+
 // ─────────────────────────────────────
 bool Concentrate::InitServer() {
-    m_Server.set_keep_alive_max_count(1);
-    m_Server.set_keep_alive_timeout(1);         // segundos
-    m_Server.set_payload_max_length(64 * 1024); // 64 KB
+    ConfigureServer(m_Server);
+    RegisterRoutes(m_Server);
+
+    const std::string host = "127.0.0.1";
+    int port = static_cast<int>(m_Port);
+    m_Thread = std::thread([this, host, port] { m_Server.listen(host, port); });
+
+    InitLocalSockets();
+    return true;
+}
+
+// ─────────────────────────────────────
+void Concentrate::InitLocalSockets() {
+    // Same API as the TCP listener plus an NDJSON command channel, both guarded by file
+    // permissions instead of being reachable by anything that can open a localhost port.
+    const char *runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    std::filesystem::path dir =
+        runtimeDir && *runtimeDir
+            ? std::filesystem::path(runtimeDir) / "concentrate"
+            : std::filesystem::path("/tmp") /
+                  ("concentrate-" + std::to_string(static_cast<unsigned long>(getuid())));
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec || ::chmod(dir.c_str(), 0700) != 0) {
+        spdlog::warn("Local sockets disabled: cannot prepare {}", dir.string());
+        return;
+    }
+
+    const std::filesystem::path apiPath = dir / "api.sock";
+    std::filesystem::remove(apiPath, ec);
+
+    ConfigureServer(m_UnixServer);
+    RegisterRoutes(m_UnixServer);
+    m_UnixServer.set_address_family(AF_UNIX);
+    if (m_UnixServer.bind_to_port(apiPath.string(), 80) &&
+        ::chmod(apiPath.c_str(), 0600) == 0) {
+        m_UnixSocketPath = apiPath;
+        m_UnixThread = std::thread([this] { m_UnixServer.listen_after_bind(); });
+        spdlog::info("API listening on unix:{}", apiPath.string());
+    } else {
+        spdlog::warn("Failed to listen on unix:{}", apiPath.string());
+        m_UnixServer.stop();
+    }
+
+    m_CommandSocket = std::make_unique<LocalCommandSocket>(
+        dir / "ctl.sock", [this](const nlohmann::json &command) { return HandleCommand(command); });
+    if (!m_CommandSocket->Start()) {
+        m_CommandSocket.reset();
+    }
+}
+
+// ─────────────────────────────────────
+nlohmann::json Concentrate::HandleCommand(const nlohmann::json &command) {
+    if (!command.is_object() || !command.contains("cmd") || !command["cmd"].is_string()) {
+        return {{"ok", false}, {"error", "missing cmd"}};
+    }
+
+    const std::string cmd = command["cmd"];
+    if (cmd == "ping") {
+        return {{"ok", true}, {"version", CONCENTRATE_VERSION}};
+    }
+    if (cmd == "special_project") {
+        if (!ApplySpecialProject(command)) {
+            return {{"ok", false}, {"error", "Missing or invalid title, focus, app_id"}};
+        }
+        return {{"ok", true}};
+    }
+    if (cmd == "current") {
+        return {{"ok", true}, {"current", CurrentFocusJson()}};
+    }
+
+    return {{"ok", false}, {"error", "unknown cmd"}};
+}
 
-    m_Server.set_read_timeout(5, 0);
-    m_Server.set_write_timeout(5, 0);
-    m_Server.set_idle_interval(1, 0);
+// ─────────────────────────────────────
+bool Concentrate::ApplySpecialProject(const nlohmann::json &j) {
+    if (!j.contains("title") || !j["title"].is_string() || !j.contains("focus") ||
+        !j["focus"].is_boolean() || !j.contains("app_id") || !j["app_id"].is_string()) {
+        return false;
+    }
+    if ((j.contains("source") && !j["source"].is_string()) ||
+        (j.contains("window_app_id") && !j["window_app_id"].is_string()) ||
+        (j.contains("ttl") && !j["ttl"].is_number())) {
+        return false;
+    }
+
+    // Clients that predate "source" share one slot, which keeps their old last-writer-wins
+    // behavior.
+    const std::string source = j.value("source", std::string("default"));
+    if (!j["focus"].get<bool>()) {
+        if (!m_Contexts.Remove(source)) {
+            return true;
+        }
+    } else {
+        auto ttl = std::chrono::duration_cast<std::chrono::seconds>(ContextRegistry::kDefaultTtl);
+        if (j.contains("ttl")) {
+            ttl = std::chrono::seconds(
+                std::clamp<long long>(j["ttl"].get<long long>(), 1, ContextRegistry::kMaxTtl.count()));
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        ContextEntry entry;
+        entry.source = source;
+        entry.app_id = j["app_id"].get<std::string>();
+        entry.title = j["title"].get<std::string>();
+        entry.window_app_id = j.value("window_app_id", std::string());
+        entry.updated_at = now;
+        entry.expires_at = now + ttl;
+        m_Contexts.Update(std::move(entry));
+    }
+
+    static auto &received = Metrics::Instance().GetCounter(
+        "concentrate_context_updates_total", "special_project updates by outcome.",
+        Metrics::Labels({{"result", "received"}}));
+    received.Inc();
+
+    // Only the first update of a burst wakes the loop (to arm the settle deadline); the rest
+    // just move the deadline and are folded into a single commit. The burst start is claimed
+    // (0 -> now, reset by the commit) and both timestamps are stored before the sequence is
+    // bumped, so a loop that sees the bump also sees when the burst started.
+    const auto nowNs = std::chrono::steady_clock::now().time_since_epoch().count();
+    m_ContextLastUpdateNs.store(nowNs, std::memory_order_release);
+    std::int64_t noBurst = 0;
+    const bool startsBurst =
+        m_ContextBurstStartNs.compare_exchange_strong(noBurst, nowNs, std::memory_order_acq_rel);
+    const auto previous = m_ContextUpdateSeq.fetch_add(1, std::memory_order_acq_rel);
+    // An update that joined a burst the loop has committed in the meantime starts a new one.
+    if (startsBurst || previous == m_ContextCommittedSeq.load(std::memory_order_acquire)) {
+        WakeScheduler();
+    }
+    return true;
+}
+
+// ─────────────────────────────────────
+std::optional<std::chrono::steady_clock::time_point> Concentrate::ContextSettleDeadline() const {
+    if (m_ContextUpdateSeq.load(std::memory_order_acquire) ==
+        m_ContextCommittedSeq.load(std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+
+    // A burst that never goes quiet (e.g. holding a key in a buffer list) still commits
+    // every few settle windows.
+    const auto settle = m_Options.contextSettle;
+    const auto lastNs = m_ContextLastUpdateNs.load(std::memory_order_acquire);
+    // 0 when the update landed while the previous burst was being committed: it starts here.
+    const auto firstNs = m_ContextBurstStartNs.load(std::memory_order_acquire);
+    const std::chrono::steady_clock::time_point last{std::chrono::steady_clock::duration(lastNs)};
+    const std::chrono::steady_clock::time_point first{
+        std::chrono::steady_clock::duration(firstNs != 0 ? firstNs : lastNs)};
+    return std::min(last + settle, first + settle * 4);
+}
+
+// ─────────────────────────────────────
+void Concentrate::CommitSettledContexts(std::chrono::steady_clock::time_point now) {
+    const auto deadline = ContextSettleDeadline();
+    if (!deadline || now < *deadline) {
+        return;
+    }
+
+    static auto &committed = Metrics::Instance().GetCounter(
+        "concentrate_context_updates_total", "special_project updates by outcome.",
+        Metrics::Labels({{"result", "committed"}}));
+    static auto &absorbed = Metrics::Instance().GetCounter(
+        "concentrate_context_updates_total", "special_project updates by outcome.",
+        Metrics::Labels({{"result", "absorbed"}}));
+
+    // Read the sequence before the snapshot: an update racing with us bumps the sequence after
+    // publishing, so it is either included here or left pending for the next commit.
+    // The burst is over once the snapshot is taken; an update from here on claims a new one.
+    const auto seq = m_ContextUpdateSeq.load(std::memory_order_acquire);
+    m_CommittedContexts = m_Contexts.Load();
+    m_ContextBurstStartNs.store(0, std::memory_order_release);
+    const auto previous = m_ContextCommittedSeq.exchange(seq, std::memory_order_acq_rel);
+
+    committed.Inc();
+    if (seq - previous > 1) {
+        absorbed.Inc(seq - previous - 1);
+    }
+}
+
+// ─────────────────────────────────────
+nlohmann::json Concentrate::CurrentFocusJson() {
+    FocusedWindow current;
+    {
+        std::lock_guard<std::mutex> lock(m_GlobalMutex);
+        current = m_Fw;
+    }
+
+    nlohmann::json j;
+    if (current.valid) {
+        j["window_id"] = current.window_id;
+        j["title"] = current.title;
+        j["app_id"] = current.app_id;
+        j["category"] = current.category;
+    }
+    return j;
+}
+
+// ─────────────────────────────────────
+void Concentrate::ConfigureServer(HttpServer &server) {
+    server.set_keep_alive_max_count(1);
+    server.set_keep_alive_timeout(1);         // segundos
+    server.set_payload_max_length(64 * 1024); // 64 KB
+
+    server.set_read_timeout(5, 0);
+    server.set_write_timeout(5, 0);
+    server.set_idle_interval(1, 0);
 
     // Cross-Origin Isolation (COOP/COEP)
     // Enables features like SharedArrayBuffer for the Web UI.
-    m_Server.set_default_headers({
+    server.set_default_headers({
         {"Cross-Origin-Opener-Policy", "same-origin"},
         {"Cross-Origin-Embedder-Policy", "require-corp"},
     });
+}
 
+// ─────────────────────────────────────
+void Concentrate::RegisterRoutes(HttpServer &server) {
     // static files
     {
         // index.html
-        m_Server.Get("/", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/", [this](const httplib::Request &, httplib::Response &res) {
             std::ifstream file(m_Root / "index.html", std::ios::binary);
             if (!file) {
                 res.status = 404;
@@ -1063,7 +1849,7 @@ bool Concentrate::InitServer() {
         });
 
         // favicon.svg
-        m_Server.Get("/favicon.svg", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/favicon.svg", [this](const httplib::Request &, httplib::Response &res) {
             std::ifstream file(m_Root / "favicon.svg", std::ios::binary);
             if (!file) {
                 res.status = 404;
@@ -1077,7 +1863,7 @@ bool Concentrate::InitServer() {
         });
 
         // style.css
-        m_Server.Get("/style.css", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/style.css", [this](const httplib::Request &, httplib::Response &res) {
             std::ifstream file(m_Root / "style.css", std::ios::binary);
             if (!file) {
                 res.status = 404;
@@ -1090,7 +1876,7 @@ bool Concentrate::InitServer() {
         });
 
         // app.js
-        m_Server.Get("/app.js", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/app.js", [this](const httplib::Request &, httplib::Response &res) {
             std::ifstream file(m_Root / "app.js", std::ios::binary);
             if (!file) {
                 res.status = 404;
@@ -1103,7 +1889,7 @@ bool Concentrate::InitServer() {
         });
 
         // main.js
-        m_Server.Get("/main.js", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/main.js", [this](const httplib::Request &, httplib::Response &res) {
             std::ifstream file(m_Root / "main.js", std::ios::binary);
             if (!file) {
                 res.status = 404;
@@ -1116,7 +1902,7 @@ bool Concentrate::InitServer() {
         });
 
         // ES module directories
-        m_Server.Get(R"(/(core|modules|views|utils|api)/.*\.js)",
+        server.Get(R"(/(core|modules|views|utils|api)/.*\.js)",
                      [this](const httplib::Request &req, httplib::Response &res) {
                          const std::string path = req.path;
                          if (path.find("..") != std::string::npos ||
@@ -1159,8 +1945,20 @@ bool Concentrate::InitServer() {
 
     // Anytype API
     {
-        m_Server.Post("/api/v1/anytype/auth/challenges",
+        server.Get("/api/v1/anytype/status",
+                   [this](const httplib::Request &, httplib::Response &res) {
+                       const auto state = m_Anytype->GetState();
+                       res.status = 200;
+                       res.set_content(
+                           nlohmann::json{{"state", Anytype::StateName(state)}}.dump(),
+                           "application/json");
+                   });
+
+        server.Post("/api/v1/anytype/auth/challenges",
                       [this](const httplib::Request &, httplib::Response &res) {
+                          if (!RequireAnytype(res)) {
+                              return;
+                          }
                           try {
                               std::string challenge_id = m_Anytype->LoginChallengeId();
                               nlohmann::json resp = {{"challenge_id", challenge_id}};
@@ -1173,13 +1971,17 @@ bool Concentrate::InitServer() {
                           }
                       });
 
-        m_Server.Post("/api/v1/anytype/auth/api_keys", [this](const httplib::Request &req,
+        server.Post("/api/v1/anytype/auth/api_keys", [this](const httplib::Request &req,
                                                               httplib::Response &res) {
+            if (!RequireAnytype(res)) {
+                return;
+            }
             try {
                 auto j = nlohmann::json::parse(req.body);
                 const std::string challenge_id = j.at("challenge_id").get<std::string>();
                 const std::string code = j.at("code").get<std::string>();
                 std::string api_key = m_Anytype->CreateApiKey(challenge_id, code);
+                m_TaskCache->Invalidate();
                 nlohmann::json resp = {{"api_key", api_key}};
                 res.status = 200;
                 res.set_content(resp.dump(), "application/json");
@@ -1190,8 +1992,11 @@ bool Concentrate::InitServer() {
             }
         });
 
-        m_Server.Get("/api/v1/anytype/spaces",
+        server.Get("/api/v1/anytype/spaces",
                      [this](const httplib::Request &, httplib::Response &res) {
+                         if (!RequireAnytype(res)) {
+                             return;
+                         }
                          try {
                              auto spaces_json = m_Anytype->GetSpaces();
                              res.status = 200;
@@ -1203,8 +2008,11 @@ bool Concentrate::InitServer() {
                          }
                      });
 
-        m_Server.Get("/api/v1/anytype/tasks_categories",
+        server.Get("/api/v1/anytype/tasks_categories",
                      [this](const httplib::Request &, httplib::Response &res) {
+                         if (!RequireAnytype(res)) {
+                             return;
+                         }
                          try {
                              auto spaces_json = m_Anytype->GetCategoriesOfTasks();
                              res.status = 200;
@@ -1216,7 +2024,7 @@ bool Concentrate::InitServer() {
                          }
                      });
 
-        m_Server.Post(
+        server.Post(
             "/api/v1/anytype/space", [this](const httplib::Request &req, httplib::Response &res) {
                 auto j = nlohmann::json::parse(req.body);
                 const std::string space_id = j.at("space_id").get<std::string>();
@@ -1226,20 +2034,36 @@ bool Concentrate::InitServer() {
                     return;
                 }
                 m_Anytype->SetDefaultSpace(space_id);
+                m_TaskCache->Invalidate();
                 res.status = 200;
                 res.set_content(R"({"status":"ok"})", "application/json");
             });
 
-        m_Server.Get(
+        server.Get(
             "/api/v1/anytype/tasks", [this](const httplib::Request &, httplib::Response &res) {
                 try {
-                    nlohmann::json tasks;
-                    {
-                        std::lock_guard<std::mutex> lock(m_GlobalMutex);
-                        tasks = m_Anytype->GetTasks();
+                    // Served from the background cache, never waiting on Anytype: until the
+                    // first snapshot exists the answer is 503 and the UI polls again.
+                    const auto snapshot = m_TaskCache->Get();
+                    if (!snapshot.tasks) {
+                        const std::string error = snapshot.lastError.empty()
+                                                      ? "Anytype tasks are still loading"
+                                                      : snapshot.lastError;
+                        res.status = snapshot.lastError.empty() ||
+                                             m_Anytype->GetState() != Anytype::State::Ready
+                                         ? 503
+                                         : 502;
+                        res.set_content(nlohmann::json{{"error", error}}.dump(),
+                                        "application/json");
+                        return;
                     }
+
+                    const auto age = std::chrono::duration_cast<std::chrono::seconds>(
+                        std::chrono::system_clock::now() - snapshot.fetchedAt);
+                    res.set_header("Age", std::to_string(age.count()));
+                    res.set_header("X-Cache", snapshot.stale ? "stale" : "fresh");
                     res.status = 200;
-                    res.set_content(tasks.dump(), "application/json");
+                    res.set_content(snapshot.tasks->dump(), "application/json");
                 } catch (const std::exception &e) {
                     res.status = 502;
                     res.set_content(std::string(R"({"error":")") + e.what() + R"("})",
@@ -1251,9 +2075,45 @@ bool Concentrate::InitServer() {
             });
     }
 
+    // Current task as last resolved (title and body); never waits on Anytype.
+    {
+        server.Get("/api/v1/anytype/current_task",
+                   [this](const httplib::Request &, httplib::Response &res) {
+                       nlohmann::json j;
+                       {
+                           std::lock_guard<std::mutex> lock(m_GlobalMutex);
+                           j = {{"id", m_TaskId},
+                                {"title", m_TaskTitle},
+                                {"markdown", m_TaskMarkdown}};
+                       }
+                       res.status = 200;
+                       res.set_content(j.dump(), "application/json");
+                   });
+    }
+
+    // Anytype task cache
+    {
+        server.Post("/api/v1/anytype/refresh",
+                    [this](const httplib::Request &, httplib::Response &res) {
+                        // Forces a full sweep in the background; the UI follows it through
+                        // the X-Cache header of /api/v1/anytype/tasks.
+                        m_TaskCache->Invalidate();
+                        res.status = 202;
+                        res.set_content(R"({"status":"refreshing"})", "application/json");
+                    });
+    }
+
+    // Metrics (Prometheus text format)
+    {
+        server.Get("/metrics", [](const httplib::Request &, httplib::Response &res) {
+            res.status = 200;
+            res.set_content(Metrics::Instance().Render(), "text/plain; version=0.0.4");
+        });
+    }
+
     // Version
     {
-        m_Server.Get("/api/v1/version", [](const httplib::Request &, httplib::Response &res) {
+        server.Get("/api/v1/version", [](const httplib::Request &, httplib::Response &res) {
             nlohmann::json j = {{"version", CONCENTRATE_VERSION}};
             res.status = 200;
             res.set_content(j.dump(), "application/json");
@@ -1262,42 +2122,31 @@ bool Concentrate::InitServer() {
 
     // Current State
     {
-        m_Server.Get("/api/v1/current", [this](const httplib::Request &, httplib::Response &res) {
-            FocusedWindow current;
-            {
-                std::lock_guard<std::mutex> lock(m_GlobalMutex);
-                current = m_Fw;
-            }
-
-            nlohmann::json j;
-            if (current.valid) {
-                j["window_id"] = current.window_id;
-                j["title"] = current.title;
-                j["app_id"] = current.app_id;
-                j["category"] = current.category;
-            }
-
+        server.Get("/api/v1/current", [this](const httplib::Request &, httplib::Response &res) {
             res.status = 200;
-            res.set_content(j.dump(), "application/json");
+            res.set_content(CurrentFocusJson().dump(), "application/json");
         });
     }
 
     // DataBase
     {
-        m_Server.Get("/api/v1/history", [&](const httplib::Request &, httplib::Response &res) {
+        server.Get("/api/v1/history", [&](const httplib::Request &req, httplib::Response &res) {
+            if (ServeIfNotModified(req, res)) {
+                return;
+            }
             nlohmann::json history = m_SQLite->FetchHistory();
             res.status = 200;
             res.set_content(history.dump(), "application/json");
         });
 
-        // m_Server.Get("/api/v1/categories", [&](const httplib::Request &, httplib::Response &res)
+        // server.Get("/api/v1/categories", [&](const httplib::Request &, httplib::Response &res)
         // {
         //     nlohmann::json categories = m_SQLite->FetchCategories();
         //     res.status = 200;
         //     res.set_content({}, "application/json");
         // });
 
-        m_Server.Get("/api/v1/events", [&](const httplib::Request &, httplib::Response &res) {
+        server.Get("/api/v1/events", [&](const httplib::Request &, httplib::Response &res) {
             nlohmann::json events = m_SQLite->FetchEvents();
             res.status = 200;
             res.set_content(events.dump(), "application/json");
@@ -1306,7 +2155,7 @@ bool Concentrate::InitServer() {
 
     // Update Server
     {
-        m_Server.Post(
+        server.Post(
             "/api/v1/task/set_current", [&](const httplib::Request &req, httplib::Response &res) {
                 try {
                     auto json_body = nlohmann::json::parse(req.body);
@@ -1318,23 +2167,15 @@ bool Concentrate::InitServer() {
                     }
                     std::string id = json_body["id"].get<std::string>();
 
-                    // Avoid expensive Anytype calls when clients re-send the same task id.
-                    // This also prevents log spam if the UI posts repeatedly.
-                    const std::string prev = m_Secrets->LoadSecret("current_task_id");
-                    if (prev == id) {
+                    // Saving the id and resolving its allowed apps happen on the resolver
+                    // thread; the new rules apply as soon as that finishes.
+                    if (!ScheduleCurrentTask(id)) {
                         res.status = 200;
                         res.set_content("Task unchanged", "text/plain");
                         return;
                     }
-
-                    m_Secrets->SaveSecret("current_task_id", id);
-                    UpdateAllowedApps();
-                    const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
-                    if (!wasDirty) {
-                        WakeScheduler();
-                    }
-                    res.status = 200;
-                    res.set_content("Task updated successfully", "text/plain");
+                    res.status = 202;
+                    res.set_content("Task update scheduled", "text/plain");
 
                 } catch (const nlohmann::json::parse_error &e) {
                     res.status = 400;
@@ -1348,7 +2189,7 @@ bool Concentrate::InitServer() {
 
     // Update focus
     {
-        m_Server.Post("/api/v1/focus/rules", [&](const httplib::Request &req,
+        server.Post("/api/v1/focus/rules", [&](const httplib::Request &req,
                                                  httplib::Response &res) {
             auto json_body = nlohmann::json::parse(req.body);
             std::vector<std::string> allowed_app_ids;
@@ -1379,6 +2220,7 @@ bool Concentrate::InitServer() {
                 m_AllowedWindowTitles = allowed_titles;
                 m_TaskTitle = task_title;
             }
+            RebuildFocusRules();
 
             const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
             if (!wasDirty) {
@@ -1388,7 +2230,7 @@ bool Concentrate::InitServer() {
             res.set_content(R"({"status":"ok"})", "application/json");
         });
 
-        m_Server.Get("/api/v1/focus/today", [&](const httplib::Request &req,
+        server.Get("/api/v1/focus/today", [&](const httplib::Request &req,
                                                 httplib::Response &res) {
             try {
                 int days = 1;
@@ -1438,7 +2280,7 @@ bool Concentrate::InitServer() {
 
     // Recurring
     {
-        m_Server.Post("/api/v1/task/recurring_tasks", [&](const httplib::Request &req,
+        server.Post("/api/v1/task/recurring_tasks", [&](const httplib::Request &req,
                                                           httplib::Response &res) {
             try {
                 if (req.body.empty()) {
@@ -1498,7 +2340,7 @@ bool Concentrate::InitServer() {
             }
         });
 
-        m_Server.Get(
+        server.Get(
             "/api/v1/task/recurring_tasks", [&](const httplib::Request &, httplib::Response &res) {
                 try {
                     const auto now = std::chrono::steady_clock::now();
@@ -1529,7 +2371,7 @@ bool Concentrate::InitServer() {
                 }
             });
 
-        m_Server.Delete("/api/v1/task/recurring_tasks",
+        server.Delete("/api/v1/task/recurring_tasks",
                         [&](const httplib::Request &req, httplib::Response &res) {
                             try {
                                 auto nameIt = req.params.find("name");
@@ -1560,14 +2402,14 @@ bool Concentrate::InitServer() {
 
     // Monitoring
     {
-        m_Server.Get("/api/v1/monitoring",
+        server.Get("/api/v1/monitoring",
                      [this](const httplib::Request &, httplib::Response &res) {
                          nlohmann::json j = {{"enabled", m_MonitoringEnabled.load()}};
                          res.status = 200;
                          res.set_content(j.dump(), "application/json");
                      });
 
-        m_Server.Post(
+        server.Post(
             "/api/v1/monitoring", [this](const httplib::Request &req, httplib::Response &res) {
                 try {
                     auto j = nlohmann::json::parse(req.body);
@@ -1595,7 +2437,7 @@ bool Concentrate::InitServer() {
                 }
             });
 
-        m_Server.Get(
+        server.Get(
             "/api/v1/monitoring/summary", [this](const httplib::Request &, httplib::Response &res) {
                 try {
                     if (!m_SQLite) {
@@ -1613,7 +2455,7 @@ bool Concentrate::InitServer() {
                 }
             });
 
-        m_Server.Get(
+        server.Get(
             "/api/v1/hydration/summary", [this](const httplib::Request &, httplib::Response &res) {
                 try {
                     if (!m_SQLite) {
@@ -1634,7 +2476,7 @@ bool Concentrate::InitServer() {
 
     // Settings
     {
-        m_Server.Get("/api/v1/settings", [this](const httplib::Request &, httplib::Response &res) {
+        server.Get("/api/v1/settings", [this](const httplib::Request &, httplib::Response &res) {
             spdlog::info("[SERVER] Get Settings");
             std::string current_task_id = m_Secrets->LoadSecret("current_task_id");
             nlohmann::json j = {{"monitoring_enabled", m_MonitoringEnabled.load()},
@@ -1646,7 +2488,7 @@ bool Concentrate::InitServer() {
 
     // Pomodoro
     {
-        m_Server.Get(
+        server.Get(
             "/api/v1/pomodoro/state", [this](const httplib::Request &, httplib::Response &res) {
                 try {
                     if (!m_SQLite) {
@@ -1664,7 +2506,7 @@ bool Concentrate::InitServer() {
                 }
             });
 
-        m_Server.Post("/api/v1/pomodoro/state", [this](const httplib::Request &req,
+        server.Post("/api/v1/pomodoro/state", [this](const httplib::Request &req,
                                                        httplib::Response &res) {
             try {
                 if (!m_SQLite) {
@@ -1699,7 +2541,7 @@ bool Concentrate::InitServer() {
             }
         });
 
-        m_Server.Get(
+        server.Get(
             "/api/v1/pomodoro/today", [this](const httplib::Request &, httplib::Response &res) {
                 try {
                     if (!m_SQLite) {
@@ -1721,7 +2563,7 @@ bool Concentrate::InitServer() {
             });
 
         // Call this when a focus block finishes (increments daily count and total focus seconds)
-        m_Server.Post("/api/v1/pomodoro/focus/complete", [this](const httplib::Request &req,
+        server.Post("/api/v1/pomodoro/focus/complete", [this](const httplib::Request &req,
                                                                 httplib::Response &res) {
             try {
                 if (!m_SQLite) {
@@ -1764,7 +2606,7 @@ bool Concentrate::InitServer() {
 
     // Update focus
     {
-        m_Server.Post("/api/v1/focus/rules", [&](const httplib::Request &req,
+        server.Post("/api/v1/focus/rules", [&](const httplib::Request &req,
                                                  httplib::Response &res) {
             auto json_body = nlohmann::json::parse(req.body);
             std::vector<std::string> allowed_app_ids;
@@ -1795,6 +2637,7 @@ bool Concentrate::InitServer() {
                 m_AllowedWindowTitles = allowed_titles;
                 m_TaskTitle = task_title;
             }
+            RebuildFocusRules();
 
             const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
             if (!wasDirty) {
@@ -1804,7 +2647,7 @@ bool Concentrate::InitServer() {
             res.set_content(R"({"status":"ok"})", "application/json");
         });
 
-        m_Server.Get("/api/v1/focus/today", [&](const httplib::Request &req,
+        server.Get("/api/v1/focus/today", [&](const httplib::Request &req,
                                                 httplib::Response &res) {
             try {
                 int days = 1;
@@ -1834,7 +2677,7 @@ bool Concentrate::InitServer() {
 
     // Get History
     {
-        m_Server.Get("/api/v1/history/category-time",
+        server.Get("/api/v1/history/category-time",
                      [&](const httplib::Request &req, httplib::Response &res) {
                          try {
                              int days = 30;
@@ -1848,6 +2691,10 @@ bool Concentrate::InitServer() {
                                  }
                              }
 
+                             if (ServeIfNotModified(req, res)) {
+                                 return;
+                             }
+
                              nlohmann::json summary = m_SQLite->GetCategoryTimeSummary(days);
                              res.status = 200;
                              res.set_content(summary.dump(), "application/json");
@@ -1858,7 +2705,7 @@ bool Concentrate::InitServer() {
                          }
                      });
 
-        m_Server.Get("/api/v1/history/category-focus",
+        server.Get("/api/v1/history/category-focus",
                      [&](const httplib::Request &req, httplib::Response &res) {
                          try {
                              int days = 30;
@@ -1872,6 +2719,10 @@ bool Concentrate::InitServer() {
                                  }
                              }
 
+                             if (ServeIfNotModified(req, res)) {
+                                 return;
+                             }
+
                              nlohmann::json summary = m_SQLite->GetCategoryFocusSplit(days);
                              res.status = 200;
                              res.set_content(summary.dump(), "application/json");
@@ -1882,7 +2733,7 @@ bool Concentrate::InitServer() {
                          }
                      });
 
-        m_Server.Get("/api/v1/focus/category-percentages",
+        server.Get("/api/v1/focus/category-percentages",
                      [&](const httplib::Request &req, httplib::Response &res) {
                          try {
                              int days = 1;
@@ -1890,6 +2741,10 @@ bool Concentrate::InitServer() {
                                  days = std::stoi(req.get_param_value("days"));
                              }
 
+                             if (ServeIfNotModified(req, res)) {
+                                 return;
+                             }
+
                              nlohmann::json summary = m_SQLite->GetFocusPercentageByCategory(days);
 
                              res.status = 200;
@@ -1903,7 +2758,7 @@ bool Concentrate::InitServer() {
                      });
 
         // Today Category Summary
-        m_Server.Get("/api/v1/focus/today/categories",
+        server.Get("/api/v1/focus/today/categories",
                      [&](const httplib::Request &, httplib::Response &res) {
                          try {
                              nlohmann::json summary = m_SQLite->GetTodayFocusTimeSummary();
@@ -1916,7 +2771,7 @@ bool Concentrate::InitServer() {
                          }
                      });
 
-        m_Server.Get("/api/v1/focus/app-usage", [&](const httplib::Request &req,
+        server.Get("/api/v1/focus/app-usage", [&](const httplib::Request &req,
                                                     httplib::Response &res) {
             try {
                 int days = 1;
@@ -1930,6 +2785,9 @@ bool Concentrate::InitServer() {
                         }
                     }
                 }
+                if (ServeIfNotModified(req, res)) {
+                    return;
+                }
                 nlohmann::json data = m_SQLite->FetchDailyAppUsageByAppId(days);
                 res.status = 200;
                 res.set_content(data.dump(), "application/json");
@@ -1941,7 +2799,7 @@ bool Concentrate::InitServer() {
             }
         });
 
-        m_Server.Get("/api/v1/daily_activities/today",
+        server.Get("/api/v1/daily_activities/today",
                      [&](const httplib::Request &, httplib::Response &res) {
                          try {
                              nlohmann::json summary = m_SQLite->GetTodayDailyActivitiesSummary();
@@ -1957,8 +2815,31 @@ bool Concentrate::InitServer() {
 
     // Special End Points
     {
+        // Live integration overrides, for debugging extensions and editor plugins.
+        server.Get("/api/v1/context", [this](const httplib::Request &, httplib::Response &res) {
+            const auto now = std::chrono::steady_clock::now();
+            nlohmann::json out = nlohmann::json::array();
+            for (const auto &e : *m_Contexts.Load()) {
+                if (e.expires_at <= now) {
+                    continue;
+                }
+                out.push_back({
+                    {"source", e.source},
+                    {"app_id", e.app_id},
+                    {"title", e.title},
+                    {"window_app_id", e.window_app_id},
+                    {"age_seconds",
+                     std::chrono::duration_cast<std::chrono::seconds>(now - e.updated_at).count()},
+                    {"expires_in_seconds",
+                     std::chrono::duration_cast<std::chrono::seconds>(e.expires_at - now).count()},
+                });
+            }
+            res.status = 200;
+            res.set_content(out.dump(), "application/json");
+        });
+
         // CORS preflight for browser-based clients (including extensions).
-        m_Server.Options("/api/v1/special_project",
+        server.Options("/api/v1/special_project",
                          [](const httplib::Request &, httplib::Response &res) {
                              res.set_header("Access-Control-Allow-Origin", "*");
                              res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
@@ -1967,7 +2848,7 @@ bool Concentrate::InitServer() {
                              res.status = 204;
                          });
 
-        m_Server.Post("/api/v1/special_project", [this](const httplib::Request &req,
+        server.Post("/api/v1/special_project", [this](const httplib::Request &req,
                                                         httplib::Response &res) {
             // CORS for actual request (also set on error responses).
             res.set_header("Access-Control-Allow-Origin", "*");
@@ -1977,32 +2858,14 @@ bool Concentrate::InitServer() {
             try {
                 auto j = nlohmann::json::parse(req.body);
 
-                // Extract project name
-                if (!j.contains("title") || !j["title"].is_string() || !j.contains("focus") ||
-                    !j["focus"].is_boolean() || !j.contains("app_id") || !j["app_id"].is_string()
-
-                ) {
+                if (!ApplySpecialProject(j)) {
                     res.status = 400; // Bad request
                     res.set_content(R"({"error":"Missing or invalid title, status,  app_id"})",
                                     "application/json");
                     return;
                 }
 
-                std::string appId = j["app_id"];
-                std::string projectName = j["title"];
-                bool focus = j["focus"];
-
-                if (focus) {
-                    m_SpecialProjectFocused = true;
-                } else {
-                    m_SpecialProjectFocused = false;
-                }
-                m_SpecialProjectTitle = projectName;
-                m_SpecialAppId = appId;
-                const bool wasDirty = m_FocusDirty.exchange(true, std::memory_order_relaxed);
-                if (!wasDirty) {
-                    WakeScheduler();
-                }
+                const std::string projectName = j["title"];
                 nlohmann::json response = {{"status", "ok"}, {"project_name", projectName}};
                 res.status = 200;
                 res.set_content(response.dump(), "application/json");
@@ -2013,12 +2876,43 @@ bool Concentrate::InitServer() {
             }
         });
     }
+}
 
-    // clang-format on
-    const std::string host = "127.0.0.1";
-    int port = static_cast<int>(m_Port);
-    m_Thread = std::thread([this, host, port] { m_Server.listen(host, port); });
-    return true;
+// ─────────────────────────────────────
+bool Concentrate::ServeIfNotModified(const httplib::Request &req, httplib::Response &res) {
+    // Analytics only change when something is written or when the local day rolls over
+    // (all "days" windows are anchored at local midnight), so that pair plus the process and
+    // request identity is enough to validate a cached response without running the query.
+    const std::time_t t = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&t, &local);
+    const int day = (local.tm_year + 1900) * 1000 + local.tm_yday;
+
+    std::string identity = req.path;
+    for (const auto &[key, value] : req.params) {
+        identity += '&';
+        identity += key;
+        identity += '=';
+        identity += value;
+    }
+
+    const std::string etag =
+        fmt::format("W/\"{:x}-{:x}-{}-{:x}\"", m_BootId, m_SQLite->GetWriteGeneration(), day,
+                    std::hash<std::string>{}(identity));
+
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+
+    if (!req.has_header("If-None-Match")) {
+        return false;
+    }
+
+    const std::string inm = req.get_header_value("If-None-Match");
+    if (inm == "*" || inm.find(etag) != std::string::npos) {
+        res.status = 304;
+        return true;
+    }
+    return false;
 }
 
 // ─────────────────────────────────────
@@ -2050,6 +2944,16 @@ std::filesystem::path Concentrate::GetBinaryPath() {
     return binDir;
 }
 
+// ─────────────────────────────────────
+std::filesystem::path Concentrate::GetConfigDir() {
+    const char *xdgConfigHome = std::getenv("XDG_CONFIG_HOME");
+    if (xdgConfigHome && *xdgConfigHome) {
+        return std::filesystem::path(xdgConfigHome) / "concentrate";
+    }
+    const char *home = std::getenv("HOME");
+    return std::filesystem::path(home && *home ? home : ".") / ".config" / "concentrate";
+}
+
 // ─────────────────────────────────────
 std::filesystem::path Concentrate::GetDBPath() {
     const char *xdgDataHome = std::getenv("XDG_DATA_HOME");
@@ -20,6 +20,17 @@
 #include "sqlite.hpp"
 #include "hydration.hpp"
 #include "tray.hpp"
+#include "httpserver.hpp"
+#include "localsocket.hpp"
+#include "context.hpp"
+#include "taskcache.hpp"
+#include "metrics.hpp"
+#include "lrucache.hpp"
+#include "rulematcher.hpp"
+#include "reactor.hpp"
+#include "idlemonitor.hpp"
+#include "titlecanon.hpp"
+#include "ipctape.hpp"
 
 #include "common.hpp"
 
@@ -29,23 +40,62 @@
 
 class Concentrate {
   public:
-    Concentrate(const unsigned port, const unsigned ping, LogLevel log_level);
+    explicit Concentrate(const RuntimeOptions &options);
     ~Concentrate();
 
   private:
     std::filesystem::path GetBinaryPath();
     std::filesystem::path GetDBPath();
-    void UpdateAllowedApps();
+    std::filesystem::path GetConfigDir();
+    struct TaskRules {
+        std::string id;
+        std::string title;
+        std::string markdown; // task body; empty when Anytype could not be reached
+        std::string category;
+        std::vector<std::string> allowedApps;
+        std::vector<std::string> allowedTitles;
+        std::chrono::steady_clock::time_point resolvedAt{};
+    };
+
+    std::optional<TaskRules> ResolveTaskRules(const std::string &id);
+    // Publishes title, allow-lists and category together; nullptr clears them.
+    void ApplyTaskRules(const TaskRules *rules);
+    // Queues `id` for the resolver thread. Returns false when it is already the current task.
+    bool ScheduleCurrentTask(const std::string &id);
+    // Asks the resolver thread to resolve the current task again (startup, Anytype back).
+    void RequestTaskResolve();
+    void RunTaskResolver();
+    // Answers 503 and returns false while the Anytype API is not reachable.
+    bool RequireAnytype(httplib::Response &res);
     void RefreshDailyActivities();
     bool InitServer();
+    void ConfigureServer(HttpServer &server);
+    void RegisterRoutes(HttpServer &server);
+    void InitLocalSockets();
+    nlohmann::json HandleCommand(const nlohmann::json &command);
+    bool ApplySpecialProject(const nlohmann::json &j);
+    nlohmann::json CurrentFocusJson();
+    bool ServeIfNotModified(const httplib::Request &req, httplib::Response &res);
     FocusState AmIFocused(FocusedWindow &Fw);
-    bool AmIDoingDailyActivities(FocusedWindow &Fw);
+    // Recompiles m_FocusRules; call after changing the allow-list or the daily activities.
+    void RebuildFocusRules();
+    struct FocusRules;
+    struct Classification;
+    Classification Classify(const FocusRules &rules, const FocusedWindow &Fw) const;
+    // Title as recorded in focus_log, see TitleCanonicalizer. Main loop only.
+    const std::string &CanonicalTitle(const std::string &appId, const std::string &title);
     double ToUnixTime(std::chrono::steady_clock::time_point steady_tp);
     void WakeScheduler();
 
     // Main loop (split into small, testable-ish pieces)
-    void InitLoopState();
+    void InitLoopState(std::chrono::steady_clock::time_point now);
     void RunMainLoop();
+    // One pass of the tracking pipeline at `now`; reports the state the next wait depends on.
+    // Returns true when the loop should exit.
+    bool RunLoopIteration(std::chrono::steady_clock::time_point now, bool eventDriven,
+                          FocusState &currentState, bool &monitoringEnabledNow);
+    // Feeds m_Options.replayPath through the pipeline on a virtual clock and prints a report.
+    void RunReplay();
     void RefreshFocusSnapshotIfNeeded(std::chrono::steady_clock::time_point now, bool eventDriven);
     FocusedWindow LoadFocusedWindowSnapshot();
     FocusState ComputeFocusStateAndPersist(FocusedWindow &fw_local);
@@ -64,15 +114,47 @@ class Concentrate {
     void EnsureTaskCategory();
     void UpdateClimateIfDue(std::chrono::steady_clock::time_point now);
     void UpdateHydrationIfDue(std::chrono::steady_clock::time_point now, FocusState currentState);
+    // Holds a focus change back until it has lasted m_Options.focusSettle; until then `state`
+    // and `fw` are replaced by the open interval, so shorter blips fold into it. Returns when
+    // the change being committed started (`now` when nothing is held).
+    std::chrono::steady_clock::time_point SettleFocusChange(std::chrono::steady_clock::time_point now,
+                                                           FocusState &state, FocusedWindow &fw);
+    // `fw_local.title` is canonical; a change closes the open interval at `changedAt`.
     void UpdateFocusInterval(std::chrono::steady_clock::time_point now, FocusState currentState,
-                             const FocusedWindow &fw_local);
+                             const FocusedWindow &fw_local,
+                             std::chrono::steady_clock::time_point changedAt);
     void PublishLastTrackedIntervalSnapshot();
-    bool UpdateTray(std::chrono::steady_clock::time_point now, FocusState iconState,
-                    bool eventDriven);
-    bool PumpTrayIfDue(std::chrono::steady_clock::time_point now, bool eventDriven);
+    bool UpdateTray(FocusState iconState);
+    bool HandleTrayRequests();
+    // What woke the main loop: the deadline that fired, or a notify.
+    enum class WakeCause {
+        MaxSleep,
+        ContextExpiry,
+        ContextSettle,
+        FocusPoll,
+        SafetyPoll,
+        Hydration,
+        Climate,
+        MonitoringReminder,
+        FocusSettle,
+        DbFlush,
+        MonitoringFlush,
+        UnfocusedWarning,
+        Notify,
+        Count
+    };
+    static const char *WakeCauseName(WakeCause cause);
+    // Earliest time the loop has work to do, and what it is (for the wakeup metrics).
+    std::pair<std::chrono::steady_clock::time_point, WakeCause>
+    NextDeadline(std::chrono::steady_clock::time_point now, FocusState currentState,
+                 bool monitoringEnabledNow, bool eventDriven) const;
     void WaitUntilNextDeadline(FocusState currentState, bool monitoringEnabledNow, bool eventDriven);
+    void CountLoopWakeup(WakeCause cause);
+    void CommitSettledContexts(std::chrono::steady_clock::time_point now);
+    std::optional<std::chrono::steady_clock::time_point> ContextSettleDeadline() const;
 
   private:
+    const RuntimeOptions m_Options;
     const unsigned m_Port;
     const unsigned m_Ping;
     std::filesystem::path m_Root;
@@ -84,35 +166,51 @@ class Concentrate {
     nlohmann::json m_RecurringTasksCache = nlohmann::json::array();
     std::unordered_map<int, std::pair<std::chrono::steady_clock::time_point, nlohmann::json>>
       m_FocusSummaryCache;
+    // Part of every analytics ETag: the write generation restarts at 0 with each process, so
+    // without it a tag cached before a restart could match different data.
+    const std::uint64_t m_BootId =
+        (std::uint64_t{std::random_device{}()} << 32) | std::random_device{}();
 
     // Event-driven focus tracking (Niri IPC stream)
     std::atomic<bool> m_FocusDirty{true};
     std::atomic<bool> m_EventDriven{false};
 
-    // Scheduler: wait-until-next-deadline with reliable wakeups
-    std::mutex m_SchedulerMutex;
-    std::condition_variable m_SchedulerCv;
-    std::atomic<std::uint64_t> m_WakeupSeq{0};
+    // Scheduler: the main loop waits in the reactor until the next deadline or a wakeup. Declared
+    // before the parts below, which register with it and must be destroyed first.
+    Reactor m_Reactor;
     std::atomic<bool> m_ShutdownRequested{false};
+    std::chrono::steady_clock::time_point m_LoopIterationStart{};
+
+    // --record; outlives m_Window, which writes to it.
+    std::unique_ptr<IpcTape::Recorder> m_Tape;
 
     // Parts
     std::unique_ptr<Anytype> m_Anytype;
+    std::unique_ptr<AnytypeTaskCache> m_TaskCache;
     std::unique_ptr<Window> m_Window;
     std::unique_ptr<Secrets> m_Secrets;
     std::unique_ptr<Notification> m_Notification;
     std::unique_ptr<SQLite> m_SQLite;
     std::unique_ptr<HydrationService> m_Hydration;
     std::unique_ptr<TrayIcon> m_Tray;
+    std::unique_ptr<IdleMonitor> m_Idle;
 
     // Server
     std::thread m_Thread;
-    httplib::Server m_Server;
+    HttpServer m_Server;
+    std::thread m_UnixThread;
+    HttpServer m_UnixServer;
+    std::filesystem::path m_UnixSocketPath;
+    std::unique_ptr<LocalCommandSocket> m_CommandSocket;
     std::string m_IndexHtml;
     std::string m_AppJs;
     FocusedWindow m_Fw;
+    FocusedWindow m_WindowFw;
 
     // Window
     std::string m_TaskTitle;
+    std::string m_TaskId;
+    std::string m_TaskMarkdown;
     FocusState m_CurrentState{IDLE};
 
     // Current Task
@@ -122,6 +220,18 @@ class Concentrate {
     std::string m_CurrentDailyTaskCategory;
     std::string m_CurrentLiveTaskCategory;
 
+    // Current task resolution, off the request thread; the latest selection wins.
+    std::mutex m_TaskResolveMutex;
+    std::condition_variable m_TaskResolveCv;
+    std::string m_RequestedTaskId;
+    std::uint64_t m_TaskRequestSeq = 0;
+    bool m_TaskResolveStop = false;
+    std::thread m_TaskResolveThread;
+
+    static constexpr std::chrono::minutes kTaskPageTtl{10};
+    std::mutex m_TaskPageCacheMutex;
+    LruCache<std::string, TaskRules> m_TaskPageCache{32};
+
     struct DailyActivity {
       std::string name;
       std::vector<std::string> appIds;
@@ -130,10 +240,63 @@ class Concentrate {
 
     std::vector<DailyActivity> m_DailyActivities;
 
+    // m_AllowedApps, m_AllowedWindowTitles and m_DailyActivities compiled for AmIFocused.
+    struct FocusRules {
+        std::uint64_t generation = 0;
+        std::shared_ptr<const RuleMatcher> matcher = RuleMatcher::Builder().Build();
+        bool hasAllowList = false;
+        std::string taskCategory;
+        std::vector<std::string> activityNames; // rule kFirstActivityRule + i
+    };
+    static constexpr std::uint32_t kAllowListRule = 0;
+    static constexpr std::uint32_t kFirstActivityRule = 1;
+    std::mutex m_FocusRulesMutex;
+    std::uint64_t m_FocusRulesGeneration = 0; // guarded by m_FocusRulesMutex
+    std::atomic<std::shared_ptr<const FocusRules>> m_FocusRules; // set in the constructor
+
+    // Classification results per window under a given rule set. The same few windows are
+    // re-classified on every loop iteration, so the steady state is a hash lookup. Main loop
+    // only.
+    struct Classification {
+        FocusState state = UNFOCUSED;
+        std::string category;
+        std::uint32_t rule = RuleMatcher::kNoMatch;
+        bool dailyActivity = false;
+    };
+    struct ClassificationKey {
+        std::string appId;
+        std::string title;
+        std::uint64_t generation = 0;
+        bool operator==(const ClassificationKey &) const = default;
+    };
+    struct ClassificationKeyHash {
+        std::size_t operator()(const ClassificationKey &key) const {
+            std::size_t h = std::hash<std::string>{}(key.appId);
+            h ^= std::hash<std::string>{}(key.title) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= std::hash<std::uint64_t>{}(key.generation) + 0x9e3779b97f4a7c15ULL + (h << 6) +
+                 (h >> 2);
+            return h;
+        }
+    };
+    LruCache<ClassificationKey, Classification, ClassificationKeyHash> m_ClassificationCache{64};
+
+    // Title canonicalization ($XDG_CONFIG_HOME/concentrate/titles.json), with the last result
+    // memoized: the loop sees the same window on most iterations. Main loop only.
+    std::unique_ptr<const TitleCanonicalizer> m_TitleCanon;
+    std::string m_CanonAppId;
+    std::string m_CanonRawTitle;
+    std::string m_CanonTitle;
+
     // Special API (When wayland info is not enough)
-    std::string m_SpecialProjectTitle;
-    std::string m_SpecialAppId;
-    bool m_SpecialProjectFocused = false;
+    // Updates land in m_Contexts right away; the main loop only adopts them once a burst has
+    // been quiet for the settle window (or has lasted too long), see CommitSettledContexts().
+    ContextRegistry m_Contexts;
+    std::shared_ptr<const ContextRegistry::Snapshot> m_CommittedContexts =
+        std::make_shared<const ContextRegistry::Snapshot>();
+    std::atomic<std::uint64_t> m_ContextUpdateSeq{0};
+    std::atomic<std::uint64_t> m_ContextCommittedSeq{0};
+    std::atomic<std::int64_t> m_ContextBurstStartNs{0};
+    std::atomic<std::int64_t> m_ContextLastUpdateNs{0};
 
     // Monitoring Notification
     std::chrono::system_clock m_LastMonitoringDisabledNotification;
@@ -169,6 +332,14 @@ class Concentrate {
     std::string m_OpenTitle;
     std::string m_OpenCategory;
 
+    // Tracking: focus change waiting out the settle window
+    bool m_HasPendingFocus{false};
+    FocusState m_PendingState{IDLE};
+    std::string m_PendingAppId;
+    std::string m_PendingTitle;
+    std::string m_PendingCategory;
+    std::chrono::steady_clock::time_point m_PendingSince{};
+
     // Tracking: open monitoring interval
     bool m_HasOpenMonitoringInterval{false};
     MonitoringState m_OpenMonitoringState{MONITORING_ENABLE};
@@ -183,9 +354,6 @@ class Concentrate {
     // Focus refresh timing
     std::chrono::steady_clock::time_point m_LastFocusQueryAt{};
 
-    // Tray polling schedule
-    std::chrono::steady_clock::time_point m_NextTrayPollAt{};
-
     static constexpr std::chrono::seconds kSafetyPollEvery{30};
     static constexpr std::chrono::seconds kUnfocusedWarnEvery{15};
     static constexpr std::chrono::seconds kDbFlushEvery{15};
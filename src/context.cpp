@@ -0,0 +1,102 @@
+#include "context.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+// ─────────────────────────────────────
+ContextRegistry::ContextRegistry() : m_Snapshot(std::make_shared<const Snapshot>()) {}
+
+// ─────────────────────────────────────
+void ContextRegistry::Update(ContextEntry entry) {
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    const auto current = m_Snapshot.load(std::memory_order_acquire);
+
+    auto next = std::make_shared<Snapshot>();
+    next->reserve(current->size() + 1);
+    for (const auto &e : *current) {
+        // Expired entries are dropped here rather than by a timer.
+        if (e.source != entry.source && e.expires_at > entry.updated_at) {
+            next->push_back(e);
+        }
+    }
+    next->push_back(std::move(entry));
+
+    m_Snapshot.store(std::move(next), std::memory_order_release);
+}
+
+// ─────────────────────────────────────
+bool ContextRegistry::Remove(std::string_view source) {
+    std::lock_guard<std::mutex> lock(m_WriteMutex);
+    const auto current = m_Snapshot.load(std::memory_order_acquire);
+
+    auto next = std::make_shared<Snapshot>();
+    for (const auto &e : *current) {
+        if (e.source != source) {
+            next->push_back(e);
+        }
+    }
+    if (next->size() == current->size()) {
+        return false;
+    }
+
+    m_Snapshot.store(std::move(next), std::memory_order_release);
+    return true;
+}
+
+// ─────────────────────────────────────
+std::shared_ptr<const ContextRegistry::Snapshot> ContextRegistry::Load() const {
+    return m_Snapshot.load(std::memory_order_acquire);
+}
+
+// ─────────────────────────────────────
+std::optional<ContextEntry>
+ContextRegistry::Select(const Snapshot &snapshot, std::string_view focusedAppId,
+                        std::chrono::steady_clock::time_point now) {
+    const ContextEntry *bound = nullptr;
+    const ContextEntry *unbound = nullptr;
+    for (const auto &e : snapshot) {
+        if (e.expires_at <= now) {
+            continue;
+        }
+
+        const ContextEntry *&slot =
+            e.window_app_id.empty() || focusedAppId.empty() ? unbound : bound;
+        if (!e.window_app_id.empty() && !focusedAppId.empty() &&
+            !MatchesWindow(e.window_app_id, focusedAppId)) {
+            continue;
+        }
+        if (!slot || e.updated_at > slot->updated_at) {
+            slot = &e;
+        }
+    }
+
+    if (bound) {
+        return *bound;
+    }
+    if (unbound) {
+        return *unbound;
+    }
+    return std::nullopt;
+}
+
+// ─────────────────────────────────────
+std::optional<std::chrono::steady_clock::time_point>
+ContextRegistry::NextExpiry(const Snapshot &snapshot, std::chrono::steady_clock::time_point now) {
+    std::optional<std::chrono::steady_clock::time_point> next;
+    for (const auto &e : snapshot) {
+        if (e.expires_at > now && (!next || e.expires_at < *next)) {
+            next = e.expires_at;
+        }
+    }
+    return next;
+}
+
+// ─────────────────────────────────────
+bool ContextRegistry::MatchesWindow(std::string_view windowAppId, std::string_view focusedAppId) {
+    const auto it = std::search(focusedAppId.begin(), focusedAppId.end(), windowAppId.begin(),
+                                windowAppId.end(), [](char a, char b) {
+                                    return std::tolower(static_cast<unsigned char>(a)) ==
+                                           std::tolower(static_cast<unsigned char>(b));
+                                });
+    return it != focusedAppId.end();
+}
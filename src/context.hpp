@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Focus overrides pushed by integrations (browser extensions, editors) through
+// /api/v1/special_project or the command socket.
+//
+// Every integration owns one entry keyed by its source id and keeps it alive with heartbeats;
+// entries that are not refreshed within their TTL are ignored. Writers rebuild an immutable
+// snapshot under a mutex and publish it atomically, so the main loop reads it without locking.
+struct ContextEntry {
+    std::string source;
+    std::string app_id;
+    std::string title;
+    // Compositor app_id this context belongs to (case-insensitive substring, e.g. "firefox").
+    // Empty means the override applies whatever window is focused.
+    std::string window_app_id;
+    std::chrono::steady_clock::time_point updated_at;
+    std::chrono::steady_clock::time_point expires_at;
+};
+
+class ContextRegistry {
+  public:
+    using Snapshot = std::vector<ContextEntry>;
+
+    static constexpr std::chrono::seconds kDefaultTtl{300};
+    static constexpr std::chrono::seconds kMaxTtl{3600};
+
+    ContextRegistry();
+
+    // Inserts or replaces the entry of `entry.source`.
+    void Update(ContextEntry entry);
+    // Drops the entry of `source` (the integration lost focus). Returns whether it existed.
+    bool Remove(std::string_view source);
+
+    std::shared_ptr<const Snapshot> Load() const;
+
+    // Picks the override for the focused compositor window: entries bound to a matching
+    // window_app_id first, then unbound ones; most recently updated wins within each group.
+    // With no focused app_id known, the most recent live entry wins.
+    static std::optional<ContextEntry> Select(const Snapshot &snapshot,
+                                              std::string_view focusedAppId,
+                                              std::chrono::steady_clock::time_point now);
+
+    // Earliest expiry among live entries, so the scheduler can wake when an override lapses.
+    static std::optional<std::chrono::steady_clock::time_point>
+    NextExpiry(const Snapshot &snapshot, std::chrono::steady_clock::time_point now);
+
+  private:
+    static bool MatchesWindow(std::string_view windowAppId, std::string_view focusedAppId);
+
+    std::mutex m_WriteMutex;
+    std::atomic<std::shared_ptr<const Snapshot>> m_Snapshot;
+};
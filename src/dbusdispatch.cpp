@@ -0,0 +1,276 @@
+#include "dbusdispatch.hpp"
+#include "reactor.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+
+namespace {
+
+// ─────────────────────────────────────
+struct Binding : std::enable_shared_from_this<Binding> {
+    Reactor *reactor = nullptr;
+    DBusConnection *conn = nullptr;
+    int refs = 0;
+
+    std::mutex mutex;
+    std::unordered_map<int, std::vector<DBusWatch *>> watches; // several watches may share an fd
+    std::unordered_map<DBusTimeout *, Reactor::TimerId> timeouts;
+
+    void UpdateFd(int fd);
+    void HandleFd(int fd, std::uint32_t events);
+    void ArmTimeout(DBusTimeout *timeout);
+    void Dispatch();
+};
+
+std::mutex g_BindingsMutex;
+std::unordered_map<DBusConnection *, std::shared_ptr<Binding>> g_Bindings;
+
+// ─────────────────────────────────────
+void Binding::UpdateFd(int fd) {
+    // Caller holds `mutex`.
+    std::uint32_t events = 0;
+    if (auto it = watches.find(fd); it != watches.end()) {
+        for (DBusWatch *watch : it->second) {
+            if (!dbus_watch_get_enabled(watch)) {
+                continue;
+            }
+            const unsigned flags = dbus_watch_get_flags(watch);
+            if (flags & DBUS_WATCH_READABLE) {
+                events |= EPOLLIN;
+            }
+            if (flags & DBUS_WATCH_WRITABLE) {
+                events |= EPOLLOUT;
+            }
+        }
+    }
+
+    if (events == 0) {
+        reactor->Unwatch(fd);
+        return;
+    }
+    std::weak_ptr<Binding> weak = weak_from_this();
+    reactor->Watch(fd, events, [weak, fd](std::uint32_t ev) {
+        if (auto self = weak.lock()) {
+            self->HandleFd(fd, ev);
+        }
+    });
+}
+
+// ─────────────────────────────────────
+void Binding::HandleFd(int fd, std::uint32_t events) {
+    unsigned flags = 0;
+    flags |= (events & EPOLLIN) ? DBUS_WATCH_READABLE : 0;
+    flags |= (events & EPOLLOUT) ? DBUS_WATCH_WRITABLE : 0;
+    flags |= (events & EPOLLERR) ? DBUS_WATCH_ERROR : 0;
+    flags |= (events & EPOLLHUP) ? DBUS_WATCH_HANGUP : 0;
+
+    std::vector<DBusWatch *> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = watches.find(fd); it != watches.end()) {
+            ready = it->second;
+        }
+    }
+
+    // dbus_watch_handle may add, toggle or remove watches; those callbacks take `mutex`, so
+    // it must not be held here.
+    for (DBusWatch *watch : ready) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = watches.find(fd);
+            if (it == watches.end() ||
+                std::find(it->second.begin(), it->second.end(), watch) == it->second.end()) {
+                continue; // removed by a previous handle call
+            }
+        }
+        const unsigned wanted =
+            flags & (dbus_watch_get_flags(watch) | DBUS_WATCH_ERROR | DBUS_WATCH_HANGUP);
+        if (wanted != 0 && dbus_watch_get_enabled(watch)) {
+            dbus_watch_handle(watch, wanted);
+        }
+    }
+    Dispatch();
+}
+
+// ─────────────────────────────────────
+void Binding::ArmTimeout(DBusTimeout *timeout) {
+    // Caller holds `mutex`. libdbus timeouts repeat every interval until removed or disabled.
+    if (auto it = timeouts.find(timeout); it != timeouts.end()) {
+        reactor->CancelTimer(it->second);
+        timeouts.erase(it);
+    }
+    if (!dbus_timeout_get_enabled(timeout)) {
+        return;
+    }
+
+    std::weak_ptr<Binding> weak = weak_from_this();
+    const auto when = Reactor::Clock::now() +
+                      std::chrono::milliseconds(dbus_timeout_get_interval(timeout));
+    timeouts[timeout] = reactor->AddTimer(when, [weak, timeout] {
+        auto self = weak.lock();
+        if (!self) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(self->mutex);
+            if (!self->timeouts.contains(timeout)) {
+                return;
+            }
+        }
+        dbus_timeout_handle(timeout);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        if (self->timeouts.contains(timeout)) {
+            self->ArmTimeout(timeout);
+        }
+    });
+}
+
+// ─────────────────────────────────────
+void Binding::Dispatch() {
+    dbus_connection_ref(conn);
+    while (dbus_connection_dispatch(conn) == DBUS_DISPATCH_DATA_REMAINS) {
+    }
+    dbus_connection_unref(conn);
+}
+
+// ─────────────────────────────────────
+dbus_bool_t AddWatch(DBusWatch *watch, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    const int fd = dbus_watch_get_unix_fd(watch);
+    self->watches[fd].push_back(watch);
+    self->UpdateFd(fd);
+    return TRUE;
+}
+
+// ─────────────────────────────────────
+void RemoveWatch(DBusWatch *watch, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    const int fd = dbus_watch_get_unix_fd(watch);
+    auto it = self->watches.find(fd);
+    if (it == self->watches.end()) {
+        return;
+    }
+    std::erase(it->second, watch);
+    if (it->second.empty()) {
+        self->watches.erase(it);
+    }
+    self->UpdateFd(fd);
+}
+
+// ─────────────────────────────────────
+void ToggleWatch(DBusWatch *watch, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->UpdateFd(dbus_watch_get_unix_fd(watch));
+}
+
+// ─────────────────────────────────────
+dbus_bool_t AddTimeout(DBusTimeout *timeout, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->ArmTimeout(timeout);
+    return TRUE;
+}
+
+// ─────────────────────────────────────
+void RemoveTimeout(DBusTimeout *timeout, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    if (auto it = self->timeouts.find(timeout); it != self->timeouts.end()) {
+        self->reactor->CancelTimer(it->second);
+        self->timeouts.erase(it);
+    }
+}
+
+// ─────────────────────────────────────
+void ToggleTimeout(DBusTimeout *timeout, void *data) {
+    auto *self = static_cast<Binding *>(data);
+    std::lock_guard<std::mutex> lock(self->mutex);
+    self->ArmTimeout(timeout);
+}
+
+// ─────────────────────────────────────
+void DispatchStatusChanged(DBusConnection *, DBusDispatchStatus status, void *data) {
+    // Called with the connection lock held (e.g. after a blocking call queued other messages),
+    // so only schedule the dispatch.
+    if (status != DBUS_DISPATCH_DATA_REMAINS) {
+        return;
+    }
+    auto *self = static_cast<Binding *>(data);
+    std::weak_ptr<Binding> weak = self->weak_from_this();
+    self->reactor->Post([weak] {
+        if (auto binding = weak.lock()) {
+            binding->Dispatch();
+        }
+    });
+}
+
+} // namespace
+
+// ─────────────────────────────────────
+bool DBusDispatch::Attach(Reactor &reactor, DBusConnection *conn) {
+    if (!conn || !reactor.IsValid()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_BindingsMutex);
+    auto &binding = g_Bindings[conn];
+    if (binding) {
+        ++binding->refs;
+        return true;
+    }
+
+    binding = std::make_shared<Binding>();
+    binding->reactor = &reactor;
+    binding->conn = conn;
+    binding->refs = 1;
+    if (!dbus_connection_set_watch_functions(conn, AddWatch, RemoveWatch, ToggleWatch,
+                                             binding.get(), nullptr) ||
+        !dbus_connection_set_timeout_functions(conn, AddTimeout, RemoveTimeout, ToggleTimeout,
+                                               binding.get(), nullptr)) {
+        spdlog::warn("Failed to hook the DBus connection into the event loop");
+        dbus_connection_set_watch_functions(conn, nullptr, nullptr, nullptr, nullptr, nullptr);
+        g_Bindings.erase(conn);
+        return false;
+    }
+    dbus_connection_set_dispatch_status_function(conn, DispatchStatusChanged, binding.get(),
+                                                 nullptr);
+
+    // Messages may already be queued from calls made before attaching.
+    std::weak_ptr<Binding> weak = binding;
+    reactor.Post([weak] {
+        if (auto b = weak.lock()) {
+            b->Dispatch();
+        }
+    });
+    return true;
+}
+
+// ─────────────────────────────────────
+void DBusDispatch::Detach(DBusConnection *conn) {
+    std::shared_ptr<Binding> binding;
+    {
+        std::lock_guard<std::mutex> lock(g_BindingsMutex);
+        auto it = g_Bindings.find(conn);
+        if (it == g_Bindings.end() || --it->second->refs > 0) {
+            return;
+        }
+        binding = std::move(it->second);
+        g_Bindings.erase(it);
+    }
+
+    // Clearing the functions makes libdbus call the remove callbacks, which unregister
+    // everything from the reactor.
+    dbus_connection_set_dispatch_status_function(conn, nullptr, nullptr, nullptr);
+    dbus_connection_set_watch_functions(conn, nullptr, nullptr, nullptr, nullptr, nullptr);
+    dbus_connection_set_timeout_functions(conn, nullptr, nullptr, nullptr, nullptr, nullptr);
+}
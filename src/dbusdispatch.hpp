@@ -0,0 +1,17 @@
+#pragma once
+
+#include <dbus/dbus.h>
+
+class Reactor;
+
+// Drives a libdbus connection from a Reactor instead of a dispatcher thread: the connection's
+// socket watches become epoll registrations, its timeouts become reactor timers, and incoming
+// messages are dispatched on the reactor thread as soon as they arrive.
+//
+// Attachments are reference counted per connection, because the tray and the notifications
+// share the session bus connection returned by dbus_bus_get().
+class DBusDispatch {
+  public:
+    static bool Attach(Reactor &reactor, DBusConnection *conn);
+    static void Detach(DBusConnection *conn);
+};
@@ -0,0 +1,74 @@
+#include "httpserver.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <array>
+
+// ─────────────────────────────────────
+HttpServer &HttpServer::Get(const std::string &pattern, Handler handler) {
+    httplib::Server::Get(pattern, Instrument("GET", pattern, std::move(handler)));
+    return *this;
+}
+
+// ─────────────────────────────────────
+HttpServer &HttpServer::Post(const std::string &pattern, Handler handler) {
+    httplib::Server::Post(pattern, Instrument("POST", pattern, std::move(handler)));
+    return *this;
+}
+
+// ─────────────────────────────────────
+HttpServer &HttpServer::Put(const std::string &pattern, Handler handler) {
+    httplib::Server::Put(pattern, Instrument("PUT", pattern, std::move(handler)));
+    return *this;
+}
+
+// ─────────────────────────────────────
+HttpServer &HttpServer::Delete(const std::string &pattern, Handler handler) {
+    httplib::Server::Delete(pattern, Instrument("DELETE", pattern, std::move(handler)));
+    return *this;
+}
+
+// ─────────────────────────────────────
+HttpServer &HttpServer::Options(const std::string &pattern, Handler handler) {
+    httplib::Server::Options(pattern, Instrument("OPTIONS", pattern, std::move(handler)));
+    return *this;
+}
+
+// ─────────────────────────────────────
+httplib::Server::Handler HttpServer::Instrument(std::string_view method,
+                                                const std::string &pattern, Handler handler) {
+    auto &metrics = Metrics::Instance();
+    const std::string labels = Metrics::Labels({{"method", method}, {"route", pattern}});
+
+    Metrics::Histogram &latency = metrics.GetHistogram(
+        "concentrate_http_request_duration_seconds", "HTTP handler latency by route.", labels);
+
+    // One counter per status class (1xx..5xx), resolved now so the request path never looks
+    // anything up.
+    std::array<Metrics::Counter *, 5> responses{};
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+        const std::string code = std::to_string(i + 1) + "xx";
+        responses[i] = &metrics.GetCounter(
+            "concentrate_http_requests_total", "HTTP requests handled by route and status class.",
+            Metrics::Labels({{"method", method}, {"route", pattern}, {"code", code}}));
+    }
+
+    return [handler = std::move(handler), &latency, responses](const httplib::Request &req,
+                                                                httplib::Response &res) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto record = [&](int status) {
+            latency.Observe(std::chrono::steady_clock::now() - start);
+            // httplib defaults an untouched status to 200 after the handler returns.
+            const int cls = status < 100 ? 2 : std::min(status / 100, 5);
+            responses[static_cast<std::size_t>(cls - 1)]->Inc();
+        };
+
+        try {
+            handler(req, res);
+        } catch (...) {
+            record(500);
+            throw;
+        }
+        record(res.status);
+    };
+}
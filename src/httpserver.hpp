@@ -0,0 +1,23 @@
+#pragma once
+
+#include <httplib.h>
+
+#include <string>
+#include <string_view>
+
+// httplib::Server that records request counts and latency histograms for every registered
+// route. Handlers are wrapped at registration time, so the route label is the registered
+// pattern (bounded cardinality) and the per-request cost is two clock reads plus a few atomic
+// adds.
+class HttpServer : public httplib::Server {
+  public:
+    HttpServer &Get(const std::string &pattern, Handler handler);
+    HttpServer &Post(const std::string &pattern, Handler handler);
+    HttpServer &Put(const std::string &pattern, Handler handler);
+    HttpServer &Delete(const std::string &pattern, Handler handler);
+    HttpServer &Options(const std::string &pattern, Handler handler);
+
+  private:
+    static Handler Instrument(std::string_view method, const std::string &pattern,
+                              Handler handler);
+};
@@ -1,4 +1,6 @@
 #include "hyprland.hpp"
+#include "lineframer.hpp"
+#include "metrics.hpp"
 
 #include <spdlog/spdlog.h>
 
@@ -6,10 +8,17 @@
 #include <cstring>
 
 #include <poll.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+// A full `clients` snapshot now and then corrects anything the event stream missed.
+static constexpr std::chrono::minutes kReconcileEvery{5};
+// Unknown addresses trigger an early reconcile, but not more often than this.
+static constexpr std::chrono::seconds kMinReconcileGap{10};
+
+// ─────────────────────────────────────
 static std::filesystem::path ResolveHyprBaseDir() {
     const char *xdgRuntimeDirEnv = std::getenv("XDG_RUNTIME_DIR");
     std::filesystem::path xdgRuntimeDir;
@@ -27,7 +36,7 @@ static std::filesystem::path ResolveHyprBaseDir() {
 }
 
 // ─────────────────────────────────────
-static bool Contains(const std::vector<std::string> &v, const std::string &needle) {
+static bool Contains(const std::vector<std::string> &v, std::string_view needle) {
     for (const auto &s : v) {
         if (s == needle) {
             return true;
@@ -146,55 +155,11 @@ bool HyprlandIPC::SendAll(int fd, const void *data, std::size_t size) {
 }
 
 // ─────────────────────────────────────
-bool HyprlandIPC::ReadLine(int fd, std::string &out_line, std::string &buffer,
-                           std::chrono::milliseconds timeout) {
-    out_line.clear();
-
-    const auto find_newline = [&buffer]() -> std::size_t { return buffer.find('\n'); };
-
-    if (auto pos = find_newline(); pos != std::string::npos) {
-        out_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        return true;
-    }
-
-    pollfd pfd;
-    pfd.fd = fd;
-    pfd.events = POLLIN;
-    pfd.revents = 0;
-
-    const int rc = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
-    if (rc <= 0) {
-        return false;
-    }
-
-    if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
-        return false;
-    }
-
-    char tmp[4096];
-    const ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
-    if (n <= 0) {
-        return false;
-    }
-
-    buffer.append(tmp, static_cast<std::size_t>(n));
-
-    if (auto pos = find_newline(); pos != std::string::npos) {
-        out_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        return true;
-    }
-
-    return false;
-}
-
-// ─────────────────────────────────────
-std::string HyprlandIPC::EventNameFromLine(const std::string &line) {
+std::string_view HyprlandIPC::EventNameFromLine(std::string_view line) {
     // Hyprland events look like: "activewindow>>Class,Title" or "workspace>>id".
     // Waybar splits on the first '>' character.
     const auto pos = line.find_first_of('>');
-    if (pos == std::string::npos) {
+    if (pos == std::string_view::npos) {
         return {};
     }
     return line.substr(0, pos);
@@ -203,16 +168,44 @@ std::string HyprlandIPC::EventNameFromLine(const std::string &line) {
 // ─────────────────────────────────────
 std::optional<nlohmann::json>
 HyprlandIPC::SendJsonRequest(const std::string &rq, std::chrono::milliseconds timeout) const {
-    if (!IsAvailable()) {
+    std::string response;
+    if (m_Replies) {
+        response = m_Replies(rq).value_or(std::string{});
+    } else {
+        if (!IsAvailable()) {
+            return std::nullopt;
+        }
+        response = RequestRaw(rq, timeout);
+        if (m_Recorder && !response.empty()) {
+            m_Recorder->Query(rq, response);
+        }
+    }
+
+    if (response.empty()) {
         return std::nullopt;
     }
 
+    try {
+        return nlohmann::json::parse(response);
+    } catch (const std::exception &e) {
+        spdlog::debug("Hyprland IPC: failed to parse JSON reply for '{}': {}", rq, e.what());
+        return std::nullopt;
+    }
+}
+
+// ─────────────────────────────────────
+std::string HyprlandIPC::RequestRaw(const std::string &rq, std::chrono::milliseconds timeout) const {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_ipc_query_duration_seconds", "Round trip of compositor IPC queries.",
+        Metrics::Labels({{"backend", "hyprland"}}));
+    Metrics::ScopedTimer timer(timing);
+
     const auto socketPath = m_SocketFolder / ".socket.sock";
 
     const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
     if (fd < 0) {
         spdlog::warn("Hyprland IPC: socket() failed: {}", std::strerror(errno));
-        return std::nullopt;
+        return {};
     }
 
     sockaddr_un addr;
@@ -223,21 +216,21 @@ HyprlandIPC::SendJsonRequest(const std::string &rq, std::chrono::milliseconds ti
     if (socketPathStr.size() >= sizeof(addr.sun_path)) {
         close(fd);
         spdlog::warn("Hyprland IPC: socket path too long");
-        return std::nullopt;
+        return {};
     }
     std::strncpy(addr.sun_path, socketPathStr.c_str(), sizeof(addr.sun_path) - 1);
 
     if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
         spdlog::debug("Hyprland IPC: connect() failed: {}", std::strerror(errno));
         close(fd);
-        return std::nullopt;
+        return {};
     }
 
     // Request format matches waybar: prefix with "j/" for JSON.
     const std::string request = "j/" + rq;
     if (!SendAll(fd, request.data(), request.size())) {
         close(fd);
-        return std::nullopt;
+        return {};
     }
 
     // Read full response until EOF, with a conservative timeout.
@@ -282,17 +275,7 @@ HyprlandIPC::SendJsonRequest(const std::string &rq, std::chrono::milliseconds ti
     }
 
     close(fd);
-
-    if (response.empty()) {
-        return std::nullopt;
-    }
-
-    try {
-        return nlohmann::json::parse(response);
-    } catch (const std::exception &e) {
-        spdlog::debug("Hyprland IPC: failed to parse JSON reply for '{}': {}", rq, e.what());
-        return std::nullopt;
-    }
+    return response;
 }
 
 // ─────────────────────────────────────
@@ -370,7 +353,8 @@ HyprlandIPC::GetActiveClassAndTitle(std::chrono::milliseconds timeout) const {
 }
 
 // ─────────────────────────────────────
-bool HyprlandIPC::StartEventStream(std::function<void(const std::string &event)> callback,
+bool HyprlandIPC::StartEventStream(Reactor &reactor,
+                                   std::function<void(const std::string &event)> callback,
                                    std::vector<std::string> only_events,
                                    std::chrono::milliseconds reconnect_delay) {
     if (m_StreamRunning.load()) {
@@ -386,71 +370,308 @@ bool HyprlandIPC::StartEventStream(std::function<void(const std::string &event)>
         return false;
     }
 
-    m_StopStream.store(false);
+    m_Reactor = &reactor;
+    m_StreamCallback = std::move(callback);
+    m_StreamOnly = std::move(only_events);
+    m_ReconnectDelay = reconnect_delay;
     m_StreamRunning.store(true);
+    ConnectStream();
+    return true;
+}
 
-    m_StreamThread =
-        std::thread([this, callback, only_events = std::move(only_events), reconnect_delay]() {
-            while (!m_StopStream.load()) {
-                CloseFd(m_StreamFd);
+// ─────────────────────────────────────
+void HyprlandIPC::ConnectStream() {
+    m_ReconnectTimer = 0;
+    if (!ConnectStreamFd(m_StreamFd)) {
+        ScheduleReconnect();
+        return;
+    }
 
-                if (!ConnectStreamFd(m_StreamFd)) {
-                    std::this_thread::sleep_for(reconnect_delay);
-                    continue;
-                }
+    m_StreamFramer.Clear();
+    if (!m_Reactor->Watch(m_StreamFd, EPOLLIN, [this](std::uint32_t) { OnStreamReadable(); })) {
+        CloseFd(m_StreamFd);
+        ScheduleReconnect();
+        return;
+    }
 
-                std::string buffer;
-                std::string line;
-
-                while (!m_StopStream.load()) {
-                    if (!ReadLine(m_StreamFd, line, buffer, std::chrono::milliseconds(30000))) {
-                        break; // reconnect
-                    }
-
-                    if (line.empty()) {
-                        continue;
-                    }
-
-                    const std::string evName = EventNameFromLine(line);
-                    if (!only_events.empty() && !Contains(only_events, evName)) {
-                        continue;
-                    }
-
-                    try {
-                        if (callback) {
-                            callback(line);
-                        }
-                    } catch (...) {
-                        spdlog::error("HyprlandIPC callback failed");
-                    }
-                }
+    // Seed the table; events from here on keep it current.
+    ReconcileWindowTable();
+    ScheduleReconcile();
+}
 
-                CloseFd(m_StreamFd);
-                if (!m_StopStream.load()) {
-                    std::this_thread::sleep_for(reconnect_delay);
-                }
-            }
+// ─────────────────────────────────────
+void HyprlandIPC::ScheduleReconnect() {
+    m_ReconnectTimer = m_Reactor->AddTimer(std::chrono::steady_clock::now() + m_ReconnectDelay,
+                                           [this] { ConnectStream(); });
+}
 
-            CloseFd(m_StreamFd);
-            m_StreamRunning.store(false);
-        });
+// ─────────────────────────────────────
+void HyprlandIPC::ScheduleReconcile() {
+    const std::chrono::seconds wait = m_NeedReconcile ? kMinReconcileGap : kReconcileEvery;
+    const auto due = m_LastReconcile + wait;
+    if (m_ReconcileTimer != 0) {
+        if (due == m_ReconcileDue) {
+            return;
+        }
+        m_Reactor->CancelTimer(m_ReconcileTimer);
+    }
 
-    return true;
+    m_ReconcileDue = due;
+    m_ReconcileTimer = m_Reactor->AddTimer(due, [this] {
+        m_ReconcileTimer = 0;
+        ReconcileWindowTable();
+        ScheduleReconcile();
+    });
 }
 
 // ─────────────────────────────────────
-void HyprlandIPC::StopEventStream() {
-    m_StopStream.store(true);
+void HyprlandIPC::OnStreamReadable() {
+    static auto &reconnects = Metrics::Instance().GetCounter(
+        "concentrate_ipc_reconnects_total", "Compositor event stream reconnects.",
+        Metrics::Labels({{"backend", "hyprland"}}));
+
+    const auto result = m_StreamFramer.Drain(
+        m_StreamFd, [this](std::string_view line) { HandleStreamLine(line); });
+    if (result == LineFramer::Result::Timeout) {
+        // Drained; partial lines stay buffered. Unknown addresses pull the reconcile forward.
+        if (m_NeedReconcile) {
+            ScheduleReconcile();
+        }
+        return;
+    }
+    if (result == LineFramer::Result::TooLong) {
+        spdlog::warn("Hyprland event exceeds {} bytes; reconnecting",
+                     LineFramer::kDefaultMaxLine);
+    }
+
+    CloseStream();
+    reconnects.Inc();
+    ScheduleReconnect();
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::HandleStreamLine(std::string_view line) {
+    static auto &events = Metrics::Instance().GetCounter(
+        "concentrate_ipc_events_total", "Compositor events delivered to the tracker.",
+        Metrics::Labels({{"backend", "hyprland"}}));
+
+    if (line.empty()) {
+        return;
+    }
+    if (m_Recorder) {
+        m_Recorder->Event(line);
+    }
 
-    if (m_StreamThread.joinable()) {
-        m_StreamThread.join();
+    ApplyWindowEvent(line);
+
+    const std::string_view evName = EventNameFromLine(line);
+    if (!m_StreamOnly.empty() && !Contains(m_StreamOnly, evName)) {
+        return;
+    }
+
+    events.Inc();
+    try {
+        if (m_StreamCallback) {
+            m_StreamCallback(std::string(line));
+        }
+    } catch (...) {
+        spdlog::error("HyprlandIPC callback failed");
     }
+}
 
+// ─────────────────────────────────────
+void HyprlandIPC::CloseStream() {
+    if (m_StreamFd >= 0) {
+        m_Reactor->Unwatch(m_StreamFd);
+    }
     CloseFd(m_StreamFd);
-    m_StreamRunning.store(false);
+    if (m_ReconcileTimer != 0) {
+        m_Reactor->CancelTimer(m_ReconcileTimer);
+        m_ReconcileTimer = 0;
+    }
+    ResetWindowTable();
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::StopEventStream() {
+    if (!m_StreamRunning.exchange(false)) {
+        return;
+    }
+
+    if (m_ReconnectTimer != 0) {
+        m_Reactor->CancelTimer(m_ReconnectTimer);
+        m_ReconnectTimer = 0;
+    }
+    CloseStream();
 }
 
 // ─────────────────────────────────────
 bool HyprlandIPC::IsEventStreamRunning() const {
     return m_StreamRunning.load();
 }
+
+// ─────────────────────────────────────
+std::shared_ptr<const HyprWindowTable> HyprlandIPC::GetWindowTable() const {
+    return m_WindowTable.load(std::memory_order_acquire);
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::SetRecorder(IpcTape::Recorder *recorder) {
+    m_Recorder = recorder;
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::StartReplay(std::function<void(const std::string &event)> callback,
+                              std::vector<std::string> only_events,
+                              IpcTape::ReplySource replies) {
+    m_StreamCallback = std::move(callback);
+    m_StreamOnly = std::move(only_events);
+    m_Replies = std::move(replies);
+    ResetWindowTable();
+    ReconcileWindowTable();
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::ReplayStreamLine(std::string_view line) {
+    HandleStreamLine(line);
+}
+
+// ─────────────────────────────────────
+std::string HyprlandIPC::NormalizeAddress(std::string_view address) {
+    if (address.starts_with("0x") || address.starts_with("0X")) {
+        address.remove_prefix(2);
+    }
+    return std::string(address);
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::ApplyWindowEvent(std::string_view line) {
+    const auto sep = line.find(">>");
+    if (sep == std::string_view::npos) {
+        return;
+    }
+    const std::string_view name = line.substr(0, sep);
+    const std::string_view payload = line.substr(sep + 2);
+
+    // Splits off the first field; titles (always last) may themselves contain commas.
+    const auto next = [](std::string_view &rest) {
+        const auto comma = rest.find(',');
+        std::string_view field = rest.substr(0, comma);
+        rest = comma == std::string_view::npos ? std::string_view{} : rest.substr(comma + 1);
+        return field;
+    };
+
+    HyprWindowTable &t = m_StreamTable;
+    if (name == "activewindow") {
+        // "class,title"; the activewindowv2 event that follows carries the address.
+        std::string_view rest = payload;
+        t.active_class = std::string(next(rest));
+        t.active_title = std::string(rest);
+        t.active_address.clear();
+    } else if (name == "activewindowv2") {
+        t.active_address = NormalizeAddress(payload);
+        if (!t.active_address.empty() && !t.clients.contains(t.active_address)) {
+            m_NeedReconcile = true;
+        }
+    } else if (name == "openwindow") {
+        // "address,workspace,class,title"
+        std::string_view rest = payload;
+        HyprClient client;
+        client.address = NormalizeAddress(next(rest));
+        next(rest); // workspace
+        client.cls = std::string(next(rest));
+        client.title = std::string(rest);
+        t.clients[client.address] = std::move(client);
+    } else if (name == "closewindow") {
+        const std::string address = NormalizeAddress(payload);
+        t.clients.erase(address);
+        if (t.active_address == address) {
+            t.active_address.clear();
+        }
+    } else if (name == "windowtitlev2") {
+        // "address,title"
+        std::string_view rest = payload;
+        const std::string address = NormalizeAddress(next(rest));
+        auto it = t.clients.find(address);
+        if (it == t.clients.end()) {
+            m_NeedReconcile = true;
+            return;
+        }
+        it->second.title = std::string(rest);
+        if (t.active_address == address) {
+            t.active_title = it->second.title;
+        }
+    } else {
+        return;
+    }
+
+    PublishWindowTable();
+}
+
+// ─────────────────────────────────────
+bool HyprlandIPC::ReconcileWindowTable() {
+    static auto &reconciles = Metrics::Instance().GetCounter(
+        "concentrate_hyprland_reconciles_total",
+        "Hyprland window table refreshes from a clients snapshot.");
+
+    m_LastReconcile = std::chrono::steady_clock::now();
+    m_NeedReconcile = false;
+
+    const auto clients = SendJsonRequest("clients");
+    if (!clients.has_value() || !clients->is_array()) {
+        spdlog::debug("Hyprland IPC: clients snapshot unavailable; keeping event-built table");
+        return false;
+    }
+    reconciles.Inc();
+
+    HyprWindowTable table;
+    for (const auto &c : *clients) {
+        if (!c.is_object() || !c.contains("address") || !c["address"].is_string()) {
+            continue;
+        }
+        HyprClient client;
+        client.address = NormalizeAddress(c["address"].get<std::string>());
+        if (c.contains("class") && c["class"].is_string()) {
+            client.cls = c["class"].get<std::string>();
+        }
+        if (c.contains("title") && c["title"].is_string()) {
+            client.title = c["title"].get<std::string>();
+        }
+        table.clients[client.address] = std::move(client);
+    }
+
+    if (const auto active = SendJsonRequest("activewindow");
+        active.has_value() && active->is_object()) {
+        if (active->contains("address") && (*active)["address"].is_string()) {
+            table.active_address = NormalizeAddress((*active)["address"].get<std::string>());
+        }
+        if (active->contains("class") && (*active)["class"].is_string()) {
+            table.active_class = (*active)["class"].get<std::string>();
+        }
+        if (active->contains("title") && (*active)["title"].is_string()) {
+            table.active_title = (*active)["title"].get<std::string>();
+        }
+    }
+
+    m_StreamTable = std::move(table);
+    m_StreamSeeded = true;
+    PublishWindowTable();
+    return true;
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::PublishWindowTable() {
+    if (!m_StreamSeeded) {
+        return;
+    }
+    m_WindowTable.store(std::make_shared<const HyprWindowTable>(m_StreamTable),
+                        std::memory_order_release);
+}
+
+// ─────────────────────────────────────
+void HyprlandIPC::ResetWindowTable() {
+    m_StreamTable = HyprWindowTable{};
+    m_StreamSeeded = false;
+    m_NeedReconcile = false;
+    m_WindowTable.store(nullptr, std::memory_order_release);
+}
@@ -2,16 +2,51 @@
 
 #include <nlohmann/json.hpp>
 
+#include "ipctape.hpp"
+#include "lineframer.hpp"
+#include "reactor.hpp"
+
 #include <atomic>
 #include <chrono>
 #include <filesystem>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+struct HyprClient {
+    std::string address; // hex, without the "0x" prefix used by `clients`
+    std::string cls;
+    std::string title;
+};
+
+// Clients keyed by address, kept current from socket2 events (openwindow, closewindow,
+// windowtitlev2, activewindow, activewindowv2) and reconciled with `clients` snapshots. The v1
+// windowtitle event has no title and is ignored.
+struct HyprWindowTable {
+    std::unordered_map<std::string, HyprClient> clients;
+    // From activewindowv2; cleared by activewindow until the matching v2 event arrives.
+    std::string active_address;
+    // From activewindow, used when the address is unknown.
+    std::string active_class;
+    std::string active_title;
+
+    // {class, title} of the active window; both empty when nothing is focused.
+    std::pair<std::string, std::string> Active() const {
+        if (!active_address.empty()) {
+            auto it = clients.find(active_address);
+            if (it != clients.end()) {
+                return {it->second.cls, it->second.title};
+            }
+        }
+        return {active_class, active_title};
+    }
+};
+
 class HyprlandIPC {
   public:
     HyprlandIPC();
@@ -32,33 +67,77 @@ class HyprlandIPC {
     std::optional<std::pair<std::string, std::string>> GetActiveClassAndTitle(
       std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) const;
 
-    // Socket2 event stream. Callback receives the full raw event line.
-    bool StartEventStream(std::function<void(const std::string &event)> callback,
+    // Socket2 event stream, driven by `reactor`. Callback receives the full raw event line and
+    // runs on the reactor thread; Start/Stop from that thread too.
+    bool StartEventStream(Reactor &reactor,
+                          std::function<void(const std::string &event)> callback,
                           std::vector<std::string> only_events,
                           std::chrono::milliseconds reconnect_delay =
                               std::chrono::milliseconds(1000));
     void StopEventStream();
     bool IsEventStreamRunning() const;
 
+    // Latest window table maintained by the event stream, or null while the stream is down or
+    // not yet seeded (callers then fall back to GetActiveClassAndTitle). Lock-free.
+    std::shared_ptr<const HyprWindowTable> GetWindowTable() const;
+
+    // Record-and-replay (see IpcTape). While a recorder is set, raw socket2 lines and socket1
+    // replies are appended to it; it must outlive the connection.
+    void SetRecorder(IpcTape::Recorder *recorder);
+    // Replay instead of StartEventStream: the table is seeded from the recorded `clients` and
+    // `activewindow` replies, then kept current by ReplayStreamLine(). There is no periodic
+    // reconcile, since replies only change as the tape advances. Single-threaded, no reactor.
+    void StartReplay(std::function<void(const std::string &event)> callback,
+                     std::vector<std::string> only_events, IpcTape::ReplySource replies);
+    void ReplayStreamLine(std::string_view line);
+
   private:
     static std::string GetEnvInstanceSignature();
     static std::filesystem::path GetSocketFolderForInstance(const std::string &instanceSig);
 
+    // Raw socket1 reply to `rq`; empty on failure.
+    std::string RequestRaw(const std::string &rq, std::chrono::milliseconds timeout) const;
     bool ConnectStreamFd(int &fd);
     static void CloseFd(int &fd);
 
     static bool SendAll(int fd, const void *data, std::size_t size);
-    bool ReadLine(int fd, std::string &out_line, std::string &buffer,
-                  std::chrono::milliseconds timeout);
 
-    static std::string EventNameFromLine(const std::string &line);
+    static std::string_view EventNameFromLine(std::string_view line);
+    static std::string NormalizeAddress(std::string_view address);
+
+    // Reactor thread only.
+    void ConnectStream();
+    void ScheduleReconnect();
+    void ScheduleReconcile();
+    void OnStreamReadable();
+    void HandleStreamLine(std::string_view line);
+    void CloseStream();
+    void ApplyWindowEvent(std::string_view line);
+    bool ReconcileWindowTable();
+    void PublishWindowTable();
+    void ResetWindowTable();
 
   private:
     std::string m_InstanceSig;
     std::filesystem::path m_SocketFolder;
+    IpcTape::Recorder *m_Recorder = nullptr;
+    IpcTape::ReplySource m_Replies;
 
     std::atomic<bool> m_StreamRunning{false};
-    std::atomic<bool> m_StopStream{false};
-    std::thread m_StreamThread;
+    Reactor *m_Reactor = nullptr;
+    std::function<void(const std::string &event)> m_StreamCallback;
+    std::vector<std::string> m_StreamOnly;
+    std::chrono::milliseconds m_ReconnectDelay{1000};
+    Reactor::TimerId m_ReconnectTimer = 0;
+    Reactor::TimerId m_ReconcileTimer = 0;
+    std::chrono::steady_clock::time_point m_ReconcileDue{};
     int m_StreamFd = -1;
+    LineFramer m_StreamFramer;
+
+    // Owned by the reactor thread; readers only see the published copies.
+    HyprWindowTable m_StreamTable;
+    bool m_StreamSeeded = false;
+    bool m_NeedReconcile = false;
+    std::chrono::steady_clock::time_point m_LastReconcile{};
+    std::atomic<std::shared_ptr<const HyprWindowTable>> m_WindowTable;
 };
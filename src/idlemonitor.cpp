@@ -0,0 +1,419 @@
+#include "idlemonitor.hpp"
+#include "dbusdispatch.hpp"
+#include "metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+static constexpr const char *kLogindName = "org.freedesktop.login1";
+static constexpr const char *kLogindPath = "/org/freedesktop/login1";
+static constexpr const char *kManagerIface = "org.freedesktop.login1.Manager";
+static constexpr const char *kSessionIface = "org.freedesktop.login1.Session";
+static constexpr const char *kPropsIface = "org.freedesktop.DBus.Properties";
+static constexpr int kCallTimeoutMs = 1000;
+
+// ─────────────────────────────────────
+IdleMonitor::IdleMonitor(Reactor &reactor, std::chrono::seconds threshold,
+                         std::function<void()> onChange)
+    : m_Reactor(reactor), m_Threshold(threshold), m_OnChange(std::move(onChange)) {}
+
+// ─────────────────────────────────────
+IdleMonitor::~IdleMonitor() {
+    if (m_ReconnectTimer != 0) {
+        m_Reactor.CancelTimer(m_ReconnectTimer);
+    }
+    if (m_AwayTimer != 0) {
+        m_Reactor.CancelTimer(m_AwayTimer);
+    }
+    Disconnect();
+}
+
+// ─────────────────────────────────────
+bool IdleMonitor::Start() {
+    if (Connect()) {
+        return true;
+    }
+    ScheduleReconnect("logind unavailable", std::chrono::seconds(30));
+    return false;
+}
+
+// ─────────────────────────────────────
+std::optional<std::chrono::steady_clock::time_point> IdleMonitor::AwaySince() const {
+    const std::int64_t ns = m_AwaySinceNs.load(std::memory_order_acquire);
+    if (ns == 0) {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns));
+}
+
+// ─────────────────────────────────────
+bool IdleMonitor::IsAway() const {
+    return m_AwaySinceNs.load(std::memory_order_acquire) != 0;
+}
+
+// ─────────────────────────────────────
+bool IdleMonitor::Connect() {
+    DBusError err;
+    dbus_error_init(&err);
+
+    // Honors DBUS_SYSTEM_BUS_ADDRESS.
+    DBusConnection *conn = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+    if (!conn) {
+        spdlog::warn("Idle: system bus connection failed: {}",
+                     dbus_error_is_set(&err) ? err.message : "unknown error");
+        dbus_error_free(&err);
+        return false;
+    }
+    dbus_connection_set_exit_on_disconnect(conn, FALSE);
+    m_Conn = conn;
+    dbus_connection_add_filter(m_Conn, &IdleMonitor::FilterHandler, this, nullptr);
+
+    m_SessionPath = ResolveSessionPath();
+    if (m_SessionPath.empty()) {
+        Disconnect();
+        return false;
+    }
+
+    // Subscribe before reading the properties so no change falls in between.
+    m_MatchRule = "type='signal',sender='" + std::string(kLogindName) + "',interface='" +
+                  kPropsIface + "',member='PropertiesChanged',path='" + m_SessionPath + "'";
+    dbus_bus_add_match(m_Conn, m_MatchRule.c_str(), &err);
+    if (!dbus_error_is_set(&err)) {
+        dbus_bus_add_match(m_Conn,
+                           "type='signal',sender='org.freedesktop.DBus',interface='org.freedesktop."
+                           "DBus',member='NameOwnerChanged',arg0='org.freedesktop.login1'",
+                           &err);
+    }
+    if (dbus_error_is_set(&err)) {
+        spdlog::warn("Idle: failed to subscribe to logind session changes: {}", err.message);
+        dbus_error_free(&err);
+        Disconnect();
+        return false;
+    }
+
+    if (!FetchProperties()) {
+        Disconnect();
+        return false;
+    }
+
+    if (!DBusDispatch::Attach(m_Reactor, m_Conn)) {
+        spdlog::warn("Idle: logind changes will not be dispatched");
+    }
+    spdlog::info("Idle detection via logind session {} (away after {}s idle)", m_SessionPath,
+                 m_Threshold.count());
+    Evaluate();
+    return true;
+}
+
+// ─────────────────────────────────────
+void IdleMonitor::Disconnect() {
+    if (!m_Conn) {
+        return;
+    }
+
+    DBusDispatch::Detach(m_Conn);
+    dbus_connection_remove_filter(m_Conn, &IdleMonitor::FilterHandler, this);
+    if (!m_MatchRule.empty() && dbus_connection_get_is_connected(m_Conn)) {
+        dbus_bus_remove_match(m_Conn, m_MatchRule.c_str(), nullptr);
+    }
+    dbus_connection_unref(m_Conn);
+    m_Conn = nullptr;
+    m_MatchRule.clear();
+    m_SessionPath.clear();
+}
+
+// ─────────────────────────────────────
+void IdleMonitor::ScheduleReconnect(const char *reason, std::chrono::milliseconds delay) {
+    if (m_ReconnectTimer != 0) {
+        return;
+    }
+    // Runs outside the dispatch of the dying connection; retried until logind is back.
+    m_ReconnectTimer =
+        m_Reactor.AddTimer(std::chrono::steady_clock::now() + delay, [this, reason] {
+            m_ReconnectTimer = 0;
+            spdlog::info("Idle: reconnecting to logind ({})", reason);
+            Disconnect();
+            if (!Connect()) {
+                ScheduleReconnect(reason, std::chrono::seconds(30));
+            }
+        });
+
+    // Without logind there is nothing to say the user left.
+    m_IdleHint = false;
+    m_Locked = false;
+    Evaluate();
+}
+
+// ─────────────────────────────────────
+std::string IdleMonitor::ResolveSessionPath() {
+    // Prefer the session we were started from; "auto" makes logind pick the caller's session
+    // or, for user services, the user's display session.
+    const char *sessionId = std::getenv("XDG_SESSION_ID");
+    const char *id = (sessionId && *sessionId) ? sessionId : "auto";
+
+    DBusMessage *msg =
+        dbus_message_new_method_call(kLogindName, kLogindPath, kManagerIface, "GetSession");
+    if (!msg) {
+        return {};
+    }
+    dbus_message_append_args(msg, DBUS_TYPE_STRING, &id, DBUS_TYPE_INVALID);
+
+    DBusError err;
+    dbus_error_init(&err);
+    DBusMessage *reply =
+        dbus_connection_send_with_reply_and_block(m_Conn, msg, kCallTimeoutMs, &err);
+    dbus_message_unref(msg);
+
+    if (!reply) {
+        dbus_error_free(&err);
+        dbus_error_init(&err);
+
+        const dbus_uint32_t pid = static_cast<dbus_uint32_t>(::getpid());
+        msg = dbus_message_new_method_call(kLogindName, kLogindPath, kManagerIface,
+                                           "GetSessionByPID");
+        if (!msg) {
+            return {};
+        }
+        dbus_message_append_args(msg, DBUS_TYPE_UINT32, &pid, DBUS_TYPE_INVALID);
+        reply = dbus_connection_send_with_reply_and_block(m_Conn, msg, kCallTimeoutMs, &err);
+        dbus_message_unref(msg);
+    }
+
+    if (!reply) {
+        spdlog::warn("Idle: no logind session found: {}",
+                     dbus_error_is_set(&err) ? err.message : "unknown error");
+        dbus_error_free(&err);
+        return {};
+    }
+
+    const char *path = nullptr;
+    std::string result;
+    if (dbus_message_get_args(reply, &err, DBUS_TYPE_OBJECT_PATH, &path, DBUS_TYPE_INVALID) &&
+        path) {
+        result = path;
+    } else {
+        spdlog::warn("Idle: unexpected GetSession reply");
+        dbus_error_free(&err);
+    }
+    dbus_message_unref(reply);
+    return result;
+}
+
+// ─────────────────────────────────────
+bool IdleMonitor::FetchProperties() {
+    DBusMessage *msg =
+        dbus_message_new_method_call(kLogindName, m_SessionPath.c_str(), kPropsIface, "GetAll");
+    if (!msg) {
+        return false;
+    }
+    const char *iface = kSessionIface;
+    dbus_message_append_args(msg, DBUS_TYPE_STRING, &iface, DBUS_TYPE_INVALID);
+
+    DBusError err;
+    dbus_error_init(&err);
+    DBusMessage *reply =
+        dbus_connection_send_with_reply_and_block(m_Conn, msg, kCallTimeoutMs, &err);
+    dbus_message_unref(msg);
+    if (!reply) {
+        spdlog::warn("Idle: failed to read logind session properties: {}",
+                     dbus_error_is_set(&err) ? err.message : "unknown error");
+        dbus_error_free(&err);
+        return false;
+    }
+
+    DBusMessageIter args;
+    const bool ok = dbus_message_iter_init(reply, &args) &&
+                    dbus_message_iter_get_arg_type(&args) == DBUS_TYPE_ARRAY;
+    if (ok) {
+        ApplyProperties(&args);
+    }
+    dbus_message_unref(reply);
+    return ok;
+}
+
+// ─────────────────────────────────────
+bool IdleMonitor::ApplyProperties(DBusMessageIter *dict) {
+    bool applied = false;
+
+    DBusMessageIter entries;
+    dbus_message_iter_recurse(dict, &entries);
+    for (; dbus_message_iter_get_arg_type(&entries) == DBUS_TYPE_DICT_ENTRY;
+         dbus_message_iter_next(&entries)) {
+        DBusMessageIter entry;
+        dbus_message_iter_recurse(&entries, &entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_STRING) {
+            continue;
+        }
+        const char *key = nullptr;
+        dbus_message_iter_get_basic(&entry, &key);
+        dbus_message_iter_next(&entry);
+        if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_VARIANT) {
+            continue;
+        }
+        DBusMessageIter value;
+        dbus_message_iter_recurse(&entry, &value);
+        const int type = dbus_message_iter_get_arg_type(&value);
+
+        if (type == DBUS_TYPE_BOOLEAN &&
+            (std::strcmp(key, "IdleHint") == 0 || std::strcmp(key, "LockedHint") == 0)) {
+            dbus_bool_t flag = FALSE;
+            dbus_message_iter_get_basic(&value, &flag);
+            if (key[0] == 'I') {
+                m_IdleHint = flag;
+            } else {
+                m_Locked = flag;
+            }
+            applied = true;
+        } else if (type == DBUS_TYPE_UINT64 && std::strcmp(key, "IdleSinceHintMonotonic") == 0) {
+            // CLOCK_MONOTONIC microseconds, the same clock as steady_clock.
+            dbus_uint64_t usec = 0;
+            dbus_message_iter_get_basic(&value, &usec);
+            const auto now = std::chrono::steady_clock::now();
+            const auto since =
+                std::chrono::steady_clock::time_point(std::chrono::microseconds(usec));
+            m_IdleSince = (usec == 0 || since > now) ? now : since;
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+// ─────────────────────────────────────
+DBusHandlerResult IdleMonitor::FilterHandler(DBusConnection *, DBusMessage *msg,
+                                             void *user_data) {
+    return static_cast<IdleMonitor *>(user_data)->HandleFilter(msg);
+}
+
+// ─────────────────────────────────────
+DBusHandlerResult IdleMonitor::HandleFilter(DBusMessage *msg) {
+    if (dbus_message_is_signal(msg, DBUS_INTERFACE_LOCAL, "Disconnected")) {
+        ScheduleReconnect("system bus disconnected", std::chrono::seconds(1));
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+
+    if (dbus_message_is_signal(msg, "org.freedesktop.DBus", "NameOwnerChanged")) {
+        const char *name = nullptr;
+        const char *oldOwner = nullptr;
+        const char *newOwner = nullptr;
+        if (dbus_message_get_args(msg, nullptr, DBUS_TYPE_STRING, &name, DBUS_TYPE_STRING,
+                                  &oldOwner, DBUS_TYPE_STRING, &newOwner, DBUS_TYPE_INVALID) &&
+            name && std::strcmp(name, kLogindName) == 0) {
+            // logind restarted: sessions survive it, but re-resolve anyway.
+            const bool back = newOwner && *newOwner;
+            if (back && m_ReconnectTimer != 0) {
+                m_Reactor.CancelTimer(m_ReconnectTimer);
+                m_ReconnectTimer = 0;
+            }
+            ScheduleReconnect(back ? "logind restarted" : "logind exited",
+                              back ? std::chrono::milliseconds(0) : std::chrono::seconds(30));
+        }
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+
+    if (!dbus_message_is_signal(msg, kPropsIface, "PropertiesChanged") ||
+        m_SessionPath != (dbus_message_get_path(msg) ? dbus_message_get_path(msg) : "")) {
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+
+    DBusMessageIter args;
+    const char *iface = nullptr;
+    if (!dbus_message_iter_init(msg, &args) ||
+        dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_STRING) {
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+    dbus_message_iter_get_basic(&args, &iface);
+    if (std::strcmp(iface, kSessionIface) != 0 || !dbus_message_iter_next(&args) ||
+        dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY) {
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+
+    bool changed = ApplyProperties(&args);
+
+    // Properties may also be announced as invalidated, without a value.
+    if (dbus_message_iter_next(&args) && dbus_message_iter_get_arg_type(&args) == DBUS_TYPE_ARRAY) {
+        DBusMessageIter names;
+        dbus_message_iter_recurse(&args, &names);
+        for (; dbus_message_iter_get_arg_type(&names) == DBUS_TYPE_STRING;
+             dbus_message_iter_next(&names)) {
+            const char *name = nullptr;
+            dbus_message_iter_get_basic(&names, &name);
+            if (std::strstr(name, "Hint") != nullptr) {
+                changed = FetchProperties() || changed;
+                break;
+            }
+        }
+    }
+
+    if (changed) {
+        Evaluate();
+    }
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+}
+
+// ─────────────────────────────────────
+void IdleMonitor::Evaluate() {
+    if (m_AwayTimer != 0) {
+        m_Reactor.CancelTimer(m_AwayTimer);
+        m_AwayTimer = 0;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (m_Locked) {
+        SetAway(m_IdleHint ? std::min(m_IdleSince, now) : now);
+        return;
+    }
+    if (!m_IdleHint) {
+        SetAway(std::nullopt);
+        return;
+    }
+
+    const auto awayAt = m_IdleSince + m_Threshold;
+    if (awayAt <= now) {
+        SetAway(m_IdleSince);
+        return;
+    }
+
+    SetAway(std::nullopt);
+    m_AwayTimer = m_Reactor.AddTimer(awayAt, [this] {
+        m_AwayTimer = 0;
+        Evaluate();
+    });
+}
+
+// ─────────────────────────────────────
+void IdleMonitor::SetAway(std::optional<std::chrono::steady_clock::time_point> since) {
+    static auto &toAway = Metrics::Instance().GetCounter(
+        "concentrate_idle_transitions_total", "Transitions between present and away.",
+        Metrics::Labels({{"to", "away"}}));
+    static auto &toActive = Metrics::Instance().GetCounter(
+        "concentrate_idle_transitions_total", "Transitions between present and away.",
+        Metrics::Labels({{"to", "active"}}));
+
+    const bool wasAway = IsAway();
+    if (since.has_value() == wasAway) {
+        // Still away: keep the earlier start (e.g. locked after going idle).
+        return;
+    }
+
+    if (since) {
+        // 0 means "present"; a real steady_clock reading is never 0.
+        const std::int64_t ns = std::max<std::int64_t>(
+            1, std::chrono::duration_cast<std::chrono::nanoseconds>(since->time_since_epoch())
+                   .count());
+        m_AwaySinceNs.store(ns, std::memory_order_release);
+        toAway.Inc();
+        spdlog::info("Idle: user away ({})", m_Locked ? "session locked" : "idle hint");
+    } else {
+        m_AwaySinceNs.store(0, std::memory_order_release);
+        toActive.Inc();
+        spdlog::info("Idle: user active");
+    }
+
+    if (m_OnChange) {
+        m_OnChange();
+    }
+}
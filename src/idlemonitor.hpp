@@ -0,0 +1,72 @@
+#pragma once
+
+#include <dbus/dbus.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+#include "reactor.hpp"
+
+// Whether the user is at the machine, from the logind session on the system bus: the session's
+// IdleHint (set by the desktop or by an idle daemon, e.g. `swayidle idlehint <timeout>`) and its
+// LockedHint. The user counts as away once IdleHint has been set for `threshold`, or as soon as
+// the session is locked.
+//
+// The system bus address can be overridden with DBUS_SYSTEM_BUS_ADDRESS, which is how
+// resources/fake-logind.py stands in for logind.
+class IdleMonitor {
+  public:
+    // `onChange` runs on `reactor` after every away/active transition.
+    IdleMonitor(Reactor &reactor, std::chrono::seconds threshold, std::function<void()> onChange);
+    ~IdleMonitor();
+
+    IdleMonitor(const IdleMonitor &) = delete;
+    IdleMonitor &operator=(const IdleMonitor &) = delete;
+
+    // Returns false when logind cannot be reached now; it is retried in the background and the
+    // user counts as present meanwhile.
+    bool Start();
+
+    // When the user went away (the IdleSinceHint, or the lock), or nullopt while present.
+    // Safe from any thread.
+    std::optional<std::chrono::steady_clock::time_point> AwaySince() const;
+    bool IsAway() const;
+
+  private:
+    static DBusHandlerResult FilterHandler(DBusConnection *conn, DBusMessage *msg,
+                                           void *user_data);
+    DBusHandlerResult HandleFilter(DBusMessage *msg);
+
+    bool Connect();
+    void Disconnect();
+    void ScheduleReconnect(const char *reason, std::chrono::milliseconds delay);
+    std::string ResolveSessionPath();
+    bool FetchProperties();
+    // Reads IdleHint, IdleSinceHintMonotonic and LockedHint from an a{sv}; returns true when one
+    // of them was present.
+    bool ApplyProperties(DBusMessageIter *dict);
+    void Evaluate();
+    void SetAway(std::optional<std::chrono::steady_clock::time_point> since);
+
+  private:
+    Reactor &m_Reactor;
+    const std::chrono::seconds m_Threshold;
+    std::function<void()> m_OnChange;
+
+    // Reactor thread only.
+    DBusConnection *m_Conn = nullptr;
+    std::string m_SessionPath;
+    std::string m_MatchRule;
+    bool m_IdleHint = false;
+    std::chrono::steady_clock::time_point m_IdleSince{};
+    bool m_Locked = false;
+    Reactor::TimerId m_AwayTimer = 0;
+    Reactor::TimerId m_ReconnectTimer = 0;
+
+    // steady_clock nanoseconds since epoch of the away start; 0 while present.
+    std::atomic<std::int64_t> m_AwaySinceNs{0};
+};
@@ -0,0 +1,171 @@
+#include "ipctape.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <charconv>
+#include <cstdint>
+#include <sstream>
+
+static constexpr std::string_view kMagic = "#concentrate-tape";
+
+// ─────────────────────────────────────
+IpcTape::Recorder::Recorder(const std::filesystem::path &path, std::string_view backend)
+    : m_Out(path, std::ios::out | std::ios::trunc), m_Start(std::chrono::steady_clock::now()) {
+    if (!m_Out) {
+        spdlog::error("Failed to open IPC tape '{}' for writing", path.string());
+        return;
+    }
+    m_Out << kMagic << ' ' << kVersion << ' ' << backend << '\n';
+    m_Out.flush();
+}
+
+// ─────────────────────────────────────
+bool IpcTape::Recorder::IsOpen() const {
+    return m_Out.is_open() && m_Out.good();
+}
+
+// ─────────────────────────────────────
+void IpcTape::Recorder::Event(std::string_view line) {
+    Append('E', {}, line);
+}
+
+// ─────────────────────────────────────
+void IpcTape::Recorder::Query(std::string_view request, std::string_view reply) {
+    Append('Q', request, reply);
+}
+
+// ─────────────────────────────────────
+void IpcTape::Recorder::Append(char kind, std::string_view request, std::string_view data) {
+    const auto at = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_Start);
+
+    std::string record = std::to_string(at.count());
+    record.push_back('\t');
+    record.push_back(kind);
+    record.push_back('\t');
+    if (kind == 'Q') {
+        record += Escape(request);
+        record.push_back('\t');
+    }
+    record += Escape(data);
+    record.push_back('\n');
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Out) {
+        return;
+    }
+    m_Out.write(record.data(), static_cast<std::streamsize>(record.size()));
+    m_Out.flush();
+}
+
+// ─────────────────────────────────────
+std::string IpcTape::Escape(std::string_view field) {
+    std::string out;
+    out.reserve(field.size());
+    for (const char c : field) {
+        switch (c) {
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            out.push_back(c);
+            break;
+        }
+    }
+    return out;
+}
+
+// ─────────────────────────────────────
+std::string IpcTape::Unescape(std::string_view field) {
+    std::string out;
+    out.reserve(field.size());
+    for (std::size_t i = 0; i < field.size(); ++i) {
+        if (field[i] != '\\' || i + 1 == field.size()) {
+            out.push_back(field[i]);
+            continue;
+        }
+        const char next = field[++i];
+        out.push_back(next == 't' ? '\t' : next == 'n' ? '\n' : next);
+    }
+    return out;
+}
+
+// ─────────────────────────────────────
+bool IpcTape::Load(const std::filesystem::path &path, std::string &backend,
+                   std::vector<Record> &records, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path.string();
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line)) {
+        error = path.string() + " is empty";
+        return false;
+    }
+
+    std::istringstream header(line);
+    std::string magic;
+    int version = 0;
+    header >> magic >> version >> backend;
+    if (magic != kMagic || version != kVersion || backend.empty()) {
+        error = path.string() + " is not a version " + std::to_string(kVersion) + " IPC tape";
+        return false;
+    }
+
+    records.clear();
+    std::size_t lineNo = 1;
+    std::size_t skipped = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        const std::string_view view(line);
+
+        // <ms> \t <kind> \t [<request> \t] <data>
+        const auto tab1 = view.find('\t');
+        std::int64_t ms = -1;
+        bool valid = tab1 != std::string_view::npos && view.find('\t', tab1 + 1) == tab1 + 2;
+        if (valid) {
+            const auto [end, ec] = std::from_chars(view.data(), view.data() + tab1, ms);
+            valid = ec == std::errc() && end == view.data() + tab1 && ms >= 0;
+        }
+        if (!valid) {
+            spdlog::debug("IPC tape {}:{}: malformed record", path.string(), lineNo);
+            ++skipped;
+            continue;
+        }
+
+        Record record;
+        record.at = std::chrono::milliseconds(ms);
+        std::string_view rest = view.substr(tab1 + 3);
+        const char kind = view[tab1 + 1];
+        if (kind == 'E') {
+            record.kind = Kind::Event;
+        } else if (kind == 'Q') {
+            const auto sep = rest.find('\t');
+            if (sep == std::string_view::npos) {
+                ++skipped;
+                continue;
+            }
+            record.kind = Kind::Query;
+            record.request = Unescape(rest.substr(0, sep));
+            rest = rest.substr(sep + 1);
+        } else {
+            ++skipped;
+            continue;
+        }
+        record.data = Unescape(rest);
+        records.push_back(std::move(record));
+    }
+
+    if (skipped > 0) {
+        spdlog::warn("IPC tape {}: skipped {} malformed records", path.string(), skipped);
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compositor IPC traffic on disk, so a real session can be fed through the tracker again
+// (--record / --replay). A tape is a text file, one record per line:
+//
+//   #concentrate-tape 1 <backend>
+//   <ms>\tE\t<event stream line>
+//   <ms>\tQ\t<request>\t<raw reply>
+//
+// <ms> counts from the start of the recording. Backslashes, tabs and newlines inside a field
+// are written as \\, \t and \n, so multi-line replies (Hyprland's socket1) stay on one line.
+class IpcTape {
+  public:
+    static constexpr int kVersion = 1;
+
+    enum class Kind { Event, Query };
+
+    struct Record {
+        std::chrono::milliseconds at{0};
+        Kind kind = Kind::Event;
+        std::string request; // Query only
+        std::string data;    // the stream line, or the reply
+    };
+
+    // Answers a query from the tape during replay: the raw reply, or nullopt when there is none
+    // (as if the compositor had not answered).
+    using ReplySource = std::function<std::optional<std::string>(std::string_view request)>;
+
+    // Appends records as they happen. Thread-safe; every record is flushed, since a recording
+    // usually ends by killing the process.
+    class Recorder {
+      public:
+        Recorder(const std::filesystem::path &path, std::string_view backend);
+
+        Recorder(const Recorder &) = delete;
+        Recorder &operator=(const Recorder &) = delete;
+
+        bool IsOpen() const;
+        void Event(std::string_view line);
+        void Query(std::string_view request, std::string_view reply);
+
+      private:
+        void Append(char kind, std::string_view request, std::string_view data);
+
+        std::mutex m_Mutex;
+        std::ofstream m_Out;
+        const std::chrono::steady_clock::time_point m_Start;
+    };
+
+    // Reads a whole tape. Returns false with `error` set for a missing file or a foreign header;
+    // malformed records are skipped.
+    static bool Load(const std::filesystem::path &path, std::string &backend,
+                     std::vector<Record> &records, std::string &error);
+
+    static std::string Escape(std::string_view field);
+    static std::string Unescape(std::string_view field);
+};
@@ -0,0 +1,141 @@
+#include "lineframer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+static constexpr std::size_t kReadChunk = 64 * 1024;
+
+// ─────────────────────────────────────
+LineFramer::LineFramer(std::size_t maxLine) : m_MaxLine(maxLine) {}
+
+// ─────────────────────────────────────
+std::optional<std::string_view> LineFramer::Next() {
+    const std::size_t from = std::max(m_Begin, m_Scan);
+    const void *nl = from < m_End ? std::memchr(m_Buffer.data() + from, '\n', m_End - from)
+                                  : nullptr;
+    if (nl == nullptr) {
+        m_Scan = m_End;
+        return std::nullopt;
+    }
+
+    const std::size_t pos = static_cast<const char *>(nl) - m_Buffer.data();
+    std::string_view line(m_Buffer.data() + m_Begin, pos - m_Begin);
+    m_Begin = pos + 1;
+    m_Scan = m_Begin;
+    if (m_Begin == m_End) {
+        // Everything consumed: the next read starts at the front again, no move needed.
+        m_Begin = m_End = m_Scan = 0;
+    }
+    return line;
+}
+
+// ─────────────────────────────────────
+void LineFramer::Reserve(std::size_t want) {
+    if (m_Buffer.size() - m_End >= want) {
+        return;
+    }
+    if (m_Begin > 0) {
+        std::memmove(m_Buffer.data(), m_Buffer.data() + m_Begin, m_End - m_Begin);
+        m_End -= m_Begin;
+        m_Scan -= std::min(m_Scan, m_Begin);
+        m_Begin = 0;
+    }
+    if (m_Buffer.size() - m_End < want) {
+        m_Buffer.resize(std::max(m_Buffer.size() * 2, m_End + want));
+    }
+}
+
+// ─────────────────────────────────────
+void LineFramer::Append(std::string_view data) {
+    Reserve(data.size());
+    std::memcpy(m_Buffer.data() + m_End, data.data(), data.size());
+    m_End += data.size();
+}
+
+// ─────────────────────────────────────
+LineFramer::Result LineFramer::ReadLine(int fd, std::chrono::milliseconds timeout,
+                                        std::string_view &line) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        if (auto next = Next()) {
+            line = *next;
+            return Result::Line;
+        }
+        // Next() found no newline, so everything buffered belongs to one line.
+        if (Buffered() > m_MaxLine) {
+            return Result::TooLong;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return Result::Timeout;
+        }
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now);
+
+        pollfd pfd{fd, POLLIN, 0};
+        const int rc = ::poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return Result::Error;
+        }
+        if (rc == 0) {
+            return Result::Timeout;
+        }
+        if ((pfd.revents & (POLLERR | POLLNVAL)) != 0) {
+            return Result::Error;
+        }
+
+        // POLLHUP may come together with the last bytes; recv() returns 0 once they are read.
+        Reserve(kReadChunk);
+        const ssize_t n =
+            ::recv(fd, m_Buffer.data() + m_End, m_Buffer.size() - m_End, MSG_DONTWAIT);
+        if (n == 0) {
+            return Result::Closed;
+        }
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+                continue;
+            }
+            return Result::Error;
+        }
+        m_End += static_cast<std::size_t>(n);
+    }
+}
+
+// ─────────────────────────────────────
+LineFramer::Result LineFramer::Drain(int fd,
+                                     const std::function<void(std::string_view line)> &onLine) {
+    while (true) {
+        Reserve(kReadChunk);
+        const ssize_t n =
+            ::recv(fd, m_Buffer.data() + m_End, m_Buffer.size() - m_End, MSG_DONTWAIT);
+        if (n == 0) {
+            return Result::Closed;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? Result::Timeout : Result::Error;
+        }
+        m_End += static_cast<std::size_t>(n);
+
+        while (auto line = Next()) {
+            onLine(*line);
+        }
+        if (Buffered() > m_MaxLine) {
+            return Result::TooLong;
+        }
+    }
+}
+
+// ─────────────────────────────────────
+void LineFramer::Clear() {
+    m_Begin = m_End = m_Scan = 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+// Splits a byte stream (compositor IPC sockets) into '\n'-terminated lines.
+//
+// Reads accumulate in one buffer until a full line is available, however many recv() calls
+// that takes, and lines are returned as views into that buffer instead of copies. Consumed
+// bytes are only reclaimed (by moving the unread tail to the front) when the buffer runs out of
+// room, so most reads neither copy nor allocate. A line longer than the configured limit is
+// reported instead of growing the buffer without bound.
+class LineFramer {
+  public:
+    enum class Result { Line, Timeout, Closed, TooLong, Error };
+
+    // Niri's initial WindowsChanged event grows with the number of windows.
+    static constexpr std::size_t kDefaultMaxLine = 4 * 1024 * 1024;
+
+    explicit LineFramer(std::size_t maxLine = kDefaultMaxLine);
+
+    // Next complete line already buffered, without the trailing '\n'. The view stays valid
+    // until the next call to Next(), Append() or ReadLine().
+    std::optional<std::string_view> Next();
+
+    // Buffers bytes obtained elsewhere; Next() then splits them like socket data.
+    void Append(std::string_view data);
+
+    // Returns the next line, reading from `fd` (poll + recv) as needed until `timeout`.
+    Result ReadLine(int fd, std::chrono::milliseconds timeout, std::string_view &line);
+
+    // Non-blocking variant for event loops: reads whatever `fd` has, calls `onLine` for every
+    // complete line, and returns Timeout once the socket has no more data for now.
+    Result Drain(int fd, const std::function<void(std::string_view line)> &onLine);
+
+    void Clear();
+    std::size_t Buffered() const {
+        return m_End - m_Begin;
+    }
+
+  private:
+    // Makes room for at least `want` more bytes at the end of the buffer.
+    void Reserve(std::size_t want);
+
+    std::size_t m_MaxLine;
+    std::vector<char> m_Buffer;
+    std::size_t m_Begin = 0; // first unconsumed byte
+    std::size_t m_End = 0;   // one past the last buffered byte
+    std::size_t m_Scan = 0;  // bytes before this were already searched for '\n'
+};
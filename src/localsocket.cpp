@@ -0,0 +1,256 @@
+#include "localsocket.hpp"
+#include "metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ─────────────────────────────────────
+LocalCommandSocket::LocalCommandSocket(std::filesystem::path path, Handler handler)
+    : m_Path(std::move(path)), m_Handler(std::move(handler)) {}
+
+// ─────────────────────────────────────
+LocalCommandSocket::~LocalCommandSocket() {
+    Stop();
+}
+
+// ─────────────────────────────────────
+bool LocalCommandSocket::Start() {
+    if (m_Running.load()) {
+        return true;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    const std::string path = m_Path.string();
+    if (path.size() >= sizeof(addr.sun_path)) {
+        spdlog::error("Command socket path too long: {}", path);
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    m_ListenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (m_ListenFd < 0) {
+        spdlog::error("Command socket: socket() failed: {}", std::strerror(errno));
+        return false;
+    }
+
+    // A previous instance may have left the file behind; the single-instance lock in main()
+    // guarantees nobody is listening on it anymore.
+    ::unlink(path.c_str());
+
+    if (bind(m_ListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::chmod(path.c_str(), 0600) != 0 || listen(m_ListenFd, 16) != 0) {
+        spdlog::error("Command socket: failed to listen on {}: {}", path, std::strerror(errno));
+        close(m_ListenFd);
+        m_ListenFd = -1;
+        return false;
+    }
+
+    m_WakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_WakeFd < 0) {
+        spdlog::error("Command socket: eventfd() failed: {}", std::strerror(errno));
+        close(m_ListenFd);
+        m_ListenFd = -1;
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    m_Running.store(true);
+    m_Thread = std::thread([this] { Run(); });
+    spdlog::info("Command socket listening on {}", path);
+    return true;
+}
+
+// ─────────────────────────────────────
+void LocalCommandSocket::Stop() {
+    if (!m_Running.exchange(false)) {
+        return;
+    }
+
+    const std::uint64_t one = 1;
+    if (write(m_WakeFd, &one, sizeof(one)) < 0) {
+        spdlog::debug("Command socket: failed to wake listener: {}", std::strerror(errno));
+    }
+    if (m_Thread.joinable()) {
+        m_Thread.join();
+    }
+
+    for (const auto &[fd, client] : m_Clients) {
+        close(fd);
+    }
+    m_Clients.clear();
+
+    close(m_WakeFd);
+    m_WakeFd = -1;
+    close(m_ListenFd);
+    m_ListenFd = -1;
+    ::unlink(m_Path.c_str());
+}
+
+// ─────────────────────────────────────
+void LocalCommandSocket::Run() {
+    std::vector<pollfd> fds;
+    std::vector<int> closed;
+
+    while (m_Running.load()) {
+        fds.clear();
+        fds.push_back({m_WakeFd, POLLIN, 0});
+        fds.push_back({m_ListenFd, POLLIN, 0});
+        for (const auto &[fd, client] : m_Clients) {
+            fds.push_back({fd, POLLIN, 0});
+        }
+
+        const int rc = poll(fds.data(), fds.size(), -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            spdlog::error("Command socket: poll() failed: {}", std::strerror(errno));
+            break;
+        }
+
+        if (fds[0].revents != 0) {
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            while (true) {
+                const int fd = accept4(m_ListenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+                if (fd < 0) {
+                    break;
+                }
+                if (m_Clients.size() >= kMaxClients) {
+                    spdlog::warn("Command socket: too many clients, rejecting connection");
+                    close(fd);
+                    continue;
+                }
+                m_Clients.emplace(fd, Client{});
+            }
+        }
+
+        closed.clear();
+        for (std::size_t i = 2; i < fds.size(); ++i) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            auto it = m_Clients.find(fds[i].fd);
+            if (it == m_Clients.end() || !HandleReadable(it->first, it->second)) {
+                closed.push_back(fds[i].fd);
+            }
+        }
+        for (const int fd : closed) {
+            close(fd);
+            m_Clients.erase(fd);
+        }
+    }
+}
+
+// ─────────────────────────────────────
+bool LocalCommandSocket::HandleReadable(int fd, Client &client) {
+    char chunk[4096];
+    while (true) {
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n == 0) {
+            return false;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.buffer.append(chunk, static_cast<std::size_t>(n));
+
+        // Lines are answered as each chunk arrives, so the buffer only ever holds one
+        // unterminated line (bounded below) plus a chunk, however fast the client writes.
+        std::size_t start = 0;
+        while (true) {
+            const std::size_t end = client.buffer.find('\n', start);
+            if (end == std::string::npos) {
+                break;
+            }
+
+            std::string_view line(client.buffer.data() + start, end - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            start = end + 1;
+
+            if (line.empty()) {
+                continue;
+            }
+            if (!SendLine(fd, Dispatch(line))) {
+                return false;
+            }
+        }
+        client.buffer.erase(0, start);
+
+        if (client.buffer.size() > kMaxLineBytes) {
+            SendLine(fd, R"({"ok":false,"error":"line too long"})");
+            return false;
+        }
+    }
+}
+
+// ─────────────────────────────────────
+std::string LocalCommandSocket::Dispatch(std::string_view line) {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_ctl_command_duration_seconds", "Command socket request handling time.");
+    Metrics::ScopedTimer timer(timing);
+
+    nlohmann::json command;
+    try {
+        command = nlohmann::json::parse(line);
+    } catch (const std::exception &) {
+        return R"({"ok":false,"error":"invalid JSON"})";
+    }
+
+    nlohmann::json reply;
+    try {
+        reply = m_Handler(command);
+    } catch (const std::exception &e) {
+        reply = {{"ok", false}, {"error", e.what()}};
+    }
+
+    // Lets clients pipeline several commands and match the answers.
+    if (command.is_object() && command.contains("id")) {
+        reply["id"] = command["id"];
+    }
+    return reply.dump();
+}
+
+// ─────────────────────────────────────
+bool LocalCommandSocket::SendLine(int fd, const std::string &line) {
+    std::string out = line;
+    out.push_back('\n');
+
+    std::size_t sent = 0;
+    while (sent < out.size()) {
+        const ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Replies are tiny; wait briefly for a slow reader instead of blocking others.
+                pollfd pfd{fd, POLLOUT, 0};
+                if (poll(&pfd, 1, 100) > 0) {
+                    continue;
+                }
+            }
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
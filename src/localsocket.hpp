@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+// Newline-delimited JSON command channel on a Unix socket.
+//
+// Each line received is parsed as one JSON command and answered with exactly one JSON line, in
+// order, on the same connection. Connections are persistent, so an editor plugin can keep one
+// socket open and push context changes without spawning processes or paying for HTTP framing.
+// Access control is the socket file mode (0600, inside a 0700 directory).
+class LocalCommandSocket {
+  public:
+    using Handler = std::function<nlohmann::json(const nlohmann::json &command)>;
+
+    LocalCommandSocket(std::filesystem::path path, Handler handler);
+    ~LocalCommandSocket();
+
+    bool Start();
+    void Stop();
+
+    const std::filesystem::path &GetPath() const {
+        return m_Path;
+    }
+
+  private:
+    struct Client {
+        std::string buffer;
+    };
+
+    void Run();
+    bool HandleReadable(int fd, Client &client);
+    bool SendLine(int fd, const std::string &line);
+    std::string Dispatch(std::string_view line);
+
+    static constexpr std::size_t kMaxLineBytes = 64 * 1024;
+    static constexpr std::size_t kMaxClients = 64;
+
+    const std::filesystem::path m_Path;
+    const Handler m_Handler;
+
+    int m_ListenFd = -1;
+    int m_WakeFd = -1;
+    std::unordered_map<int, Client> m_Clients;
+    std::atomic<bool> m_Running{false};
+    std::thread m_Thread;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Small bounded map that evicts the least recently used entry. Not thread-safe: owners guard it
+// with their own mutex.
+template <typename Key, typename Value, typename Hash = std::hash<Key>> class LruCache {
+  public:
+    explicit LruCache(std::size_t capacity) : m_Capacity(capacity) {}
+
+    // Returns the cached value (and marks it most recently used), or nullptr. The pointer is
+    // valid until the next Put/Erase/Clear.
+    const Value *Find(const Key &key) {
+        auto it = m_Index.find(key);
+        if (it == m_Index.end()) {
+            return nullptr;
+        }
+        m_Order.splice(m_Order.begin(), m_Order, it->second);
+        return &it->second->second;
+    }
+
+    void Put(const Key &key, Value value) {
+        auto it = m_Index.find(key);
+        if (it != m_Index.end()) {
+            it->second->second = std::move(value);
+            m_Order.splice(m_Order.begin(), m_Order, it->second);
+            return;
+        }
+
+        m_Order.emplace_front(key, std::move(value));
+        m_Index.emplace(key, m_Order.begin());
+        if (m_Order.size() > m_Capacity) {
+            m_Index.erase(m_Order.back().first);
+            m_Order.pop_back();
+        }
+    }
+
+    bool Erase(const Key &key) {
+        auto it = m_Index.find(key);
+        if (it == m_Index.end()) {
+            return false;
+        }
+        m_Order.erase(it->second);
+        m_Index.erase(it);
+        return true;
+    }
+
+    void Clear() {
+        m_Index.clear();
+        m_Order.clear();
+    }
+
+    std::size_t Size() const {
+        return m_Order.size();
+    }
+
+  private:
+    using Entry = std::pair<Key, Value>;
+
+    std::size_t m_Capacity;
+    std::list<Entry> m_Order; // most recently used first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> m_Index;
+};
@@ -13,12 +13,25 @@ int main(int argc, char *argv[]) {
 
     auto print_usage = [](const char *exe) {
         std::cerr << "Usage: " << exe
-                  << " [--port <1-65535>] [--ping <seconds>] [--logdebug|--loginfo|--logoff]\n";
+                  << " [--port <1-65535>] [--ping <seconds>] [--context-settle-ms <0-10000>]"
+                     " [--anytype-refresh <seconds>] [--idle-after <seconds>]"
+                     " [--focus-settle-ms <0-60000>]"
+                     " [--record <tape>] [--replay <tape> [--replay-speed <0-1000>]"
+                     " [--replay-db <file>]]"
+                     " [--logdebug|--loginfo|--logoff]\n";
     };
 
     unsigned ServerPort = 7079;
     unsigned PingEach = 1; // Seconds to request AppID from Window
     LogLevel log_level = LOG_OFF; // default
+    unsigned ContextSettleMs = 300;
+    unsigned AnytypeRefresh = 60;
+    unsigned IdleAfter = 0;
+    unsigned FocusSettleMs = 2000;
+    std::string RecordPath;
+    std::string ReplayPath;
+    unsigned ReplaySpeed = 0; // as fast as possible
+    std::string ReplayDb;
 
     auto parse_u32 = [&](const std::string &value, const char *flag, unsigned long min, unsigned long max, unsigned &out) -> bool {
         try {
@@ -106,11 +119,197 @@ int main(int argc, char *argv[]) {
             continue;
         }
 
+        if (arg == "--context-settle-ms" || arg.rfind("--context-settle-ms=", 0) == 0) {
+            std::string value;
+            if (arg == "--context-settle-ms") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--context-settle-ms requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                value = argv[++i];
+            } else {
+                value = arg.substr(std::string("--context-settle-ms=").size());
+            }
+
+            if (!parse_u32(value, "--context-settle-ms", 0, 10000, ContextSettleMs)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--anytype-refresh" || arg.rfind("--anytype-refresh=", 0) == 0) {
+            std::string value;
+            if (arg == "--anytype-refresh") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--anytype-refresh requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                value = argv[++i];
+            } else {
+                value = arg.substr(std::string("--anytype-refresh=").size());
+            }
+
+            if (!parse_u32(value, "--anytype-refresh", 5, 86400, AnytypeRefresh)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--idle-after" || arg.rfind("--idle-after=", 0) == 0) {
+            std::string value;
+            if (arg == "--idle-after") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--idle-after requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                value = argv[++i];
+            } else {
+                value = arg.substr(std::string("--idle-after=").size());
+            }
+
+            if (!parse_u32(value, "--idle-after", 0, 86400, IdleAfter)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--focus-settle-ms" || arg.rfind("--focus-settle-ms=", 0) == 0) {
+            std::string value;
+            if (arg == "--focus-settle-ms") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--focus-settle-ms requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                value = argv[++i];
+            } else {
+                value = arg.substr(std::string("--focus-settle-ms=").size());
+            }
+
+            if (!parse_u32(value, "--focus-settle-ms", 0, 60000, FocusSettleMs)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--record" || arg.rfind("--record=", 0) == 0) {
+            if (arg == "--record") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--record requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                RecordPath = argv[++i];
+            } else {
+                RecordPath = arg.substr(std::string("--record=").size());
+            }
+
+            if (RecordPath.empty()) {
+                std::cerr << "--record requires a value" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--replay" || arg.rfind("--replay=", 0) == 0) {
+            if (arg == "--replay") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--replay requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                ReplayPath = argv[++i];
+            } else {
+                ReplayPath = arg.substr(std::string("--replay=").size());
+            }
+
+            if (ReplayPath.empty()) {
+                std::cerr << "--replay requires a value" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--replay-speed" || arg.rfind("--replay-speed=", 0) == 0) {
+            std::string value;
+            if (arg == "--replay-speed") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--replay-speed requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                value = argv[++i];
+            } else {
+                value = arg.substr(std::string("--replay-speed=").size());
+            }
+
+            if (!parse_u32(value, "--replay-speed", 0, 1000, ReplaySpeed)) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
+        if (arg == "--replay-db" || arg.rfind("--replay-db=", 0) == 0) {
+            if (arg == "--replay-db") {
+                if (i + 1 >= argc) {
+                    std::cerr << "--replay-db requires a value" << std::endl;
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                ReplayDb = argv[++i];
+            } else {
+                ReplayDb = arg.substr(std::string("--replay-db=").size());
+            }
+
+            if (ReplayDb.empty()) {
+                std::cerr << "--replay-db requires a value" << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+            continue;
+        }
+
         std::cerr << "Unknown argument: " << arg << std::endl;
         print_usage(argv[0]);
         return 1;
     }
 
+    if (!RecordPath.empty() && !ReplayPath.empty()) {
+        std::cerr << "--record and --replay cannot be combined" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    RuntimeOptions options;
+    options.port = ServerPort;
+    options.ping = PingEach;
+    options.logLevel = log_level;
+    options.contextSettle = std::chrono::milliseconds(ContextSettleMs);
+    options.anytypeRefresh = std::chrono::seconds(AnytypeRefresh);
+    options.idleAfter = std::chrono::seconds(IdleAfter);
+    options.focusSettle = std::chrono::milliseconds(FocusSettleMs);
+    options.recordPath = RecordPath;
+    options.replayPath = ReplayPath;
+    options.replaySpeed = ReplaySpeed;
+    options.replayDb = ReplayDb;
+
+    // A replay touches neither the session nor the real database, so it may run next to the
+    // tracker.
+    if (!ReplayPath.empty()) {
+        Concentrate concentrate(options);
+        return 0;
+    }
+
     // Single-instance guard (Linux): lock a per-user file in XDG_RUNTIME_DIR (or /tmp).
     const char *runtime_dir = std::getenv("XDG_RUNTIME_DIR");
     std::string lock_dir = runtime_dir && *runtime_dir ? runtime_dir : "/tmp";
@@ -130,6 +329,6 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    Concentrate concentrate(ServerPort, PingEach, log_level);
+    Concentrate concentrate(options);
     return 0;
 }
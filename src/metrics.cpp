@@ -0,0 +1,161 @@
+#include "metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+// ─────────────────────────────────────
+void Metrics::Histogram::Observe(std::chrono::nanoseconds elapsed) {
+    const auto nanos = elapsed.count() > 0 ? static_cast<std::uint64_t>(elapsed.count()) : 0;
+    const double seconds = static_cast<double>(nanos) / 1e9;
+
+    std::size_t bucket = kBounds.size();
+    for (std::size_t i = 0; i < kBounds.size(); ++i) {
+        if (seconds <= kBounds[i]) {
+            bucket = i;
+            break;
+        }
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    sumNanos.fetch_add(nanos, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ─────────────────────────────────────
+Metrics &Metrics::Instance() {
+    static Metrics instance;
+    return instance;
+}
+
+// ─────────────────────────────────────
+Metrics::Counter &Metrics::GetCounter(std::string_view name, std::string_view help,
+                                      std::string labels) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Families.find(name);
+    if (it == m_Families.end()) {
+        it = m_Families.emplace(std::string(name), Family{std::string(help), false, {}, {}}).first;
+    }
+
+    Family &family = it->second;
+    if (family.histogram) {
+        spdlog::error("Metrics: '{}' is registered as a histogram", name);
+    }
+
+    auto existing = family.counters.find(labels);
+    if (existing != family.counters.end()) {
+        return *existing->second;
+    }
+
+    Counter &counter = m_Counters.emplace_back();
+    family.counters.emplace(std::move(labels), &counter);
+    return counter;
+}
+
+// ─────────────────────────────────────
+Metrics::Histogram &Metrics::GetHistogram(std::string_view name, std::string_view help,
+                                          std::string labels) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Families.find(name);
+    if (it == m_Families.end()) {
+        it = m_Families.emplace(std::string(name), Family{std::string(help), true, {}, {}}).first;
+    }
+
+    Family &family = it->second;
+    if (!family.histogram) {
+        spdlog::error("Metrics: '{}' is registered as a counter", name);
+    }
+
+    auto existing = family.histograms.find(labels);
+    if (existing != family.histograms.end()) {
+        return *existing->second;
+    }
+
+    Histogram &histogram = m_Histograms.emplace_back();
+    family.histograms.emplace(std::move(labels), &histogram);
+    return histogram;
+}
+
+// ─────────────────────────────────────
+std::string
+Metrics::Labels(std::initializer_list<std::pair<std::string_view, std::string_view>> labels) {
+    std::string out;
+    for (const auto &[key, value] : labels) {
+        if (!out.empty()) {
+            out += ',';
+        }
+        out += key;
+        out += "=\"";
+        for (const char c : value) {
+            switch (c) {
+            case '\\':
+                out += "\\\\";
+                break;
+            case '"':
+                out += "\\\"";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            default:
+                out += c;
+            }
+        }
+        out += '"';
+    }
+    return out;
+}
+
+// ─────────────────────────────────────
+std::string Metrics::Render() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::string out;
+    out.reserve(16 * 1024);
+
+    const auto withLabels = [](const std::string &labels, const std::string &extra) {
+        if (labels.empty() && extra.empty()) {
+            return std::string{};
+        }
+        if (labels.empty()) {
+            return "{" + extra + "}";
+        }
+        if (extra.empty()) {
+            return "{" + labels + "}";
+        }
+        return "{" + labels + "," + extra + "}";
+    };
+
+    for (const auto &[name, family] : m_Families) {
+        out += fmt::format("# HELP {} {}\n", name, family.help);
+        out += fmt::format("# TYPE {} {}\n", name, family.histogram ? "histogram" : "counter");
+
+        if (!family.histogram) {
+            for (const auto &[labels, counter] : family.counters) {
+                out += fmt::format("{}{} {}\n", name, withLabels(labels, ""),
+                                   counter->value.load(std::memory_order_relaxed));
+            }
+            continue;
+        }
+
+        for (const auto &[labels, histogram] : family.histograms) {
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < Histogram::kBounds.size(); ++i) {
+                cumulative += histogram->buckets[i].load(std::memory_order_relaxed);
+                out += fmt::format("{}_bucket{} {}\n", name,
+                                   withLabels(labels, fmt::format("le=\"{}\"",
+                                                                  Histogram::kBounds[i])),
+                                   cumulative);
+            }
+            cumulative +=
+                histogram->buckets[Histogram::kBounds.size()].load(std::memory_order_relaxed);
+            out += fmt::format("{}_bucket{} {}\n", name, withLabels(labels, "le=\"+Inf\""),
+                               cumulative);
+            out += fmt::format(
+                "{}_sum{} {:.9f}\n", name, withLabels(labels, ""),
+                static_cast<double>(histogram->sumNanos.load(std::memory_order_relaxed)) / 1e9);
+            out += fmt::format("{}_count{} {}\n", name, withLabels(labels, ""),
+                               histogram->count.load(std::memory_order_relaxed));
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Process-wide metrics registry rendered in the Prometheus text format.
+//
+// Registration (GetCounter/GetHistogram) takes a mutex and is meant to happen once per call
+// site (cache the returned reference, e.g. in a function-local static). Updating a metric is a
+// handful of relaxed atomic adds, so instrumentation is safe on hot paths.
+class Metrics {
+  public:
+    struct Counter {
+        std::atomic<std::uint64_t> value{0};
+
+        void Inc(std::uint64_t n = 1) {
+            value.fetch_add(n, std::memory_order_relaxed);
+        }
+    };
+
+    struct Histogram {
+        // Upper bounds in seconds; tuned for local calls (sub-ms) up to slow network requests.
+        static constexpr std::array<double, 14> kBounds = {
+            0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+            0.01,    0.025,  0.05,    0.1,    0.25,  1.0,    5.0};
+
+        std::array<std::atomic<std::uint64_t>, kBounds.size() + 1> buckets{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sumNanos{0};
+
+        void Observe(std::chrono::nanoseconds elapsed);
+    };
+
+    // Records the lifetime of the scope into a histogram.
+    class ScopedTimer {
+      public:
+        explicit ScopedTimer(Histogram &histogram)
+            : m_Histogram(histogram), m_Start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            m_Histogram.Observe(std::chrono::steady_clock::now() - m_Start);
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+      private:
+        Histogram &m_Histogram;
+        std::chrono::steady_clock::time_point m_Start;
+    };
+
+    static Metrics &Instance();
+
+    // `labels` is the rendered label set without braces, see Labels().
+    Counter &GetCounter(std::string_view name, std::string_view help, std::string labels = {});
+    Histogram &GetHistogram(std::string_view name, std::string_view help,
+                            std::string labels = {});
+
+    // Builds an escaped label set: Labels({{"route", "/x"}}) -> route="/x"
+    static std::string
+    Labels(std::initializer_list<std::pair<std::string_view, std::string_view>> labels);
+
+    std::string Render() const;
+
+  private:
+    Metrics() = default;
+
+    struct Family {
+        std::string help;
+        bool histogram = false;
+        std::map<std::string, Counter *> counters;
+        std::map<std::string, Histogram *> histograms;
+    };
+
+    mutable std::mutex m_Mutex;
+    std::map<std::string, Family, std::less<>> m_Families;
+
+    // deque keeps element addresses stable while growing.
+    std::deque<Counter> m_Counters;
+    std::deque<Histogram> m_Histograms;
+};
@@ -1,11 +1,13 @@
 #include "niri.hpp"
+#include "lineframer.hpp"
+#include "metrics.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <cerrno>
 #include <cstring>
 
-#include <poll.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -121,77 +123,49 @@ bool NiriIPC::SendAll(int fd, const void *data, std::size_t size) {
     return true;
 }
 
-// ─────────────────────────────────────
-bool NiriIPC::ReadLine(int fd, std::string &out_line, std::string &buffer,
-                      std::chrono::milliseconds timeout) {
-    out_line.clear();
-
-    const auto find_newline = [&buffer]() -> std::size_t { return buffer.find('\n'); };
-
-    // Fast path: we already have a full line.
-    if (auto pos = find_newline(); pos != std::string::npos) {
-        out_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        return true;
-    }
-
-    pollfd pfd;
-    pfd.fd = fd;
-    pfd.events = POLLIN;
-    pfd.revents = 0;
-
-    const int rc = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
-    if (rc <= 0) {
-        return false;
-    }
-
-    if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
-        return false;
-    }
-
-    char tmp[4096];
-    const ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
-    if (n <= 0) {
-        return false;
-    }
-
-    buffer.append(tmp, static_cast<std::size_t>(n));
-
-    if (auto pos = find_newline(); pos != std::string::npos) {
-        out_line = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);
-        return true;
-    }
-
-    // No full line yet.
-    return false;
-}
-
 // ─────────────────────────────────────
 std::optional<nlohmann::json> NiriIPC::SendEnumRequest(const std::string &enum_name,
                                                      std::chrono::milliseconds timeout) {
-    if (!ConnectQuery()) {
-        return std::nullopt;
-    }
+    std::string reply;
+    if (m_Replies) {
+        reply = m_Replies(enum_name).value_or(std::string{});
+        if (reply.empty()) {
+            return std::nullopt;
+        }
+    } else {
+        static auto &timing = Metrics::Instance().GetHistogram(
+            "concentrate_ipc_query_duration_seconds", "Round trip of compositor IPC queries.",
+            Metrics::Labels({{"backend", "niri"}}));
+        Metrics::ScopedTimer timer(timing);
+
+        if (!ConnectQuery()) {
+            return std::nullopt;
+        }
 
-    const std::string request = "\"" + enum_name + "\"\n";
-    if (!SendAll(m_QueryFd, request.data(), request.size())) {
-        spdlog::warn("Failed to send niri IPC request");
-        DisconnectQuery();
-        return std::nullopt;
-    }
+        const std::string request = "\"" + enum_name + "\"\n";
+        if (!SendAll(m_QueryFd, request.data(), request.size())) {
+            spdlog::warn("Failed to send niri IPC request");
+            DisconnectQuery();
+            return std::nullopt;
+        }
 
-    std::string buffer;
-    std::string line;
-    if (!ReadLine(m_QueryFd, line, buffer, timeout)) {
-        // Either timeout or the connection got closed; keep behavior conservative.
-        spdlog::debug("No response from niri IPC (timeout/disconnect)");
-        DisconnectQuery();
-        return std::nullopt;
+        LineFramer framer;
+        std::string_view line;
+        if (framer.ReadLine(m_QueryFd, timeout, line) != LineFramer::Result::Line) {
+            // Timeout, disconnect or an oversized reply; the connection state is unknown either
+            // way.
+            spdlog::debug("No response from niri IPC (timeout/disconnect)");
+            DisconnectQuery();
+            return std::nullopt;
+        }
+        reply.assign(line);
+        if (m_Recorder) {
+            m_Recorder->Query(enum_name, reply);
+        }
     }
 
     try {
-        return nlohmann::json::parse(line);
+        return nlohmann::json::parse(reply);
     } catch (const std::exception &e) {
         spdlog::warn("Failed to parse niri IPC response JSON: {}", e.what());
         return std::nullopt;
@@ -212,9 +186,10 @@ bool NiriIPC::HasAnyOfKeys(const nlohmann::json &j, const std::vector<std::strin
 }
 
 // ─────────────────────────────────────
-bool NiriIPC::StartEventStream(std::function<void(const nlohmann::json &event)> callback,
-                              std::vector<std::string> only_events,
-                              std::chrono::milliseconds reconnect_delay) {
+bool NiriIPC::StartEventStream(Reactor &reactor,
+                               std::function<void(const nlohmann::json &event)> callback,
+                               std::vector<std::string> only_events,
+                               std::chrono::milliseconds reconnect_delay) {
     if (m_StreamRunning.load()) {
         return true;
     }
@@ -223,86 +198,252 @@ bool NiriIPC::StartEventStream(std::function<void(const nlohmann::json &event)>
         return false;
     }
 
-    m_StopStream.store(false);
+    m_Reactor = &reactor;
+    m_StreamCallback = std::move(callback);
+    m_StreamOnly = std::move(only_events);
+    m_ReconnectDelay = reconnect_delay;
     m_StreamRunning.store(true);
+    ConnectStream();
+    return true;
+}
 
-    m_StreamThread = std::thread([this, callback, only_events = std::move(only_events),
-                                  reconnect_delay]() {
-        while (!m_StopStream.load()) {
-            // Establish a dedicated stream connection.
-            CloseFd(m_StreamFd);
+// ─────────────────────────────────────
+void NiriIPC::ConnectStream() {
+    m_ReconnectTimer = 0;
+    if (!ConnectFd(m_StreamFd)) {
+        ScheduleReconnect();
+        return;
+    }
 
-            if (!ConnectFd(m_StreamFd)) {
-                std::this_thread::sleep_for(reconnect_delay);
-                continue;
-            }
+    const std::string subscribe = "\"EventStream\"\n";
+    if (!SendAll(m_StreamFd, subscribe.data(), subscribe.size())) {
+        spdlog::debug("Failed to subscribe to Niri EventStream");
+        CloseFd(m_StreamFd);
+        ScheduleReconnect();
+        return;
+    }
 
-            const std::string subscribe = "\"EventStream\"\n";
-            if (!SendAll(m_StreamFd, subscribe.data(), subscribe.size())) {
-                spdlog::debug("Failed to subscribe to Niri EventStream");
-                CloseFd(m_StreamFd);
-                std::this_thread::sleep_for(reconnect_delay);
-                continue;
-            }
+    m_StreamFramer.Clear();
+    if (!m_Reactor->Watch(m_StreamFd, EPOLLIN, [this](std::uint32_t) { OnStreamReadable(); })) {
+        CloseFd(m_StreamFd);
+        ScheduleReconnect();
+    }
+}
 
-            std::string buffer;
-            std::string line;
+// ─────────────────────────────────────
+void NiriIPC::ScheduleReconnect() {
+    m_ReconnectTimer = m_Reactor->AddTimer(std::chrono::steady_clock::now() + m_ReconnectDelay,
+                                           [this] { ConnectStream(); });
+}
 
-            while (!m_StopStream.load()) {
-                if (!ReadLine(m_StreamFd, line, buffer, std::chrono::milliseconds(30000))) {
-                    // Reconnect.
-                    break;
-                }
+// ─────────────────────────────────────
+void NiriIPC::OnStreamReadable() {
+    static auto &reconnects = Metrics::Instance().GetCounter(
+        "concentrate_ipc_reconnects_total", "Compositor event stream reconnects.",
+        Metrics::Labels({{"backend", "niri"}}));
+
+    const auto result = m_StreamFramer.Drain(
+        m_StreamFd, [this](std::string_view line) { HandleStreamLine(line); });
+    if (result == LineFramer::Result::Timeout) {
+        return; // drained; partial lines stay buffered
+    }
+    if (result == LineFramer::Result::TooLong) {
+        spdlog::warn("Niri event exceeds {} bytes; reconnecting", LineFramer::kDefaultMaxLine);
+    }
 
-                if (line.empty()) {
-                    continue;
-                }
+    CloseStream();
+    reconnects.Inc();
+    ScheduleReconnect();
+}
 
-                nlohmann::json ev;
-                try {
-                    ev = nlohmann::json::parse(line);
-                } catch (const std::exception &e) {
-                    spdlog::debug("Ignoring non-JSON niri stream line: {}", e.what());
-                    continue;
-                }
+// ─────────────────────────────────────
+void NiriIPC::HandleStreamLine(std::string_view line) {
+    static auto &events = Metrics::Instance().GetCounter(
+        "concentrate_ipc_events_total", "Compositor events delivered to the tracker.",
+        Metrics::Labels({{"backend", "niri"}}));
 
-                if (!only_events.empty() && !HasAnyOfKeys(ev, only_events)) {
-                    continue;
-                }
+    if (line.empty()) {
+        return;
+    }
+    if (m_Recorder) {
+        m_Recorder->Event(line);
+    }
 
-                try {
-                    callback(ev);
-                } catch (...) {
-                    // Never let callbacks kill the stream thread.
-                }
-            }
+    nlohmann::json ev;
+    try {
+        ev = nlohmann::json::parse(line);
+    } catch (const std::exception &e) {
+        spdlog::debug("Ignoring non-JSON niri stream line: {}", e.what());
+        return;
+    }
 
-            CloseFd(m_StreamFd);
-            if (!m_StopStream.load()) {
-                std::this_thread::sleep_for(reconnect_delay);
-            }
-        }
+    ApplyWindowEvent(ev);
 
-        CloseFd(m_StreamFd);
-        m_StreamRunning.store(false);
-    });
+    if (!m_StreamOnly.empty() && !HasAnyOfKeys(ev, m_StreamOnly)) {
+        return;
+    }
 
-    return true;
+    events.Inc();
+    try {
+        if (m_StreamCallback) {
+            m_StreamCallback(ev);
+        }
+    } catch (...) {
+        // Never let callbacks break the event loop.
+    }
 }
 
 // ─────────────────────────────────────
-void NiriIPC::StopEventStream() {
-    m_StopStream.store(true);
+void NiriIPC::CloseStream() {
+    if (m_StreamFd >= 0) {
+        m_Reactor->Unwatch(m_StreamFd);
+    }
+    CloseFd(m_StreamFd);
+    // Events may be missed until the next WindowsChanged.
+    ResetWindowTable();
+}
 
-    if (m_StreamThread.joinable()) {
-        m_StreamThread.join();
+// ─────────────────────────────────────
+void NiriIPC::StopEventStream() {
+    if (!m_StreamRunning.exchange(false)) {
+        return;
     }
 
-    CloseFd(m_StreamFd);
-    m_StreamRunning.store(false);
+    if (m_ReconnectTimer != 0) {
+        m_Reactor->CancelTimer(m_ReconnectTimer);
+        m_ReconnectTimer = 0;
+    }
+    CloseStream();
 }
 
 // ─────────────────────────────────────
 bool NiriIPC::IsEventStreamRunning() const {
     return m_StreamRunning.load();
 }
+
+// ─────────────────────────────────────
+std::shared_ptr<const NiriWindowTable> NiriIPC::GetWindowTable() const {
+    return m_WindowTable.load(std::memory_order_acquire);
+}
+
+// ─────────────────────────────────────
+void NiriIPC::SetRecorder(IpcTape::Recorder *recorder) {
+    m_Recorder = recorder;
+}
+
+// ─────────────────────────────────────
+void NiriIPC::StartReplay(std::function<void(const nlohmann::json &event)> callback,
+                          std::vector<std::string> only_events, IpcTape::ReplySource replies) {
+    m_StreamCallback = std::move(callback);
+    m_StreamOnly = std::move(only_events);
+    m_Replies = std::move(replies);
+    ResetWindowTable();
+}
+
+// ─────────────────────────────────────
+void NiriIPC::ReplayStreamLine(std::string_view line) {
+    HandleStreamLine(line);
+}
+
+// ─────────────────────────────────────
+NiriWindow NiriIPC::ParseWindow(const nlohmann::json &w) {
+    NiriWindow window;
+    if (w.contains("id") && w["id"].is_number_unsigned()) {
+        window.id = w["id"].get<std::uint64_t>();
+    } else if (w.contains("id") && w["id"].is_number_integer()) {
+        window.id = static_cast<std::uint64_t>(w["id"].get<std::int64_t>());
+    }
+    if (w.contains("app_id") && w["app_id"].is_string()) {
+        window.app_id = w["app_id"].get<std::string>();
+    }
+    if (w.contains("title") && w["title"].is_string()) {
+        window.title = w["title"].get<std::string>();
+    }
+    if (w.contains("workspace_id") && w["workspace_id"].is_number()) {
+        window.workspace_id = w["workspace_id"].get<std::uint64_t>();
+    }
+    window.is_focused =
+        w.contains("is_focused") && w["is_focused"].is_boolean() && w["is_focused"].get<bool>();
+    return window;
+}
+
+// ─────────────────────────────────────
+void NiriIPC::ApplyWindowEvent(const nlohmann::json &ev) {
+    if (!ev.is_object() || ev.empty()) {
+        return;
+    }
+
+    const auto &[name, body] = *ev.items().begin();
+    if (!body.is_object()) {
+        return;
+    }
+
+    const auto setFocused = [this](std::optional<std::uint64_t> id) {
+        m_StreamFocusedId = id;
+        for (auto &[windowId, window] : m_StreamWindows) {
+            window.is_focused = id && windowId == *id;
+        }
+    };
+
+    if (name == "WindowsChanged") {
+        m_StreamWindows.clear();
+        m_StreamFocusedId.reset();
+        if (body.contains("windows") && body["windows"].is_array()) {
+            for (const auto &w : body["windows"]) {
+                NiriWindow window = ParseWindow(w);
+                if (window.is_focused) {
+                    m_StreamFocusedId = window.id;
+                }
+                m_StreamWindows[window.id] = std::move(window);
+            }
+        }
+        m_StreamSeeded = true;
+    } else if (name == "WindowOpenedOrChanged") {
+        if (!body.contains("window") || !body["window"].is_object()) {
+            return;
+        }
+        NiriWindow window = ParseWindow(body["window"]);
+        const std::uint64_t id = window.id;
+        const bool focused = window.is_focused;
+        m_StreamWindows[id] = std::move(window);
+        if (focused) {
+            setFocused(id);
+        } else if (m_StreamFocusedId == id) {
+            setFocused(std::nullopt);
+        }
+    } else if (name == "WindowClosed") {
+        if (!body.contains("id") || !body["id"].is_number()) {
+            return;
+        }
+        const auto id = body["id"].get<std::uint64_t>();
+        m_StreamWindows.erase(id);
+        if (m_StreamFocusedId == id) {
+            m_StreamFocusedId.reset();
+        }
+    } else if (name == "WindowFocusChanged") {
+        if (body.contains("id") && body["id"].is_number()) {
+            setFocused(body["id"].get<std::uint64_t>());
+        } else {
+            setFocused(std::nullopt);
+        }
+    } else {
+        return;
+    }
+
+    if (!m_StreamSeeded) {
+        return;
+    }
+
+    auto table = std::make_shared<NiriWindowTable>();
+    table->windows = m_StreamWindows;
+    table->focused_id = m_StreamFocusedId;
+    m_WindowTable.store(std::move(table), std::memory_order_release);
+}
+
+// ─────────────────────────────────────
+void NiriIPC::ResetWindowTable() {
+    m_StreamWindows.clear();
+    m_StreamFocusedId.reset();
+    m_StreamSeeded = false;
+    m_WindowTable.store(nullptr, std::memory_order_release);
+}
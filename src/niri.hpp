@@ -2,14 +2,43 @@
 
 #include <nlohmann/json.hpp>
 
+#include "ipctape.hpp"
+#include "lineframer.hpp"
+#include "reactor.hpp"
+
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
-#include <thread>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+struct NiriWindow {
+    std::uint64_t id = 0;
+    std::string app_id;
+    std::string title;
+    std::optional<std::uint64_t> workspace_id;
+    bool is_focused = false;
+};
+
+// Windows as known from the event stream: seeded by the initial WindowsChanged event and kept
+// up to date from WindowOpenedOrChanged / WindowClosed / WindowFocusChanged.
+struct NiriWindowTable {
+    std::unordered_map<std::uint64_t, NiriWindow> windows;
+    std::optional<std::uint64_t> focused_id;
+
+    const NiriWindow *Focused() const {
+        if (!focused_id) {
+            return nullptr;
+        }
+        auto it = windows.find(*focused_id);
+        return it == windows.end() ? nullptr : &it->second;
+    }
+};
 
 class NiriIPC {
   public:
@@ -31,30 +60,67 @@ class NiriIPC {
                                        std::chrono::milliseconds timeout =
                                            std::chrono::milliseconds(1000));
 
-    // Event stream connection (long-lived).
-    bool StartEventStream(std::function<void(const nlohmann::json &event)> callback,
+    // Event stream connection (long-lived), driven by `reactor`: the callback, reconnects and
+    // the window table updates all run on the reactor thread. Start/Stop from that thread too.
+    bool StartEventStream(Reactor &reactor,
+                          std::function<void(const nlohmann::json &event)> callback,
                           std::vector<std::string> only_events,
                           std::chrono::milliseconds reconnect_delay =
                               std::chrono::milliseconds(1000));
     void StopEventStream();
     bool IsEventStreamRunning() const;
 
+    // Latest window table published by the event stream, or null while the stream is not
+    // connected or has not received WindowsChanged yet (callers then fall back to queries).
+    // Lock-free; safe from any thread.
+    std::shared_ptr<const NiriWindowTable> GetWindowTable() const;
+
+    // Record-and-replay (see IpcTape). While a recorder is set, raw stream lines and query
+    // replies are appended to it; it must outlive the connection.
+    void SetRecorder(IpcTape::Recorder *recorder);
+    // Replay instead of StartEventStream: stream lines come from ReplayStreamLine() and queries
+    // are answered by `replies`, without touching the socket. Single-threaded, no reactor.
+    void StartReplay(std::function<void(const nlohmann::json &event)> callback,
+                     std::vector<std::string> only_events, IpcTape::ReplySource replies);
+    void ReplayStreamLine(std::string_view line);
+
   private:
     static std::string GetEnvSocketPath();
     bool ConnectFd(int &fd);
     static void CloseFd(int &fd);
     bool SendAll(int fd, const void *data, std::size_t size);
-    bool ReadLine(int fd, std::string &out_line, std::string &buffer,
-                  std::chrono::milliseconds timeout);
     static bool HasAnyOfKeys(const nlohmann::json &j, const std::vector<std::string> &keys);
+    static NiriWindow ParseWindow(const nlohmann::json &w);
+
+    // Reactor thread only.
+    void ConnectStream();
+    void ScheduleReconnect();
+    void OnStreamReadable();
+    void HandleStreamLine(std::string_view line);
+    void CloseStream();
+    // Updates m_StreamWindows from one event and republishes the table.
+    void ApplyWindowEvent(const nlohmann::json &ev);
+    void ResetWindowTable();
 
   private:
     std::string m_SocketPath;
 
     int m_QueryFd = -1;
+    IpcTape::Recorder *m_Recorder = nullptr;
+    IpcTape::ReplySource m_Replies;
 
     std::atomic<bool> m_StreamRunning{false};
-    std::atomic<bool> m_StopStream{false};
-    std::thread m_StreamThread;
+    Reactor *m_Reactor = nullptr;
+    std::function<void(const nlohmann::json &event)> m_StreamCallback;
+    std::vector<std::string> m_StreamOnly;
+    std::chrono::milliseconds m_ReconnectDelay{1000};
+    Reactor::TimerId m_ReconnectTimer = 0;
     int m_StreamFd = -1;
+    LineFramer m_StreamFramer;
+
+    // Owned by the reactor thread; readers only see the published copies.
+    std::unordered_map<std::uint64_t, NiriWindow> m_StreamWindows;
+    std::optional<std::uint64_t> m_StreamFocusedId;
+    bool m_StreamSeeded = false;
+    std::atomic<std::shared_ptr<const NiriWindowTable>> m_WindowTable;
 };
@@ -1,9 +1,11 @@
 #include "notification.hpp"
+#include "dbusdispatch.hpp"
+#include "metrics.hpp"
 #include <iostream>
 #include <cstring>
 #include <spdlog/spdlog.h>
 
-Notification::Notification() {
+Notification::Notification(Reactor &reactor) : m_Reactor(reactor) {
     dbus_error_init(&m_Err);
     m_Conn = dbus_bus_get(DBUS_BUS_SESSION, &m_Err);
     if (dbus_error_is_set(&m_Err) || !m_Conn) {
@@ -28,11 +30,19 @@ Notification::Notification() {
         dbus_connection_add_filter(m_Conn, &Notification::DBusSignalFilter, this, nullptr);
         dbus_connection_flush(m_Conn);
     }
+
+    DBusDispatch::Attach(m_Reactor, m_Conn);
 }
 
 // ─────────────────────────────────────
 Notification::~Notification() {
+    for (const auto &[id, prompt] : m_HydrationPrompts) {
+        m_Reactor.CancelTimer(prompt.expiry);
+    }
+
     if (m_Conn) {
+        DBusDispatch::Detach(m_Conn);
+        dbus_connection_remove_filter(m_Conn, &Notification::DBusSignalFilter, this);
         dbus_connection_unref(m_Conn);
         m_Conn = nullptr;
     }
@@ -160,7 +170,14 @@ uint32_t Notification::SendYesNoNotification(const std::string &icon, const std:
     dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &timeout);
 
     // ── Send + wait reply to get notification id ──
-    DBusMessage *reply = dbus_connection_send_with_reply_and_block(m_Conn, m, -1, nullptr);
+    DBusMessage *reply = nullptr;
+    {
+        static auto &timing = Metrics::Instance().GetHistogram(
+            "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+            Metrics::Labels({{"call", "Notify"}}));
+        Metrics::ScopedTimer timer(timing);
+        reply = dbus_connection_send_with_reply_and_block(m_Conn, m, -1, nullptr);
+    }
 
     dbus_message_unref(m);
 
@@ -233,7 +250,14 @@ uint32_t Notification::SendHydrationPrompt(const std::string &icon, const std::s
 
     dbus_message_iter_append_basic(&args, DBUS_TYPE_INT32, &timeout);
 
-    DBusMessage *reply = dbus_connection_send_with_reply_and_block(m_Conn, m, -1, nullptr);
+    DBusMessage *reply = nullptr;
+    {
+        static auto &timing = Metrics::Instance().GetHistogram(
+            "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+            Metrics::Labels({{"call", "Notify"}}));
+        Metrics::ScopedTimer timer(timing);
+        reply = dbus_connection_send_with_reply_and_block(m_Conn, m, -1, nullptr);
+    }
     dbus_message_unref(m);
 
     uint32_t notif_id = 0;
@@ -250,7 +274,10 @@ uint32_t Notification::SendHydrationPrompt(const std::string &icon, const std::s
 
     m_HydrationPrompts[notif_id] = {
         .prompted_at = std::chrono::system_clock::now(),
+        .closed_at = std::nullopt,
         .callback = std::move(callback),
+        .expiry = m_Reactor.AddTimer(std::chrono::steady_clock::now() + std::chrono::minutes(2),
+                                     [this, notif_id] { ExpireHydrationPrompt(notif_id); }),
     };
 
     spdlog::info("Hydration prompt sent with notification id={}", notif_id);
@@ -259,35 +286,20 @@ uint32_t Notification::SendHydrationPrompt(const std::string &icon, const std::s
 }
 
 // ─────────────────────────────────────
-void Notification::Poll() {
-    if (!m_Conn) {
+void Notification::ExpireHydrationPrompt(uint32_t id) {
+    auto it = m_HydrationPrompts.find(id);
+    if (it == m_HydrationPrompts.end()) {
         return;
     }
 
-    // Raw libdbus pattern: read + write + dispatch to drive filters/signals.
-    while (dbus_connection_get_dispatch_status(m_Conn) == DBUS_DISPATCH_DATA_REMAINS) {
-        dbus_connection_dispatch(m_Conn);
-    }
-    dbus_connection_read_write_dispatch(m_Conn, 0);
-    while (dbus_connection_get_dispatch_status(m_Conn) == DBUS_DISPATCH_DATA_REMAINS) {
-        dbus_connection_dispatch(m_Conn);
-    }
-
     const auto now = std::chrono::system_clock::now();
-    for (auto it = m_HydrationPrompts.begin(); it != m_HydrationPrompts.end();) {
-        const bool timedOut = now - it->second.prompted_at >= std::chrono::minutes(2);
-
-        if (timedOut) {
-            const double prompted_at =
-                std::chrono::duration<double>(it->second.prompted_at.time_since_epoch()).count();
-            const double answered_at = std::chrono::duration<double>(now.time_since_epoch()).count();
-            spdlog::warn("Hydration prompt fallback to unknown (timedOut=true)");
-            it->second.callback("unknown", prompted_at, answered_at);
-            it = m_HydrationPrompts.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    const double prompted_at =
+        std::chrono::duration<double>(it->second.prompted_at.time_since_epoch()).count();
+    const double answered_at = std::chrono::duration<double>(now.time_since_epoch()).count();
+    spdlog::warn("Hydration prompt fallback to unknown (timedOut=true)");
+    auto callback = std::move(it->second.callback);
+    m_HydrationPrompts.erase(it);
+    callback("unknown", prompted_at, answered_at);
 }
 
 // ─────────────────────────────────────
@@ -334,6 +346,7 @@ void Notification::HandleSignalMessage(DBusMessage *message) {
                 (action_str == "yes" || action_str == "default" || action_str == "1")
                     ? "yes"
                     : "no";
+            m_Reactor.CancelTimer(hydrationIt->second.expiry);
             hydrationIt->second.callback(answer, prompted_at, answered_at);
             m_HydrationPrompts.erase(hydrationIt);
         }
@@ -8,25 +8,30 @@
 #include <string>
 #include <unordered_map>
 
+#include "reactor.hpp"
+
 class Notification {
   public:
     using HydrationResponseCallback =
         std::function<void(const std::string &answer, double prompted_at, double answered_at)>;
 
-    Notification();
+    // Signals (action clicks, closes) are dispatched on `reactor`, which also times out
+    // unanswered hydration prompts.
+    explicit Notification(Reactor &reactor);
     ~Notification();
     void SendNotification(const std::string icon, const std::string summary, const std::string msg);
     uint32_t SendYesNoNotification(const std::string &icon, const std::string &summary,
                                    const std::string &msg, std::function<void(bool)> callback);
     uint32_t SendHydrationPrompt(const std::string &icon, const std::string &summary,
                                  const std::string &msg, HydrationResponseCallback callback);
-    void Poll();
 
   private:
     static DBusHandlerResult DBusSignalFilter(DBusConnection *connection, DBusMessage *message,
                                               void *user_data);
     void HandleSignalMessage(DBusMessage *message);
+    void ExpireHydrationPrompt(uint32_t id);
 
+    Reactor &m_Reactor;
     DBusError m_Err;
     DBusConnection *m_Conn;
     DBusMessage *m_Msg;
@@ -39,6 +44,7 @@ class Notification {
       std::chrono::time_point<std::chrono::system_clock> prompted_at;
       std::optional<std::chrono::time_point<std::chrono::system_clock>> closed_at;
       HydrationResponseCallback callback;
+      Reactor::TimerId expiry = 0;
     };
 
     std::unordered_map<uint32_t, PendingHydrationPrompt> m_HydrationPrompts;
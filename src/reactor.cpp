@@ -0,0 +1,253 @@
+#include "reactor.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// ─────────────────────────────────────
+Reactor::Reactor() {
+    m_Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    m_TimerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    m_WakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_Epoll < 0 || m_TimerFd < 0 || m_WakeFd < 0) {
+        spdlog::error("Failed to create the event loop: {}", std::strerror(errno));
+        for (int *fd : {&m_Epoll, &m_TimerFd, &m_WakeFd}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+        return;
+    }
+
+    for (const int fd : {m_TimerFd, m_WakeFd}) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        ::epoll_ctl(m_Epoll, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// ─────────────────────────────────────
+Reactor::~Reactor() {
+    for (const int fd : {m_Epoll, m_TimerFd, m_WakeFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+// ─────────────────────────────────────
+bool Reactor::Watch(int fd, std::uint32_t events, FdHandler handler) {
+    if (!IsValid() || fd < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    // The fd may have been closed and reused behind our back, so fall back either way.
+    const bool known = m_Fds.contains(fd);
+    int rc = ::epoll_ctl(m_Epoll, known ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    if (rc != 0 && (errno == ENOENT || errno == EEXIST)) {
+        rc = ::epoll_ctl(m_Epoll, known ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+    }
+    if (rc != 0) {
+        spdlog::warn("epoll_ctl failed for fd {}: {}", fd, std::strerror(errno));
+        return false;
+    }
+
+    m_Fds[fd] = std::make_shared<FdHandler>(std::move(handler));
+    return true;
+}
+
+// ─────────────────────────────────────
+void Reactor::Unwatch(int fd) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Fds.erase(fd) > 0) {
+        ::epoll_ctl(m_Epoll, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+// ─────────────────────────────────────
+Reactor::TimerId Reactor::AddTimer(Clock::time_point when, std::function<void()> handler) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    const TimerId id = m_NextTimerId++;
+    m_Timers.emplace(std::make_pair(when, id), std::move(handler));
+    m_TimerDeadlines.emplace(id, when);
+    ArmTimerFd(std::min(m_RunDeadline, m_Timers.begin()->first.first));
+    return id;
+}
+
+// ─────────────────────────────────────
+void Reactor::CancelTimer(TimerId id) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_TimerDeadlines.find(id);
+    if (it == m_TimerDeadlines.end()) {
+        return;
+    }
+    m_Timers.erase(std::make_pair(it->second, id));
+    m_TimerDeadlines.erase(it);
+    // Leaving the timerfd armed for a cancelled deadline only costs one spurious wakeup.
+}
+
+// ─────────────────────────────────────
+void Reactor::Post(std::function<void()> fn) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Posted.push_back(std::move(fn));
+    }
+    const std::uint64_t one = 1;
+    (void)!::write(m_WakeFd, &one, sizeof(one));
+}
+
+// ─────────────────────────────────────
+void Reactor::Wake() {
+    m_WakeRequested.store(true, std::memory_order_release);
+    const std::uint64_t one = 1;
+    (void)!::write(m_WakeFd, &one, sizeof(one));
+}
+
+// ─────────────────────────────────────
+void Reactor::ArmTimerFd(Clock::time_point when) {
+    // Caller holds m_Mutex.
+    if (when == m_ArmedFor) {
+        return;
+    }
+    m_ArmedFor = when;
+
+    itimerspec spec{};
+    if (when != Clock::time_point::max()) {
+        // steady_clock is CLOCK_MONOTONIC; an all-zero it_value would disarm instead of firing.
+        const auto ns = std::max<std::int64_t>(
+            1, std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch())
+                   .count());
+        spec.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        spec.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    }
+    ::timerfd_settime(m_TimerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+// ─────────────────────────────────────
+void Reactor::RunDueTimers() {
+    while (true) {
+        std::function<void()> handler;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Timers.empty() || m_Timers.begin()->first.first > Clock::now()) {
+                ArmTimerFd(std::min(m_RunDeadline, m_Timers.empty()
+                                                       ? Clock::time_point::max()
+                                                       : m_Timers.begin()->first.first));
+                return;
+            }
+            auto it = m_Timers.begin();
+            handler = std::move(it->second);
+            m_TimerDeadlines.erase(it->first.second);
+            m_Timers.erase(it);
+        }
+        try {
+            handler();
+        } catch (const std::exception &e) {
+            spdlog::error("Timer handler failed: {}", e.what());
+        }
+    }
+}
+
+// ─────────────────────────────────────
+void Reactor::RunPosted() {
+    std::vector<std::function<void()>> posted;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        posted.swap(m_Posted);
+    }
+    for (auto &fn : posted) {
+        try {
+            fn();
+        } catch (const std::exception &e) {
+            spdlog::error("Posted handler failed: {}", e.what());
+        }
+    }
+}
+
+// ─────────────────────────────────────
+bool Reactor::RunUntil(Clock::time_point deadline) {
+    if (!IsValid()) {
+        std::this_thread::sleep_until(deadline);
+        return m_WakeRequested.exchange(false);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_RunDeadline = deadline;
+        ArmTimerFd(std::min(deadline, m_Timers.empty() ? Clock::time_point::max()
+                                                       : m_Timers.begin()->first.first));
+    }
+
+    bool woken = false;
+    std::array<epoll_event, 32> events{};
+    while (true) {
+        RunPosted();
+        RunDueTimers();
+        if (m_WakeRequested.exchange(false, std::memory_order_acq_rel)) {
+            woken = true;
+            break;
+        }
+        if (Clock::now() >= deadline) {
+            break;
+        }
+
+        const int n = ::epoll_wait(m_Epoll, events.data(), static_cast<int>(events.size()), -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            spdlog::error("epoll_wait failed: {}", std::strerror(errno));
+            std::this_thread::sleep_until(deadline);
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            std::uint64_t value = 0;
+            if (fd == m_WakeFd) {
+                (void)!::read(m_WakeFd, &value, sizeof(value));
+                continue;
+            }
+            if (fd == m_TimerFd) {
+                (void)!::read(m_TimerFd, &value, sizeof(value));
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_ArmedFor = Clock::time_point::max();
+                continue;
+            }
+
+            std::shared_ptr<FdHandler> handler;
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (auto it = m_Fds.find(fd); it != m_Fds.end()) {
+                    handler = it->second;
+                }
+            }
+            if (!handler) {
+                continue; // unwatched earlier in this batch
+            }
+            try {
+                (*handler)(events[i].events);
+            } catch (const std::exception &e) {
+                spdlog::error("Handler for fd {} failed: {}", fd, e.what());
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_RunDeadline = Clock::time_point::max();
+    return woken;
+}
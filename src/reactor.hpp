@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// epoll-based event loop for the main thread.
+//
+// File descriptors (compositor sockets, DBus connections) and one-shot timers are multiplexed
+// on a single epoll instance; timers share one timerfd armed for the earliest deadline, and an
+// eventfd lets other threads wake the loop. Handlers always run on the thread inside
+// RunUntil(). Registration (Watch/Unwatch/AddTimer/CancelTimer/Post/Wake) is safe from any
+// thread, which libdbus needs because it updates its watches from whichever thread uses the
+// connection.
+class Reactor {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using FdHandler = std::function<void(std::uint32_t events)>;
+    using TimerId = std::uint64_t;
+
+    Reactor();
+    ~Reactor();
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+
+    // False when epoll/timerfd/eventfd could not be created; RunUntil() then just sleeps.
+    bool IsValid() const {
+        return m_Epoll >= 0;
+    }
+
+    // Registers `fd` (or replaces its interest set and handler) for EPOLLIN/EPOLLOUT; errors
+    // and hangups are always reported. Level-triggered.
+    bool Watch(int fd, std::uint32_t events, FdHandler handler);
+    void Unwatch(int fd);
+
+    // One-shot timer. Returns an id that stays unique for the reactor's lifetime (never 0).
+    TimerId AddTimer(Clock::time_point when, std::function<void()> handler);
+    void CancelTimer(TimerId id);
+
+    // Runs `fn` on the loop thread during the current or next RunUntil().
+    void Post(std::function<void()> fn);
+
+    // Makes the current or next RunUntil() return true.
+    void Wake();
+
+    // Dispatches events until `deadline` or a Wake(). Returns true when woken.
+    bool RunUntil(Clock::time_point deadline);
+
+  private:
+    void ArmTimerFd(Clock::time_point when);
+    void RunDueTimers();
+    void RunPosted();
+
+    int m_Epoll = -1;
+    int m_TimerFd = -1;
+    int m_WakeFd = -1;
+    std::atomic<bool> m_WakeRequested{false};
+
+    std::mutex m_Mutex;
+    std::unordered_map<int, std::shared_ptr<FdHandler>> m_Fds;
+    std::map<std::pair<Clock::time_point, TimerId>, std::function<void()>> m_Timers;
+    std::unordered_map<TimerId, Clock::time_point> m_TimerDeadlines;
+    TimerId m_NextTimerId = 1;
+    Clock::time_point m_ArmedFor = Clock::time_point::max();
+    Clock::time_point m_RunDeadline = Clock::time_point::max();
+    std::vector<std::function<void()>> m_Posted;
+};
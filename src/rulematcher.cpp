@@ -0,0 +1,99 @@
+#include "rulematcher.hpp"
+
+#include <algorithm>
+#include <queue>
+
+// ─────────────────────────────────────
+void RuleMatcher::Builder::AddAppId(std::string_view pattern, std::uint32_t rule) {
+    m_AppIds.emplace_back(std::string(pattern), rule);
+}
+
+// ─────────────────────────────────────
+void RuleMatcher::Builder::AddTitle(std::string_view pattern, std::uint32_t rule) {
+    m_Titles.emplace_back(std::string(pattern), rule);
+}
+
+// ─────────────────────────────────────
+std::shared_ptr<const RuleMatcher> RuleMatcher::Builder::Build() const {
+    auto matcher = std::make_shared<RuleMatcher>();
+    matcher->m_AppIds.Compile(m_AppIds);
+    matcher->m_Titles.Compile(m_Titles);
+    matcher->m_PatternCount = m_AppIds.size() + m_Titles.size();
+    return matcher;
+}
+
+// ─────────────────────────────────────
+std::uint32_t RuleMatcher::Match(std::string_view appId, std::string_view title) const {
+    return std::min(m_AppIds.Scan(appId), m_Titles.Scan(title));
+}
+
+// ─────────────────────────────────────
+void RuleMatcher::Automaton::Compile(
+    const std::vector<std::pair<std::string, std::uint32_t>> &patterns) {
+    classOf.fill(0);
+    classes = 1;
+    for (const auto &[pattern, rule] : patterns) {
+        for (const unsigned char c : pattern) {
+            if (classOf[c] == 0) {
+                classOf[c] = static_cast<std::uint16_t>(classes++);
+            }
+        }
+    }
+
+    // Trie; kNoMatch doubles as "no edge" while building.
+    next.assign(classes, kNoMatch);
+    best.assign(1, kNoMatch);
+    for (const auto &[pattern, rule] : patterns) {
+        std::uint32_t state = 0;
+        for (const unsigned char c : pattern) {
+            std::uint32_t &edge = next[state * classes + classOf[c]];
+            if (edge == kNoMatch) {
+                edge = static_cast<std::uint32_t>(best.size());
+                best.push_back(kNoMatch);
+                next.resize(next.size() + classes, kNoMatch);
+            }
+            state = next[state * classes + classOf[c]];
+        }
+        best[state] = std::min(best[state], rule);
+    }
+
+    // Breadth-first: fill missing edges from the failure state (turning the trie into a DFA)
+    // and fold each state's failure chain into `best`.
+    std::vector<std::uint32_t> fail(best.size(), 0);
+    std::queue<std::uint32_t> pending;
+    for (std::uint32_t c = 0; c < classes; ++c) {
+        std::uint32_t &edge = next[c];
+        if (edge == kNoMatch) {
+            edge = 0;
+        } else {
+            fail[edge] = 0;
+            pending.push(edge);
+        }
+    }
+    while (!pending.empty()) {
+        const std::uint32_t state = pending.front();
+        pending.pop();
+        best[state] = std::min(best[state], best[fail[state]]);
+        for (std::uint32_t c = 0; c < classes; ++c) {
+            std::uint32_t &edge = next[state * classes + c];
+            const std::uint32_t fallback = next[fail[state] * classes + c];
+            if (edge == kNoMatch) {
+                edge = fallback;
+            } else {
+                fail[edge] = fallback;
+                pending.push(edge);
+            }
+        }
+    }
+}
+
+// ─────────────────────────────────────
+std::uint32_t RuleMatcher::Automaton::Scan(std::string_view text) const {
+    std::uint32_t result = best[0]; // empty patterns
+    std::uint32_t state = 0;
+    for (const unsigned char c : text) {
+        state = next[state * classes + classOf[c]];
+        result = std::min(result, best[state]);
+    }
+    return result;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Substring rules over a window's app_id and title, compiled into two Aho-Corasick automata.
+//
+// Every pattern belongs to a rule id; Match() returns the lowest rule id with a pattern that
+// occurs in the app_id (app patterns) or the title (title patterns). That is one pass over each
+// string, whatever the number of rules. Matching is byte-wise and case-sensitive, like
+// std::string::find; an empty pattern matches every window.
+//
+// Instances are immutable once built, so one can be shared between threads.
+class RuleMatcher {
+  public:
+    static constexpr std::uint32_t kNoMatch = std::numeric_limits<std::uint32_t>::max();
+
+    class Builder {
+      public:
+        void AddAppId(std::string_view pattern, std::uint32_t rule);
+        void AddTitle(std::string_view pattern, std::uint32_t rule);
+        std::shared_ptr<const RuleMatcher> Build() const;
+
+      private:
+        friend class RuleMatcher;
+        std::vector<std::pair<std::string, std::uint32_t>> m_AppIds;
+        std::vector<std::pair<std::string, std::uint32_t>> m_Titles;
+    };
+
+    std::uint32_t Match(std::string_view appId, std::string_view title) const;
+    std::size_t PatternCount() const {
+        return m_PatternCount;
+    }
+
+  private:
+    // Deterministic automaton over a reduced alphabet: bytes that appear in no pattern share
+    // class 0, so the transition table is states x (distinct pattern bytes + 1).
+    struct Automaton {
+        std::array<std::uint16_t, 256> classOf{};
+        std::uint32_t classes = 1;
+        std::vector<std::uint32_t> next; // state * classes + class
+        std::vector<std::uint32_t> best; // lowest rule ending at the state or along its suffixes
+
+        void Compile(const std::vector<std::pair<std::string, std::uint32_t>> &patterns);
+        std::uint32_t Scan(std::string_view text) const;
+    };
+
+    Automaton m_AppIds;
+    Automaton m_Titles;
+    std::size_t m_PatternCount = 0;
+};
@@ -1,7 +1,18 @@
 #include "secrets.hpp"
+#include "metrics.hpp"
 #include <iostream>
 #include <spdlog/spdlog.h>
 
+#include <array>
+
+std::mutex Secrets::s_CacheMutex;
+std::unordered_map<std::string, std::optional<std::string>> Secrets::s_Cache;
+
+// Every key Concentrate stores; Preload() marks the ones absent from the keyring as missing.
+static constexpr std::array<const char *, 6> kKnownKeys = {
+    "api_key",         "space_id",        "default_space_id", "task_categories_id",
+    "current_task_id", "monitoring_enabled"};
+
 // ─────────────────────────────────────
 Secrets::Secrets()
     : m_Schema{"io.Concentrate.Secret",
@@ -15,6 +26,11 @@ bool Secrets::SaveSecret(const std::string &key, const std::string &value) {
         return false;
     }
 
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+        Metrics::Labels({{"call", "secret_store"}}));
+    Metrics::ScopedTimer timer(timing);
+
     GError *error = nullptr;
 
     gboolean ok =
@@ -27,6 +43,10 @@ bool Secrets::SaveSecret(const std::string &key, const std::string &value) {
         return false;
     }
 
+    if (ok) {
+        std::lock_guard<std::mutex> lock(s_CacheMutex);
+        s_Cache[key] = value;
+    }
     return ok;
 }
 
@@ -36,22 +56,92 @@ std::string Secrets::LoadSecret(const std::string &key) {
         return "";
     }
 
+    {
+        std::lock_guard<std::mutex> lock(s_CacheMutex);
+        auto it = s_Cache.find(key);
+        if (it != s_Cache.end()) {
+            return it->second.value_or("");
+        }
+    }
+
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+        Metrics::Labels({{"call", "secret_lookup"}}));
+    Metrics::ScopedTimer timer(timing);
+
     GError *error = nullptr;
 
     gchar *secret =
         secret_password_lookup_sync(&m_Schema, nullptr, &error, "key", key.c_str(), nullptr);
 
     if (error) {
+        // Not cached: the keyring may just be locked or not up yet.
         spdlog::error("failed to lookup secret: {}", error->message);
         g_clear_error(&error);
         return "";
     }
 
-    if (!secret) {
-        return "";
+    std::optional<std::string> value;
+    if (secret) {
+        value = std::string(secret);
+        secret_password_free(secret);
     }
 
-    std::string value(secret);
-    secret_password_free(secret);
-    return value;
+    std::lock_guard<std::mutex> lock(s_CacheMutex);
+    s_Cache[key] = value;
+    return value.value_or("");
+}
+
+// ─────────────────────────────────────
+void Secrets::Preload() {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+        Metrics::Labels({{"call", "secret_search"}}));
+    Metrics::ScopedTimer timer(timing);
+
+    GError *error = nullptr;
+    GList *items = secret_password_search_sync(
+        &m_Schema,
+        // No SECRET_SEARCH_UNLOCK: it can pop an unlock prompt and block startup on it.
+        static_cast<SecretSearchFlags>(SECRET_SEARCH_ALL | SECRET_SEARCH_LOAD_SECRETS),
+        nullptr, &error, nullptr);
+    if (error) {
+        spdlog::warn("failed to preload secrets, falling back to lookups: {}", error->message);
+        g_clear_error(&error);
+        return;
+    }
+
+    std::unordered_map<std::string, std::optional<std::string>> loaded;
+    for (const char *key : kKnownKeys) {
+        loaded[key] = std::nullopt;
+    }
+
+    for (GList *l = items; l != nullptr; l = l->next) {
+        SecretRetrievable *item = SECRET_RETRIEVABLE(l->data);
+        GHashTable *attributes = secret_retrievable_get_attributes(item);
+        const auto *key = static_cast<const gchar *>(g_hash_table_lookup(attributes, "key"));
+        // With SECRET_SEARCH_LOAD_SECRETS this is served from the search reply. Items in a
+        // locked keyring come back without their secret: they stay cache misses, looked up by
+        // LoadSecret() when needed.
+        SecretValue *secret = secret_retrievable_retrieve_secret_sync(item, nullptr, nullptr);
+        // NULL for a secret that is not text.
+        const gchar *text = secret ? secret_value_get_text(secret) : nullptr;
+        if (key && text) {
+            loaded[key] = std::string(text);
+        } else if (key) {
+            loaded.erase(key);
+        }
+        if (secret) {
+            secret_value_unref(secret);
+        }
+        g_hash_table_unref(attributes);
+    }
+    g_list_free_full(items, g_object_unref);
+
+    // Values written meanwhile through SaveSecret() are newer than the search result.
+    std::lock_guard<std::mutex> lock(s_CacheMutex);
+    for (auto &[key, value] : loaded) {
+        s_Cache.try_emplace(key, std::move(value));
+    }
+    spdlog::debug("Preloaded {} secrets", loaded.size());
 }
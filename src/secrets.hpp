@@ -1,6 +1,9 @@
 #pragma once
 
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <libsecret/secret.h>
 
 class Secrets {
@@ -10,6 +13,16 @@ class Secrets {
     bool SaveSecret(const std::string &key, const std::string &value);
     std::string LoadSecret(const std::string &key);
 
+    // Loads every Concentrate secret with one keyring search so later LoadSecret() calls are
+    // served from memory.
+    void Preload();
+
   private:
     SecretSchema m_Schema;
+
+    // Shared by all Secrets instances: the keyring is process-wide and every lookup is a
+    // blocking DBus round trip. std::nullopt caches "not stored" so missing keys (e.g.
+    // task_categories_id before the first sync) do not hit the keyring on every call either.
+    static std::mutex s_CacheMutex;
+    static std::unordered_map<std::string, std::optional<std::string>> s_Cache;
 };
@@ -205,12 +205,30 @@ void SQLite::Init() {
         "updated_at REAL NOT NULL"
         ")");
 
+    // Anytype: local mirror of normalized tasks. Deleted tasks are kept as tombstones so an
+    // incremental sync can tell "gone" from "not modified".
+    ExecIgnoringErrors("CREATE TABLE IF NOT EXISTS anytype_tasks ("
+                       "space_id TEXT NOT NULL,"
+                       "id TEXT NOT NULL,"
+                       "data TEXT NOT NULL,"
+                       "done INTEGER NOT NULL DEFAULT 0,"
+                       "last_modified TEXT NOT NULL DEFAULT '',"
+                       "deleted INTEGER NOT NULL DEFAULT 0,"
+                       "synced_at REAL NOT NULL,"
+                       "PRIMARY KEY (space_id, id)"
+                       ")");
+    // UTC seconds of last_modified; the ISO strings do not compare across UTC offsets.
+    ExecIgnoringErrors("ALTER TABLE anytype_tasks ADD COLUMN modified_at INTEGER");
+
     spdlog::debug("SQLite database tables initialized");
 }
 
 // ─────────────────────────────────────
 void SQLite::InsertMonitoringSession(double start_time, double end_time, double duration,
                                      int state) {
+    static auto &timing = QueryTiming("InsertMonitoringSession");
+    Metrics::ScopedTimer timer(timing);
+
     if (!m_InsertMonitoringStmt) {
         spdlog::error("InsertMonitoring stmt not prepared");
         return;
@@ -227,11 +245,16 @@ void SQLite::InsertMonitoringSession(double start_time, double end_time, double
     const int rc = sqlite3_step(m_InsertMonitoringStmt);
     if (rc != SQLITE_DONE) {
         spdlog::error("InsertMonitoring failed: {}", sqlite3_errmsg(m_Db));
+        return;
     }
+    BumpWriteGeneration();
 }
 
 // ─────────────────────────────────────
 bool SQLite::UpdateMonitoringSession(double end_time, double duration, int state) {
+    static auto &timing = QueryTiming("UpdateMonitoringSession");
+    Metrics::ScopedTimer timer(timing);
+
     if (!m_UpdateMonitoringStmt) {
         spdlog::error("UpdateMonitoring stmt not prepared");
         return false;
@@ -251,11 +274,18 @@ bool SQLite::UpdateMonitoringSession(double end_time, double duration, int state
     }
 
     // If no row matched, SQLite still returns DONE, but changes() will be 0.
-    return sqlite3_changes(m_Db) > 0;
+    if (sqlite3_changes(m_Db) == 0) {
+        return false;
+    }
+    BumpWriteGeneration();
+    return true;
 }
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetTodayMonitoringTimeSummary() {
+    static auto &timing = QueryTiming("GetTodayMonitoringTimeSummary");
+    Metrics::ScopedTimer timer(timing);
+
     const double from_epoch = GetLocalDayStartEpoch(0);
     const double now_epoch = std::chrono::duration<double>(
                                std::chrono::system_clock::now().time_since_epoch())
@@ -319,6 +349,9 @@ nlohmann::json SQLite::GetTodayMonitoringTimeSummary() {
 // ─────────────────────────────────────
 void SQLite::InsertHydrationResponse(const std::string &answer, double prompted_at,
                                      double answered_at) {
+    static auto &timing = QueryTiming("InsertHydrationResponse");
+    Metrics::ScopedTimer timer(timing);
+
     const char *sql = R"(
         INSERT INTO hydration_log (prompted_at, answered_at, answer)
         VALUES (?, ?, ?)
@@ -337,6 +370,8 @@ void SQLite::InsertHydrationResponse(const std::string &answer, double prompted_
     const int rc = sqlite3_step(stmt);
     if (rc != SQLITE_DONE) {
         spdlog::error("InsertHydrationResponse failed: {}", sqlite3_errmsg(m_Db));
+    } else {
+        BumpWriteGeneration();
     }
 
     sqlite3_finalize(stmt);
@@ -404,6 +439,9 @@ nlohmann::json SQLite::GetHydrationSummaryLast24h() {
 void SQLite::InsertEventNew(const std::string &appId, const std::string &title,
                             const std::string &taskCategory, double start_time, double end_time,
                             double duration, int state) {
+    static auto &timing = QueryTiming("InsertEventNew");
+    Metrics::ScopedTimer timer(timing);
+
     if (!m_InsertEventStmt) {
         spdlog::error("InsertEvent stmt not prepared");
         return;
@@ -426,7 +464,9 @@ void SQLite::InsertEventNew(const std::string &appId, const std::string &title,
     int rc = sqlite3_step(m_InsertEventStmt);
     if (rc != SQLITE_DONE) {
         spdlog::error("InsertEvent failed: {}", sqlite3_errmsg(m_Db));
+        return;
     }
+    BumpWriteGeneration();
 
     spdlog::debug("Inserted log: app_id={}, title={}, category={}, state={}, duration={}", appId,
                   title, taskCategory, state, duration);
@@ -436,6 +476,9 @@ void SQLite::InsertEventNew(const std::string &appId, const std::string &title,
 bool SQLite::UpdateEventNew(const std::string &appId, const std::string &title,
                             const std::string &taskCategory, double end_time, double duration,
                             int state) {
+    static auto &timing = QueryTiming("UpdateEventNew");
+    Metrics::ScopedTimer timer(timing);
+
     if (!m_UpdateEventStmt) {
         spdlog::error("UpdateEvent stmt not prepared");
         return false;
@@ -471,6 +514,7 @@ bool SQLite::UpdateEventNew(const std::string &appId, const std::string &title,
             appId, title, state);
         return false;
     }
+    BumpWriteGeneration();
 
     spdlog::debug("Updated log: app_id={}, title={}, category={}, state={}, duration={}", appId,
                   title, taskCategory, state, duration);
@@ -479,6 +523,9 @@ bool SQLite::UpdateEventNew(const std::string &appId, const std::string &title,
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::FetchTodayCategorySummary() {
+    static auto &timing = QueryTiming("FetchTodayCategorySummary");
+    Metrics::ScopedTimer timer(timing);
+
     nlohmann::json rows = nlohmann::json::array();
 
     const double from_epoch = GetLocalDayStartEpoch(0);
@@ -519,6 +566,9 @@ nlohmann::json SQLite::FetchTodayCategorySummary() {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetFocusSummary(int days) {
+    static auto &timing = QueryTiming("GetFocusSummary");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -576,6 +626,9 @@ nlohmann::json SQLite::GetFocusSummary(int days) {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetTodayFocusTimeSummary() {
+    static auto &timing = QueryTiming("GetTodayFocusTimeSummary");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     const double from_epoch = GetLocalDayStartEpoch(0);
@@ -630,6 +683,9 @@ nlohmann::json SQLite::GetTodayFocusTimeSummary() {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetTodayDailyActivitiesSummary() {
+    static auto &timing = QueryTiming("GetTodayDailyActivitiesSummary");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     const double from_epoch = GetLocalDayStartEpoch(0);
@@ -671,6 +727,9 @@ nlohmann::json SQLite::GetTodayDailyActivitiesSummary() {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetFocusPercentageByCategory(int days) {
+    static auto &timing = QueryTiming("GetFocusPercentageByCategory");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -726,6 +785,9 @@ nlohmann::json SQLite::GetFocusPercentageByCategory(int days) {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetCategoryTimeSummary(int days) {
+    static auto &timing = QueryTiming("GetCategoryTimeSummary");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -771,6 +833,9 @@ nlohmann::json SQLite::GetCategoryTimeSummary(int days) {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetCategoryFocusSplit(int days) {
+    static auto &timing = QueryTiming("GetCategoryFocusSplit");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -847,6 +912,9 @@ nlohmann::json SQLite::GetCategoryFocusSplit(int days) {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::FetchDailyAppUsageByAppId(int days) {
+    static auto &timing = QueryTiming("FetchDailyAppUsageByAppId");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -920,6 +988,9 @@ static nlohmann::json DefaultPomodoroState() {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetPomodoroState() {
+    static auto &timing = QueryTiming("GetPomodoroState");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
     const char *sql =
         "SELECT phase, cycle_step, is_running, is_paused, time_left, focus_duration, "
@@ -962,6 +1033,9 @@ nlohmann::json SQLite::GetPomodoroState() {
 
 // ─────────────────────────────────────
 bool SQLite::SavePomodoroState(const nlohmann::json &state, std::string &error) {
+    static auto &timing = QueryTiming("SavePomodoroState");
+    Metrics::ScopedTimer timer(timing);
+
     error.clear();
     sqlite3_stmt *stmt = nullptr;
 
@@ -1017,12 +1091,16 @@ bool SQLite::SavePomodoroState(const nlohmann::json &state, std::string &error)
         spdlog::error("SavePomodoroState failed: {}", sqlite3_errmsg(m_Db));
         return false;
     }
+    BumpWriteGeneration();
 
     return true;
 }
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::GetPomodoroTodayStats() {
+    static auto &timing = QueryTiming("GetPomodoroTodayStats");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
     const char *sql =
         "SELECT focus_sessions, focus_seconds, updated_at "
@@ -1050,6 +1128,9 @@ nlohmann::json SQLite::GetPomodoroTodayStats() {
 
 // ─────────────────────────────────────
 bool SQLite::IncrementPomodoroFocusToday(int focusSeconds, std::string &error) {
+    static auto &timing = QueryTiming("IncrementPomodoroFocusToday");
+    Metrics::ScopedTimer timer(timing);
+
     error.clear();
     if (focusSeconds < 0) {
         focusSeconds = 0;
@@ -1079,6 +1160,7 @@ bool SQLite::IncrementPomodoroFocusToday(int focusSeconds, std::string &error) {
         spdlog::error("IncrementPomodoroFocusToday failed: {}", sqlite3_errmsg(m_Db));
         return false;
     }
+    BumpWriteGeneration();
 
     return true;
 }
@@ -1086,6 +1168,9 @@ bool SQLite::IncrementPomodoroFocusToday(int focusSeconds, std::string &error) {
 // ─────────────────────────────────────
 void SQLite::UpsertCategory(const std::string &category, const nlohmann::json &allowedAppIds,
                             const nlohmann::json &allowedTitles) {
+    static auto &timing = QueryTiming("UpsertCategory");
+    Metrics::ScopedTimer timer(timing);
+
     if (category.empty()) {
         return;
     }
@@ -1138,7 +1223,9 @@ void SQLite::UpsertCategory(const std::string &category, const nlohmann::json &a
     sqlite3_bind_text(stmt, 3, titles_str.c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_double(stmt, 4, now);
 
-    sqlite3_step(stmt);
+    if (sqlite3_step(stmt) == SQLITE_DONE) {
+        BumpWriteGeneration();
+    }
     sqlite3_finalize(stmt);
     spdlog::debug("Upserted category: {}", category);
 }
@@ -1149,6 +1236,9 @@ void SQLite::UpsertCategory(const std::string &category, const nlohmann::json &a
 void SQLite::AddRecurringTask(const std::string &name, const std::vector<std::string> &appIds,
                               const std::vector<std::string> &appTitles, const std::string &icon,
                               const std::string &color) {
+    static auto &timing = QueryTiming("AddRecurringTask");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     const char *sql = "INSERT INTO recurring_tasks "
@@ -1174,6 +1264,8 @@ void SQLite::AddRecurringTask(const std::string &name, const std::vector<std::st
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         spdlog::error("AddRecurringTask failed: {}", sqlite3_errmsg(m_Db));
+    } else {
+        BumpWriteGeneration();
     }
 
     sqlite3_finalize(stmt);
@@ -1183,6 +1275,9 @@ void SQLite::AddRecurringTask(const std::string &name, const std::vector<std::st
 void SQLite::UpdateRecurringTask(const std::string &name, const std::vector<std::string> &appIds,
                                  const std::vector<std::string> &appTitles, const std::string &icon,
                                  const std::string &color) {
+    static auto &timing = QueryTiming("UpdateRecurringTask");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     const char *sql = "UPDATE recurring_tasks SET "
@@ -1206,6 +1301,8 @@ void SQLite::UpdateRecurringTask(const std::string &name, const std::vector<std:
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         spdlog::error("UpdateRecurringTask failed: {}", sqlite3_errmsg(m_Db));
+    } else {
+        BumpWriteGeneration();
     }
 
     sqlite3_finalize(stmt);
@@ -1213,6 +1310,9 @@ void SQLite::UpdateRecurringTask(const std::string &name, const std::vector<std:
 
 // ─────────────────────────────────────
 void SQLite::ExcludeRecurringTask(const std::string &name) {
+    static auto &timing = QueryTiming("ExcludeRecurringTask");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
     const char *sql = "DELETE FROM recurring_tasks WHERE name = ?";
     if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
@@ -1224,12 +1324,17 @@ void SQLite::ExcludeRecurringTask(const std::string &name) {
 
     if (sqlite3_step(stmt) != SQLITE_DONE) {
         spdlog::error("ExcludeRecurringTask failed: {}", sqlite3_errmsg(m_Db));
+    } else {
+        BumpWriteGeneration();
     }
     sqlite3_finalize(stmt);
 }
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::FetchRecurringTasks() {
+    static auto &timing = QueryTiming("FetchRecurringTasks");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     const char *sql = "SELECT name, app_ids, app_titles, icon, color, updated_at "
@@ -1286,6 +1391,9 @@ nlohmann::json SQLite::FetchRecurringTasks() {
 // │             Historical              │
 // ╰─────────────────────────────────────╯
 nlohmann::json SQLite::FetchEvents(int days, int limit) {
+    static auto &timing = QueryTiming("FetchEvents");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (days < 1) {
@@ -1352,6 +1460,9 @@ nlohmann::json SQLite::FetchEvents(int days, int limit) {
 
 // ─────────────────────────────────────
 nlohmann::json SQLite::FetchHistory(int limit) {
+    static auto &timing = QueryTiming("FetchHistory");
+    Metrics::ScopedTimer timer(timing);
+
     sqlite3_stmt *stmt = nullptr;
 
     if (limit < 1) {
@@ -1409,6 +1520,228 @@ nlohmann::json SQLite::FetchHistory(int limit) {
     return rows;
 }
 
+// ─────────────────────────────────────
+bool SQLite::UpsertAnytypeTasks(const std::string &spaceId, const nlohmann::json &tasks) {
+    static auto &timing = QueryTiming("UpsertAnytypeTasks");
+    Metrics::ScopedTimer timer(timing);
+
+    if (!tasks.is_array() || tasks.empty()) {
+        return true;
+    }
+
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "INSERT INTO anytype_tasks "
+                      "(space_id, id, data, done, last_modified, modified_at, deleted, "
+                      "synced_at) "
+                      "VALUES (?, ?, ?, ?, ?, ?, 0, ?) "
+                      "ON CONFLICT(space_id, id) DO UPDATE SET "
+                      "data = excluded.data, done = excluded.done, "
+                      "last_modified = excluded.last_modified, "
+                      "modified_at = excluded.modified_at, deleted = 0, "
+                      "synced_at = excluded.synced_at";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in UpsertAnytypeTasks: {}", sqlite3_errmsg(m_Db));
+        return false;
+    }
+
+    const double now = static_cast<double>(std::time(nullptr));
+    bool ok = true;
+    ExecIgnoringErrors("BEGIN");
+    for (const auto &task : tasks) {
+        if (!task.is_object() || !task.contains("id") || !task["id"].is_string()) {
+            continue;
+        }
+        const std::string id = task["id"].get<std::string>();
+        const std::string data = task.dump();
+        const std::string lastModified = task.value("last_modified", "");
+        const bool done = task.value("done", false);
+
+        sqlite3_reset(stmt);
+        sqlite3_bind_text(stmt, 1, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, id.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, data.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 4, done ? 1 : 0);
+        sqlite3_bind_text(stmt, 5, lastModified.c_str(), -1, SQLITE_TRANSIENT);
+        if (task.contains("modified_at") && task["modified_at"].is_number_integer()) {
+            sqlite3_bind_int64(stmt, 6, task["modified_at"].get<std::int64_t>());
+        } else {
+            sqlite3_bind_null(stmt, 6);
+        }
+        sqlite3_bind_double(stmt, 7, now);
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            spdlog::error("UpsertAnytypeTasks failed for {}: {}", id, sqlite3_errmsg(m_Db));
+            ok = false;
+            break;
+        }
+    }
+    ExecIgnoringErrors(ok ? "COMMIT" : "ROLLBACK");
+
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+// ─────────────────────────────────────
+int SQLite::TombstoneAnytypeTasks(const std::string &spaceId,
+                                  const std::vector<std::string> &liveIds) {
+    static auto &timing = QueryTiming("TombstoneAnytypeTasks");
+    Metrics::ScopedTimer timer(timing);
+
+    // The live id set is passed as one JSON array instead of thousands of bound parameters.
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "UPDATE anytype_tasks SET deleted = 1, synced_at = ? "
+                      "WHERE space_id = ? AND deleted = 0 "
+                      "AND id NOT IN (SELECT value FROM json_each(?))";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in TombstoneAnytypeTasks: {}", sqlite3_errmsg(m_Db));
+        return 0;
+    }
+
+    const std::string ids = nlohmann::json(liveIds).dump();
+    sqlite3_bind_double(stmt, 1, static_cast<double>(std::time(nullptr)));
+    sqlite3_bind_text(stmt, 2, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, ids.c_str(), -1, SQLITE_TRANSIENT);
+
+    int changed = 0;
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        spdlog::error("TombstoneAnytypeTasks failed: {}", sqlite3_errmsg(m_Db));
+    } else {
+        changed = sqlite3_changes(m_Db);
+    }
+
+    sqlite3_finalize(stmt);
+    return changed;
+}
+
+// ─────────────────────────────────────
+nlohmann::json SQLite::FetchAnytypeTasks(const std::string &spaceId) {
+    static auto &timing = QueryTiming("FetchAnytypeTasks");
+    Metrics::ScopedTimer timer(timing);
+
+    nlohmann::json rows = nlohmann::json::array();
+
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "SELECT data FROM anytype_tasks "
+                      "WHERE space_id = ? AND deleted = 0 AND done = 0 "
+                      "ORDER BY modified_at DESC, id";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in FetchAnytypeTasks: {}", sqlite3_errmsg(m_Db));
+        return rows;
+    }
+
+    sqlite3_bind_text(stmt, 1, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *data = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        try {
+            rows.push_back(nlohmann::json::parse(data ? data : "{}"));
+        } catch (...) {
+            // Skip rows that cannot be parsed; the next full sync rewrites them.
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+// ─────────────────────────────────────
+nlohmann::json SQLite::FetchAnytypeTask(const std::string &spaceId, const std::string &id) {
+    static auto &timing = QueryTiming("FetchAnytypeTask");
+    Metrics::ScopedTimer timer(timing);
+
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "SELECT data FROM anytype_tasks "
+                      "WHERE space_id = ? AND id = ? AND deleted = 0";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in FetchAnytypeTask: {}", sqlite3_errmsg(m_Db));
+        return nlohmann::json();
+    }
+
+    sqlite3_bind_text(stmt, 1, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, id.c_str(), -1, SQLITE_TRANSIENT);
+
+    nlohmann::json task;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char *data = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        try {
+            task = nlohmann::json::parse(data ? data : "{}");
+        } catch (...) {
+            task = nlohmann::json();
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    return task;
+}
+
+// ─────────────────────────────────────
+std::optional<std::int64_t> SQLite::GetAnytypeTasksWatermark(const std::string &spaceId) {
+    static auto &timing = QueryTiming("GetAnytypeTasksWatermark");
+    Metrics::ScopedTimer timer(timing);
+
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "SELECT MAX(modified_at) FROM anytype_tasks WHERE space_id = ?";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in GetAnytypeTasksWatermark: {}", sqlite3_errmsg(m_Db));
+        return std::nullopt;
+    }
+
+    sqlite3_bind_text(stmt, 1, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+
+    std::optional<std::int64_t> watermark;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        watermark = sqlite3_column_int64(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return watermark;
+}
+
+// ─────────────────────────────────────
+double SQLite::GetAnytypeTasksSyncedAt(const std::string &spaceId) {
+    static auto &timing = QueryTiming("GetAnytypeTasksSyncedAt");
+    Metrics::ScopedTimer timer(timing);
+
+    sqlite3_stmt *stmt = nullptr;
+    const char *sql = "SELECT MAX(synced_at) FROM anytype_tasks WHERE space_id = ?";
+
+    if (sqlite3_prepare_v2(m_Db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        spdlog::error("db prepare failed in GetAnytypeTasksSyncedAt: {}", sqlite3_errmsg(m_Db));
+        return 0.0;
+    }
+
+    sqlite3_bind_text(stmt, 1, spaceId.c_str(), -1, SQLITE_TRANSIENT);
+
+    double syncedAt = 0.0;
+    if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+        syncedAt = sqlite3_column_double(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return syncedAt;
+}
+
+// ─────────────────────────────────────
+Metrics::Histogram &SQLite::QueryTiming(std::string_view method) {
+    return Metrics::Instance().GetHistogram("concentrate_sqlite_query_duration_seconds",
+                                            "Wall time of SQLite accessor calls.",
+                                            Metrics::Labels({{"method", method}}));
+}
+
+// ─────────────────────────────────────
+std::uint64_t SQLite::GetWriteGeneration() const {
+    return m_WriteGeneration.load(std::memory_order_acquire);
+}
+
+// ─────────────────────────────────────
+void SQLite::BumpWriteGeneration() {
+    m_WriteGeneration.fetch_add(1, std::memory_order_release);
+}
+
 // ─────────────────────────────────────
 void SQLite::ExecIgnoringErrors(const std::string &sql) {
     char *errmsg = nullptr;
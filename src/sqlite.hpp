@@ -5,9 +5,15 @@
 
 #include <string>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 #include "json.hpp"
 #include "common.hpp"
+#include "metrics.hpp"
 
 class SQLite {
   public:
@@ -56,6 +62,17 @@ class SQLite {
     nlohmann::json FetchCategories();
     nlohmann::json FetchHistory(int limit = 500);
 
+    // Anytype task mirror (normalized tasks as served by /api/v1/anytype/tasks). It only feeds
+    // task lists, so its writes do not bump the analytics write generation.
+    bool UpsertAnytypeTasks(const std::string &spaceId, const nlohmann::json &tasks);
+    int TombstoneAnytypeTasks(const std::string &spaceId,
+                              const std::vector<std::string> &liveIds);
+    nlohmann::json FetchAnytypeTasks(const std::string &spaceId);
+    nlohmann::json FetchAnytypeTask(const std::string &spaceId, const std::string &id);
+    // Newest modified_at (UTC seconds) mirrored for the space; nullopt when there is none.
+    std::optional<std::int64_t> GetAnytypeTasksWatermark(const std::string &spaceId);
+    double GetAnytypeTasksSyncedAt(const std::string &spaceId);
+
     // History
     nlohmann::json GetFocusPercentageByCategory(int days);
     nlohmann::json FetchDailyAppUsageByAppId(int days);
@@ -68,6 +85,11 @@ class SQLite {
     nlohmann::json GetPomodoroTodayStats();
     bool IncrementPomodoroFocusToday(int focusSeconds, std::string &error);
 
+    // Monotonic counter bumped after every successful write. Readers use it as a cheap
+    // "has anything changed?" token (e.g. HTTP ETags) without touching the database. It starts
+    // at 0 in every process, so tokens that outlive the process need a per-process id next to it.
+    std::uint64_t GetWriteGeneration() const;
+
   private:
     // Returns Unix epoch seconds (UTC) for local midnight N days ago.
     // days = 0 -> today at 00:00 local time
@@ -79,6 +101,8 @@ class SQLite {
     void UpsertCategory(const std::string &category, const nlohmann::json &allowedAppIds,
                         const nlohmann::json &allowedTitles);
     void ExecIgnoringErrors(const std::string &sql);
+    void BumpWriteGeneration();
+    static Metrics::Histogram &QueryTiming(std::string_view method);
 
   private:
     sqlite3 *m_Db;
@@ -91,6 +115,8 @@ class SQLite {
     sqlite3_stmt *m_InsertMonitoringStmt = nullptr;
     sqlite3_stmt *m_UpdateMonitoringStmt = nullptr;
 
+    std::atomic<std::uint64_t> m_WriteGeneration{0};
+
     // Small deterministic lookaside buffer to reduce heap churn.
     static constexpr int kLookasideSlotSize = 128;
     static constexpr int kLookasideSlotCount = 256; // 32 KiB
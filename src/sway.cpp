@@ -0,0 +1,512 @@
+#include "sway.hpp"
+#include "metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static constexpr char kMagic[] = {'i', '3', '-', 'i', 'p', 'c'};
+static constexpr std::size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(std::uint32_t);
+// GET_TREE with many windows is the largest payload; anything bigger is a framing error.
+static constexpr std::uint32_t kMaxPayload = 16 * 1024 * 1024;
+
+// ─────────────────────────────────────
+SwayIPC::SwayIPC() : m_SocketPath(GetEnvSocketPath()) {}
+
+// ─────────────────────────────────────
+SwayIPC::~SwayIPC() {
+    StopEventStream();
+    CloseFd(m_QueryFd);
+}
+
+// ─────────────────────────────────────
+std::string SwayIPC::GetEnvSocketPath() {
+    for (const char *name : {"SWAYSOCK", "I3SOCK"}) {
+        const char *env = std::getenv(name);
+        if (env != nullptr && *env) {
+            return std::string(env);
+        }
+    }
+    return {};
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::IsAvailable() const {
+    return !m_SocketPath.empty();
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::ConnectFd(int &fd) {
+    if (!IsAvailable()) {
+        return false;
+    }
+
+    if (fd >= 0) {
+        return true;
+    }
+
+    const int new_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (new_fd < 0) {
+        spdlog::error("Failed to create Sway socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (m_SocketPath.size() >= sizeof(addr.sun_path)) {
+        spdlog::error("SWAYSOCK path too long");
+        ::close(new_fd);
+        return false;
+    }
+
+    std::strncpy(addr.sun_path, m_SocketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(new_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        const int err = errno;
+        if (err != ENOENT && err != ECONNREFUSED) {
+            spdlog::warn("Failed to connect to sway socket: {}", std::strerror(err));
+        }
+        ::close(new_fd);
+        return false;
+    }
+
+    fd = new_fd;
+    return true;
+}
+
+// ─────────────────────────────────────
+void SwayIPC::CloseFd(int &fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::SendAll(int fd, const void *data, std::size_t size) {
+    const char *ptr = static_cast<const char *>(data);
+    std::size_t remaining = size;
+
+    while (remaining > 0) {
+        const ssize_t sent = ::send(fd, ptr, remaining, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (sent == 0) {
+            return false;
+        }
+        ptr += static_cast<std::size_t>(sent);
+        remaining -= static_cast<std::size_t>(sent);
+    }
+
+    return true;
+}
+
+// ─────────────────────────────────────
+std::string SwayIPC::EncodeMessage(std::uint32_t type, const std::string &payload) {
+    const auto length = static_cast<std::uint32_t>(payload.size());
+    std::string message(kMagic, sizeof(kMagic));
+    message.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    message.append(reinterpret_cast<const char *>(&type), sizeof(type));
+    message += payload;
+    return message;
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::ReadExact(int fd, char *out, std::size_t size,
+                        std::chrono::steady_clock::time_point deadline) {
+    std::size_t got = 0;
+    while (got < size) {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            return false;
+        }
+
+        pollfd pfd{fd, POLLIN, 0};
+        const int rc = ::poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0 || (pfd.revents & (POLLERR | POLLNVAL)) != 0) {
+            return false;
+        }
+
+        const ssize_t n = ::recv(fd, out + got, size - got, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        got += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// ─────────────────────────────────────
+std::optional<nlohmann::json> SwayIPC::SendMessage(std::uint32_t type, const std::string &payload,
+                                                   std::chrono::milliseconds timeout) {
+    static auto &timing = Metrics::Instance().GetHistogram(
+        "concentrate_ipc_query_duration_seconds", "Round trip of compositor IPC queries.",
+        Metrics::Labels({{"backend", "sway"}}));
+    Metrics::ScopedTimer timer(timing);
+
+    if (!ConnectFd(m_QueryFd)) {
+        return std::nullopt;
+    }
+
+    const std::string request = EncodeMessage(type, payload);
+    if (!SendAll(m_QueryFd, request.data(), request.size())) {
+        spdlog::warn("Failed to send sway IPC request");
+        CloseFd(m_QueryFd);
+        return std::nullopt;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    char header[kHeaderSize];
+    if (!ReadExact(m_QueryFd, header, sizeof(header), deadline) ||
+        std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+        spdlog::debug("No response from sway IPC (timeout/disconnect)");
+        CloseFd(m_QueryFd);
+        return std::nullopt;
+    }
+
+    std::uint32_t length = 0;
+    std::uint32_t replyType = 0;
+    std::memcpy(&length, header + sizeof(kMagic), sizeof(length));
+    std::memcpy(&replyType, header + sizeof(kMagic) + sizeof(length), sizeof(replyType));
+    // Checked before allocating: the length comes straight from the socket.
+    if (length > kMaxPayload || replyType != type) {
+        spdlog::debug("Malformed sway IPC reply (type {}, {} bytes)", replyType, length);
+        CloseFd(m_QueryFd);
+        return std::nullopt;
+    }
+    std::string body(length, '\0');
+    if (!ReadExact(m_QueryFd, body.data(), body.size(), deadline)) {
+        spdlog::debug("Truncated sway IPC reply");
+        CloseFd(m_QueryFd);
+        return std::nullopt;
+    }
+
+    try {
+        return nlohmann::json::parse(body);
+    } catch (const std::exception &e) {
+        spdlog::warn("Failed to parse sway IPC response JSON: {}", e.what());
+        return std::nullopt;
+    }
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::StartEventStream(
+    Reactor &reactor,
+    std::function<void(std::uint32_t type, const nlohmann::json &event)> callback,
+    std::chrono::milliseconds reconnect_delay) {
+    if (m_StreamRunning.load()) {
+        return true;
+    }
+
+    if (!IsAvailable()) {
+        return false;
+    }
+
+    m_Reactor = &reactor;
+    m_StreamCallback = std::move(callback);
+    m_ReconnectDelay = reconnect_delay;
+    m_StreamRunning.store(true);
+    ConnectStream();
+    return true;
+}
+
+// ─────────────────────────────────────
+void SwayIPC::ConnectStream() {
+    m_ReconnectTimer = 0;
+    if (!ConnectFd(m_StreamFd)) {
+        ScheduleReconnect();
+        return;
+    }
+
+    // The reply ({"success": true}) arrives on the stream ahead of the first event.
+    const std::string subscribe = EncodeMessage(SUBSCRIBE, R"(["window","workspace","shutdown"])");
+    if (!SendAll(m_StreamFd, subscribe.data(), subscribe.size())) {
+        spdlog::debug("Failed to subscribe to sway events");
+        CloseFd(m_StreamFd);
+        ScheduleReconnect();
+        return;
+    }
+
+    m_StreamBuffer.clear();
+    m_StreamOffset = 0;
+    if (!m_Reactor->Watch(m_StreamFd, EPOLLIN, [this](std::uint32_t) { OnStreamReadable(); })) {
+        CloseFd(m_StreamFd);
+        ScheduleReconnect();
+        return;
+    }
+
+    // Seed from the tree; events queued since the subscription are applied on top of it.
+    if (const auto tree = SendMessage(GET_TREE)) {
+        m_StreamFocused = FindFocused(*tree);
+        m_StreamSeeded = true;
+        PublishFocus();
+    }
+}
+
+// ─────────────────────────────────────
+void SwayIPC::ScheduleReconnect() {
+    m_ReconnectTimer = m_Reactor->AddTimer(std::chrono::steady_clock::now() + m_ReconnectDelay,
+                                           [this] { ConnectStream(); });
+}
+
+// ─────────────────────────────────────
+void SwayIPC::OnStreamReadable() {
+    static auto &reconnects = Metrics::Instance().GetCounter(
+        "concentrate_ipc_reconnects_total", "Compositor event stream reconnects.",
+        Metrics::Labels({{"backend", "sway"}}));
+
+    char chunk[64 * 1024];
+    while (true) {
+        const ssize_t n = ::recv(m_StreamFd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (n > 0) {
+            m_StreamBuffer.append(chunk, static_cast<std::size_t>(n));
+            if (ParseStreamMessages()) {
+                continue;
+            }
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return; // drained; partial messages stay buffered
+        }
+        break;
+    }
+
+    CloseStream();
+    reconnects.Inc();
+    ScheduleReconnect();
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::ParseStreamMessages() {
+    while (m_StreamBuffer.size() - m_StreamOffset >= kHeaderSize) {
+        const char *header = m_StreamBuffer.data() + m_StreamOffset;
+        std::uint32_t length = 0;
+        std::uint32_t type = 0;
+        std::memcpy(&length, header + sizeof(kMagic), sizeof(length));
+        std::memcpy(&type, header + sizeof(kMagic) + sizeof(length), sizeof(type));
+        if (std::memcmp(header, kMagic, sizeof(kMagic)) != 0 || length > kMaxPayload) {
+            spdlog::warn("Malformed sway IPC event; reconnecting");
+            return false;
+        }
+        if (m_StreamBuffer.size() - m_StreamOffset < kHeaderSize + length) {
+            break;
+        }
+
+        HandleStreamMessage(type, std::string_view(header + kHeaderSize, length));
+        m_StreamOffset += kHeaderSize + length;
+    }
+
+    // Drop consumed bytes once they make up most of the buffer, not after every message.
+    if (m_StreamOffset == m_StreamBuffer.size()) {
+        m_StreamBuffer.clear();
+        m_StreamOffset = 0;
+    } else if (m_StreamOffset > m_StreamBuffer.size() / 2) {
+        m_StreamBuffer.erase(0, m_StreamOffset);
+        m_StreamOffset = 0;
+    }
+    return true;
+}
+
+// ─────────────────────────────────────
+void SwayIPC::HandleStreamMessage(std::uint32_t type, std::string_view payload) {
+    static auto &events = Metrics::Instance().GetCounter(
+        "concentrate_ipc_events_total", "Compositor events delivered to the tracker.",
+        Metrics::Labels({{"backend", "sway"}}));
+
+    if ((type & kEventFlag) == 0) {
+        if (type == SUBSCRIBE && payload.find("true") == std::string_view::npos) {
+            spdlog::warn("Sway rejected the event subscription: {}", payload);
+        }
+        return;
+    }
+
+    nlohmann::json event;
+    try {
+        event = nlohmann::json::parse(payload);
+    } catch (const std::exception &e) {
+        spdlog::debug("Ignoring non-JSON sway event: {}", e.what());
+        return;
+    }
+
+    ApplyEvent(type, event);
+    if (type == kShutdownEvent) {
+        return;
+    }
+
+    events.Inc();
+    try {
+        m_StreamCallback(type, event);
+    } catch (...) {
+        // Never let callbacks break the event loop.
+    }
+}
+
+// ─────────────────────────────────────
+SwayContainer SwayIPC::ParseContainer(const nlohmann::json &node) {
+    SwayContainer c;
+    if (node.contains("id") && node["id"].is_number_integer()) {
+        c.id = node["id"].get<std::int64_t>();
+    }
+    if (node.contains("app_id") && node["app_id"].is_string()) {
+        c.app_id = node["app_id"].get<std::string>();
+    } else if (node.contains("window_properties") && node["window_properties"].is_object()) {
+        const auto &props = node["window_properties"];
+        if (props.contains("class") && props["class"].is_string()) {
+            c.app_id = props["class"].get<std::string>();
+        }
+    }
+    if (node.contains("name") && node["name"].is_string()) {
+        c.title = node["name"].get<std::string>();
+    }
+    return c;
+}
+
+// ─────────────────────────────────────
+std::optional<SwayContainer> SwayIPC::FindFocused(const nlohmann::json &node) {
+    if (!node.is_object()) {
+        return std::nullopt;
+    }
+
+    const bool focused =
+        node.contains("focused") && node["focused"].is_boolean() && node["focused"].get<bool>();
+    if (focused) {
+        // A focused output or workspace means no window has focus (e.g. an empty workspace).
+        const std::string type = node.value("type", "");
+        if (type == "con" || type == "floating_con") {
+            return ParseContainer(node);
+        }
+        return std::nullopt;
+    }
+
+    for (const char *children : {"nodes", "floating_nodes"}) {
+        if (!node.contains(children) || !node[children].is_array()) {
+            continue;
+        }
+        for (const auto &child : node[children]) {
+            if (auto found = FindFocused(child)) {
+                return found;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+// ─────────────────────────────────────
+void SwayIPC::ApplyEvent(std::uint32_t type, const nlohmann::json &event) {
+    if (!event.is_object()) {
+        return;
+    }
+    const std::string change = event.value("change", "");
+
+    if (type == kWindowEvent) {
+        if (!event.contains("container") || !event["container"].is_object()) {
+            return;
+        }
+        const auto &node = event["container"];
+        SwayContainer container = ParseContainer(node);
+        const bool isFocused = m_StreamFocused && m_StreamFocused->id == container.id;
+        const bool focused =
+            node.contains("focused") && node["focused"].is_boolean() && node["focused"].get<bool>();
+
+        if (change == "close") {
+            if (!isFocused) {
+                return;
+            }
+            // Sway follows up with a focus event for whatever gets focus next.
+            m_StreamFocused.reset();
+        } else if (change == "focus" || focused) {
+            m_StreamFocused = std::move(container);
+        } else if (isFocused) {
+            // title, mark, urgent...: same window, fresher payload.
+            m_StreamFocused = std::move(container);
+        } else {
+            return;
+        }
+    } else if (type == kWorkspaceEvent) {
+        if (change != "focus" || !event.contains("current")) {
+            return;
+        }
+        // Switching to an empty workspace leaves no focused window; otherwise a window focus
+        // event follows, but the workspace tree already says which one.
+        const auto &current = event["current"];
+        auto focused = FindFocused(current);
+        const bool workspaceFocused = current.is_object() && current.contains("focused") &&
+                                      current["focused"].is_boolean() &&
+                                      current["focused"].get<bool>();
+        if (!focused && !workspaceFocused) {
+            return;
+        }
+        m_StreamFocused = std::move(focused);
+    } else {
+        return;
+    }
+
+    PublishFocus();
+}
+
+// ─────────────────────────────────────
+void SwayIPC::PublishFocus() {
+    if (!m_StreamSeeded) {
+        return;
+    }
+    auto focus = std::make_shared<SwayFocus>();
+    focus->focused = m_StreamFocused;
+    m_Focus.store(std::move(focus), std::memory_order_release);
+}
+
+// ─────────────────────────────────────
+void SwayIPC::CloseStream() {
+    if (m_StreamFd >= 0) {
+        m_Reactor->Unwatch(m_StreamFd);
+    }
+    CloseFd(m_StreamFd);
+    m_StreamBuffer.clear();
+    m_StreamOffset = 0;
+    // Events may be missed until the tree is read again on reconnect.
+    m_StreamFocused.reset();
+    m_StreamSeeded = false;
+    m_Focus.store(nullptr, std::memory_order_release);
+}
+
+// ─────────────────────────────────────
+void SwayIPC::StopEventStream() {
+    if (!m_StreamRunning.exchange(false)) {
+        return;
+    }
+
+    if (m_ReconnectTimer != 0) {
+        m_Reactor->CancelTimer(m_ReconnectTimer);
+        m_ReconnectTimer = 0;
+    }
+    CloseStream();
+}
+
+// ─────────────────────────────────────
+bool SwayIPC::IsEventStreamRunning() const {
+    return m_StreamRunning.load();
+}
+
+// ─────────────────────────────────────
+std::shared_ptr<const SwayFocus> SwayIPC::GetFocus() const {
+    return m_Focus.load(std::memory_order_acquire);
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include "reactor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct SwayContainer {
+    std::int64_t id = 0;
+    std::string app_id; // Wayland app_id, or the X11 class for Xwayland windows
+    std::string title;
+};
+
+// Focus as known from the event stream: seeded from GET_TREE when the stream connects and kept
+// current from `window` and `workspace` events.
+struct SwayFocus {
+    std::optional<SwayContainer> focused;
+};
+
+// Sway (and i3) IPC over $SWAYSOCK / $I3SOCK: "i3-ipc" magic, native-endian u32 payload length
+// and message type, then a JSON payload. Events use the same framing with the high bit set in
+// the type.
+class SwayIPC {
+  public:
+    enum MessageType : std::uint32_t {
+        RUN_COMMAND = 0,
+        GET_WORKSPACES = 1,
+        SUBSCRIBE = 2,
+        GET_TREE = 4,
+    };
+    static constexpr std::uint32_t kEventFlag = 0x80000000u;
+    static constexpr std::uint32_t kWorkspaceEvent = kEventFlag | 0;
+    static constexpr std::uint32_t kWindowEvent = kEventFlag | 3;
+    static constexpr std::uint32_t kShutdownEvent = kEventFlag | 6;
+
+    SwayIPC();
+    ~SwayIPC();
+
+    SwayIPC(const SwayIPC &) = delete;
+    SwayIPC &operator=(const SwayIPC &) = delete;
+
+    bool IsAvailable() const;
+
+    // Request/response over a separate, persistent query connection.
+    std::optional<nlohmann::json> SendMessage(std::uint32_t type, const std::string &payload = {},
+                                              std::chrono::milliseconds timeout =
+                                                  std::chrono::milliseconds(1000));
+
+    // Subscribes to window and workspace events on `reactor`; the callback, reconnects and the
+    // focus cache updates all run on the reactor thread. Start/Stop from that thread too.
+    bool StartEventStream(Reactor &reactor,
+                          std::function<void(std::uint32_t type, const nlohmann::json &event)>
+                              callback,
+                          std::chrono::milliseconds reconnect_delay =
+                              std::chrono::milliseconds(1000));
+    void StopEventStream();
+    bool IsEventStreamRunning() const;
+
+    // Latest focus published by the event stream, or null while the stream is down or not yet
+    // seeded (callers then fall back to GET_TREE). Lock-free; safe from any thread.
+    std::shared_ptr<const SwayFocus> GetFocus() const;
+
+    // Focused window in a GET_TREE (or workspace event) node, if a window has focus.
+    static std::optional<SwayContainer> FindFocused(const nlohmann::json &node);
+
+  private:
+    static std::string GetEnvSocketPath();
+    bool ConnectFd(int &fd);
+    static void CloseFd(int &fd);
+    static bool SendAll(int fd, const void *data, std::size_t size);
+    static std::string EncodeMessage(std::uint32_t type, const std::string &payload);
+    static bool ReadExact(int fd, char *out, std::size_t size,
+                          std::chrono::steady_clock::time_point deadline);
+    static SwayContainer ParseContainer(const nlohmann::json &node);
+
+    // Reactor thread only.
+    void ConnectStream();
+    void ScheduleReconnect();
+    void OnStreamReadable();
+    // Returns false when the stream must be dropped (oversized message).
+    bool ParseStreamMessages();
+    void HandleStreamMessage(std::uint32_t type, std::string_view payload);
+    void ApplyEvent(std::uint32_t type, const nlohmann::json &event);
+    void PublishFocus();
+    void CloseStream();
+
+  private:
+    std::string m_SocketPath;
+    int m_QueryFd = -1;
+
+    std::atomic<bool> m_StreamRunning{false};
+    Reactor *m_Reactor = nullptr;
+    std::function<void(std::uint32_t type, const nlohmann::json &event)> m_StreamCallback;
+    std::chrono::milliseconds m_ReconnectDelay{1000};
+    Reactor::TimerId m_ReconnectTimer = 0;
+    int m_StreamFd = -1;
+    std::string m_StreamBuffer;
+    std::size_t m_StreamOffset = 0; // start of the first unparsed message in m_StreamBuffer
+
+    // Owned by the reactor thread; readers only see the published copy.
+    std::optional<SwayContainer> m_StreamFocused;
+    bool m_StreamSeeded = false;
+    std::atomic<std::shared_ptr<const SwayFocus>> m_Focus;
+};
@@ -0,0 +1,205 @@
+#include "taskcache.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// ─────────────────────────────────────
+AnytypeTaskCache::AnytypeTaskCache(Anytype &anytype, const std::filesystem::path &dbPath,
+                                   std::chrono::seconds refreshInterval)
+    : m_Anytype(anytype), m_Mirror(dbPath), m_RefreshInterval(refreshInterval) {}
+
+// ─────────────────────────────────────
+AnytypeTaskCache::~AnytypeTaskCache() {
+    Stop();
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::Start() {
+    if (m_Thread.joinable()) {
+        return;
+    }
+    LoadMirror();
+    m_Thread = std::thread([this] { Run(); });
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::LoadMirror() {
+    const std::string spaceId = m_Anytype.SpaceId();
+    if (spaceId.empty()) {
+        return;
+    }
+
+    auto tasks = std::make_shared<const nlohmann::json>(m_Mirror.FetchAnytypeTasks(spaceId));
+    const double syncedAt = m_Mirror.GetAnytypeTasksSyncedAt(spaceId);
+    if (syncedAt <= 0.0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Snapshot.tasks = std::move(tasks);
+    m_Snapshot.fetchedAt = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double>(syncedAt)));
+    spdlog::info("Anytype task mirror loaded ({} tasks)", m_Snapshot.tasks->size());
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkerCv.notify_all();
+    if (m_Thread.joinable()) {
+        m_Thread.join();
+    }
+}
+
+// ─────────────────────────────────────
+AnytypeTaskCache::Snapshot AnytypeTaskCache::Get() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Snapshot out = m_Snapshot;
+    out.stale = !out.tasks || m_CompletedGen != m_RequestedGen ||
+                std::chrono::system_clock::now() - out.fetchedAt >= m_RefreshInterval;
+    if (out.stale && !m_RefreshWanted) {
+        m_RefreshWanted = true;
+        m_WorkerCv.notify_one();
+    }
+    return out;
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::Invalidate() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_RequestedGen;
+        m_RefreshWanted = true;
+    }
+    m_WorkerCv.notify_one();
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::RequestRefresh() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_RefreshWanted = true;
+    }
+    m_WorkerCv.notify_one();
+}
+
+// ─────────────────────────────────────
+void AnytypeTaskCache::Run() {
+    auto &refreshes = Metrics::Instance().GetHistogram(
+        "concentrate_anytype_task_refresh_duration_seconds",
+        "Background refreshes of the Anytype task cache.");
+    auto &failures = Metrics::Instance().GetCounter(
+        "concentrate_anytype_task_refresh_failures_total",
+        "Background refreshes of the Anytype task cache that failed.");
+    auto &incremental = Metrics::Instance().GetCounter(
+        "concentrate_anytype_task_syncs_total", "Anytype task mirror syncs by kind.",
+        Metrics::Labels({{"kind", "incremental"}}));
+    auto &full = Metrics::Instance().GetCounter("concentrate_anytype_task_syncs_total",
+                                                "Anytype task mirror syncs by kind.",
+                                                Metrics::Labels({{"kind", "full"}}));
+
+    // Failed refreshes are retried sooner than the regular interval.
+    const auto retryDelay = std::min<std::chrono::seconds>(m_RefreshInterval,
+                                                           std::chrono::seconds(15));
+    auto nextRefreshAt = std::chrono::steady_clock::now();
+    auto lastFullSync = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    // The first pass after startup is incremental when the mirror already has tasks.
+    std::uint64_t fullSyncedGen = m_RequestedGen;
+    while (!m_Stop) {
+        m_WorkerCv.wait_until(lock, nextRefreshAt, [&] { return m_Stop || m_RefreshWanted; });
+        if (m_Stop) {
+            break;
+        }
+
+        m_RefreshWanted = false;
+        const std::uint64_t generation = m_RequestedGen;
+        lock.unlock();
+
+        const bool wantFull = generation != fullSyncedGen ||
+                              std::chrono::steady_clock::now() - lastFullSync >= kFullSyncInterval;
+
+        std::shared_ptr<const nlohmann::json> tasks;
+        std::string error;
+        bool skipped = false;
+        if (const auto state = m_Anytype.GetState(); state != Anytype::State::Ready) {
+            // Nothing to gain from hitting a closed port; the mirror keeps being served and
+            // RequestRefresh() is called once the connection comes up.
+            error = std::string("Anytype is ") + Anytype::StateName(state);
+            skipped = true;
+        } else {
+            Metrics::ScopedTimer timer(refreshes);
+            try {
+                const std::string spaceId = m_Anytype.SpaceId();
+                const bool doFull =
+                    wantFull || !m_Mirror.GetAnytypeTasksWatermark(spaceId).has_value();
+                tasks = std::make_shared<const nlohmann::json>(Sync(spaceId, doFull));
+                (doFull ? full : incremental).Inc();
+                if (doFull) {
+                    fullSyncedGen = generation;
+                    lastFullSync = std::chrono::steady_clock::now();
+                }
+            } catch (const std::exception &e) {
+                error = e.what();
+            } catch (...) {
+                error = "unknown error";
+            }
+        }
+
+        lock.lock();
+        const auto now = std::chrono::steady_clock::now();
+        m_CompletedGen = generation;
+        if (tasks) {
+            m_Snapshot.tasks = std::move(tasks);
+            m_Snapshot.fetchedAt = std::chrono::system_clock::now();
+            m_Snapshot.lastError.clear();
+            nextRefreshAt = now + m_RefreshInterval;
+            spdlog::debug("Anytype task cache refreshed ({} tasks)", m_Snapshot.tasks->size());
+        } else if (skipped) {
+            m_Snapshot.lastError = error;
+            nextRefreshAt = now + m_RefreshInterval;
+            spdlog::debug("Anytype task cache refresh skipped: {}", error);
+        } else {
+            failures.Inc();
+            m_Snapshot.lastError = error;
+            nextRefreshAt = now + retryDelay;
+            spdlog::warn("Anytype task cache refresh failed: {}", error);
+        }
+    }
+}
+
+// ─────────────────────────────────────
+nlohmann::json AnytypeTaskCache::Sync(const std::string &spaceId, bool full) {
+    if (full) {
+        const nlohmann::json tasks = m_Anytype.GetTasks(spaceId);
+        std::vector<std::string> liveIds;
+        liveIds.reserve(tasks.size());
+        for (const auto &task : tasks) {
+            liveIds.push_back(task["id"].get<std::string>());
+        }
+        if (!m_Mirror.UpsertAnytypeTasks(spaceId, tasks)) {
+            throw std::runtime_error("failed to write the Anytype task mirror");
+        }
+        const int removed = m_Mirror.TombstoneAnytypeTasks(spaceId, liveIds);
+        spdlog::debug("Anytype full sync: {} tasks, {} removed", tasks.size(), removed);
+    } else {
+        // The newest modified_at mirrored so far, i.e. the newest the syncs have seen.
+        const std::int64_t watermark = m_Mirror.GetAnytypeTasksWatermark(spaceId).value_or(0);
+        std::int64_t newest = watermark;
+        const nlohmann::json changed =
+            m_Anytype.GetTasksModifiedSince(spaceId, watermark, newest);
+        if (!m_Mirror.UpsertAnytypeTasks(spaceId, changed)) {
+            throw std::runtime_error("failed to write the Anytype task mirror");
+        }
+        spdlog::debug("Anytype incremental sync: {} tasks, watermark {} -> {}", changed.size(),
+                      watermark, newest);
+    }
+    return m_Mirror.FetchAnytypeTasks(spaceId);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "anytype.hpp"
+#include "sqlite.hpp"
+
+// Background-synced copy of the Anytype tasks, mirrored into the anytype_tasks table.
+//
+// Request threads never talk to Anytype: they get the last good snapshot right away and, when it
+// is older than the refresh interval, just nudge the worker to revalidate it (stale while
+// revalidate). The snapshot is read back from the mirror, so tasks are available right after a
+// restart even while Anytype is not running.
+//
+// Regular refreshes only fetch tasks modified after the newest one synced so far. A full sweep,
+// which also tombstones tasks that disappeared, runs when the mirror is empty, every
+// kFullSyncInterval and after Invalidate() (space or API key changes, explicit refresh).
+class AnytypeTaskCache {
+  public:
+    struct Snapshot {
+        std::shared_ptr<const nlohmann::json> tasks; // null until the first successful fetch
+        std::chrono::system_clock::time_point fetchedAt{};
+        std::string lastError;
+        bool stale = true;
+    };
+
+    static constexpr std::chrono::minutes kFullSyncInterval{30};
+
+    // Opens its own connection to `dbPath`; the worker thread writes the mirror through it.
+    AnytypeTaskCache(Anytype &anytype, const std::filesystem::path &dbPath,
+                     std::chrono::seconds refreshInterval);
+    ~AnytypeTaskCache();
+
+    void Start();
+    void Stop();
+
+    // Returns immediately; `tasks` is null until the first sync (or mirror load) completes.
+    Snapshot Get();
+
+    // Marks the snapshot stale and schedules a refresh.
+    void Invalidate();
+    // Schedules a regular (incremental) refresh, e.g. once Anytype becomes reachable.
+    void RequestRefresh();
+
+  private:
+    void Run();
+    // One sync pass against Anytype; returns the refreshed mirror contents.
+    nlohmann::json Sync(const std::string &spaceId, bool full);
+    void LoadMirror();
+
+    Anytype &m_Anytype;
+    SQLite m_Mirror;
+    const std::chrono::seconds m_RefreshInterval;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkerCv;
+    Snapshot m_Snapshot;
+    std::uint64_t m_RequestedGen = 1; // bumped by Invalidate()
+    std::uint64_t m_CompletedGen = 0; // generation the last attempt started from
+    bool m_RefreshWanted = true;
+    bool m_Stop = false;
+    std::thread m_Thread;
+};
@@ -0,0 +1,105 @@
+#include "titlecanon.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+
+// ─────────────────────────────────────
+std::vector<TitleCanonicalizer::Rule> TitleCanonicalizer::DefaultRules() {
+    return {
+        // "(3) Inbox", "[12] #general", "Inbox (3)"
+        {"", R"(^\s*[(\[]\d+\+?[)\]]\s*)", ""},
+        {"", R"(\s*[(\[]\d+\+?[)\]]\s*$)", ""},
+        // "Downloading 42%", "Building (7.5 %)"
+        {"", R"(\s*(?:[(\[]\s*\d{1,3}(?:[.,]\d+)?\s?%\s*[)\]]|\d{1,3}(?:[.,]\d+)?\s?%))", ""},
+    };
+}
+
+// ─────────────────────────────────────
+std::vector<TitleCanonicalizer::Rule>
+TitleCanonicalizer::LoadRules(const std::filesystem::path &path) {
+    std::ifstream in(path);
+    if (!in) {
+        return DefaultRules();
+    }
+
+    nlohmann::json config;
+    try {
+        config = nlohmann::json::parse(in);
+    } catch (const std::exception &e) {
+        spdlog::warn("Ignoring title rules in {}: {}", path.string(), e.what());
+        return DefaultRules();
+    }
+
+    std::vector<Rule> rules;
+    if (!config.is_object() || config.value("defaults", true)) {
+        rules = DefaultRules();
+    }
+
+    if (!config.is_object() || !config.contains("rules") || !config["rules"].is_array()) {
+        return rules;
+    }
+
+    for (const auto &entry : config["rules"]) {
+        if (!entry.is_object() || !entry.contains("match") || !entry["match"].is_string()) {
+            spdlog::warn("Title rule without a \"match\" pattern in {}: {}", path.string(),
+                         entry.dump());
+            continue;
+        }
+        Rule rule;
+        rule.appId = entry.value("app_id", "");
+        rule.pattern = entry["match"].get<std::string>();
+        rule.replace = entry.value("replace", "");
+        rules.push_back(std::move(rule));
+    }
+
+    spdlog::info("Loaded {} title rules from {}", rules.size(), path.string());
+    return rules;
+}
+
+// ─────────────────────────────────────
+TitleCanonicalizer::TitleCanonicalizer(const std::vector<Rule> &rules) {
+    m_Rules.reserve(rules.size());
+    for (const auto &rule : rules) {
+        try {
+            m_Rules.push_back(
+                {rule.appId, std::regex(rule.pattern, std::regex::ECMAScript | std::regex::optimize),
+                 rule.replace});
+        } catch (const std::regex_error &e) {
+            spdlog::warn("Skipping title rule '{}': {}", rule.pattern, e.what());
+        }
+    }
+}
+
+// ─────────────────────────────────────
+std::string TitleCanonicalizer::Apply(std::string_view appId, std::string_view title) const {
+    std::string result(title);
+    for (const auto &rule : m_Rules) {
+        if (!rule.appId.empty() && appId.find(rule.appId) == std::string_view::npos) {
+            continue;
+        }
+        result = std::regex_replace(result, rule.regex, rule.replace);
+    }
+
+    // Collapse whitespace runs and trim, so rewrites do not leave stray gaps behind.
+    std::string collapsed;
+    collapsed.reserve(result.size());
+    bool pendingSpace = false;
+    for (const char c : result) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            pendingSpace = !collapsed.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            collapsed.push_back(' ');
+            pendingSpace = false;
+        }
+        collapsed.push_back(c);
+    }
+
+    if (collapsed.empty()) {
+        return std::string(title);
+    }
+    return collapsed;
+}
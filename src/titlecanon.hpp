@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Rewrites window titles before focus intervals are compared, so that volatile fragments
+// (unread badges like "(3) Inbox", progress percentages, a terminal's running command) do not
+// close the interval and start a new focus_log row every few seconds.
+//
+// Rules are applied in order: each one whose app_id pattern occurs in the window's app_id (an
+// empty pattern matches every window) replaces the matches of its regex. Whitespace is then
+// collapsed. A title that would become empty is kept as is.
+//
+// Instances are immutable once built, so one can be shared between threads.
+class TitleCanonicalizer {
+  public:
+    struct Rule {
+        std::string appId;   // substring of the app_id, like the allow-list; empty = any window
+        std::string pattern; // ECMAScript regex
+        std::string replace; // std::regex_replace format ($1, ...)
+    };
+
+    // Unread counters and percentages, for every window.
+    static std::vector<Rule> DefaultRules();
+
+    // Reads {"defaults": true, "rules": [{"app_id": "...", "match": "...", "replace": "..."}]}.
+    // A missing file means the default rules only; invalid rules are logged and skipped.
+    static std::vector<Rule> LoadRules(const std::filesystem::path &path);
+
+    explicit TitleCanonicalizer(const std::vector<Rule> &rules);
+
+    std::string Apply(std::string_view appId, std::string_view title) const;
+    std::size_t RuleCount() const {
+        return m_Rules.size();
+    }
+
+  private:
+    struct CompiledRule {
+        std::string appId;
+        std::regex regex;
+        std::string replace;
+    };
+
+    std::vector<CompiledRule> m_Rules;
+};
@@ -1,4 +1,6 @@
 #include "tray.hpp"
+#include "dbusdispatch.hpp"
+#include "metrics.hpp"
 
 #include <spdlog/spdlog.h>
 
@@ -132,9 +134,8 @@ static void menu_append_layout_node(DBusMessageIter *out, dbus_int32_t id,
 
 // ─────────────────────────────────────
 TrayIcon::~TrayIcon() {
-    m_StopDispatch.store(true);
-    if (m_DispatchThread.joinable()) {
-        m_DispatchThread.join();
+    if (m_ReconnectTimer != 0) {
+        m_Reactor->CancelTimer(m_ReconnectTimer);
     }
 
     DBusConnection *conn = nullptr;
@@ -147,15 +148,17 @@ TrayIcon::~TrayIcon() {
 }
 
 // ─────────────────────────────────────
-bool TrayIcon::Start(std::string title) {
+bool TrayIcon::Start(std::string title, Reactor &reactor, std::function<void()> onRequest) {
     if (m_Started) {
         return true;
     }
 
     m_Title = std::move(title);
+    m_Reactor = &reactor;
+    m_OnRequest = std::move(onRequest);
 
-    // We may send DBus messages from the main thread while a dispatcher thread is running.
-    // Enable libdbus internal locking.
+    // Notifications may be sent from HTTP handler threads on the same shared connection that
+    // the reactor dispatches. Enable libdbus internal locking.
     if (!dbus_threads_init_default()) {
         spdlog::warn("Tray: dbus_threads_init_default failed; tray may be unstable");
     }
@@ -172,65 +175,35 @@ bool TrayIcon::Start(std::string title) {
 
     // Initial registration.
     // Note: Waybar may restart its StatusNotifierWatcher later (e.g. after resume); we handle
-    // that via NameOwnerChanged + reconnect logic in the dispatcher thread.
+    // that via NameOwnerChanged, and bus disconnects via the Disconnected signal + reconnect.
     RegisterWithWatcher();
     m_Started = true;
 
-    // Dispatch DBus continuously so tray method calls don't time out while the app sleeps.
-    m_StopDispatch.store(false);
-    m_DispatchThread = std::thread([this]() {
-        // Reconnect backoff: keep the thread alive across suspend/resume.
-        // We don't rely on Waybar polling; we re-export and re-register when needed.
-        auto nextAttempt = std::chrono::steady_clock::now();
-        while (!m_StopDispatch.load()) {
-            DBusConnection *conn = AcquireConnRef();
-            if (!conn) {
-                // Connection missing (e.g. after teardown). Try to reconnect periodically.
-                const auto now = std::chrono::steady_clock::now();
-                if (now >= nextAttempt) {
-                    (void)Reconnect("no session connection");
-                    nextAttempt = now + std::chrono::seconds(2);
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                continue;
-            }
-
-            if (!dbus_connection_get_is_connected(conn)) {
-                dbus_connection_unref(conn);
-                const auto now = std::chrono::steady_clock::now();
-                if (now >= nextAttempt) {
-                    (void)Reconnect("dbus disconnected");
-                    nextAttempt = now + std::chrono::seconds(2);
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                continue;
-            }
-
-            // Wait a little for IO, then dispatch any pending messages.
-            // This dispatch also delivers NameOwnerChanged to our filter.
-            dbus_connection_read_write_dispatch(conn, 250);
-            dbus_connection_unref(conn);
-
-            // If nothing is happening, avoid a hot loop.
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        }
-    });
-
     spdlog::info("Tray: StatusNotifierItem exported as {}{}", m_BusName, kObjPath);
     return true;
 }
 
 // ─────────────────────────────────────
-void TrayIcon::Poll() {
-    DBusConnection *conn = AcquireConnRef();
-    if (!conn) {
+void TrayIcon::ScheduleReconnect(const char *reason, std::chrono::milliseconds delay) {
+    if (m_ReconnectTimer != 0) {
         return;
     }
+    // Runs outside the dispatch of the dying connection; retried until the bus is back.
+    m_ReconnectTimer =
+        m_Reactor->AddTimer(std::chrono::steady_clock::now() + delay, [this, reason] {
+            m_ReconnectTimer = 0;
+            if (!Reconnect(reason)) {
+                ScheduleReconnect(reason, std::chrono::seconds(2));
+            }
+        });
+}
 
-    // Kept for API compatibility: do a quick non-blocking pump.
-    // The dedicated dispatcher thread is the primary mechanism.
-    dbus_connection_read_write_dispatch(conn, 0);
-    dbus_connection_unref(conn);
+// ─────────────────────────────────────
+void TrayIcon::RaiseRequest(std::atomic<bool> &flag) {
+    flag.store(true);
+    if (m_OnRequest) {
+        m_OnRequest();
+    }
 }
 
 // ─────────────────────────────────────
@@ -291,6 +264,10 @@ DBusHandlerResult TrayIcon::HandleFilter(DBusConnection *, DBusMessage *msg) {
     // Waybar often restarts its StatusNotifierWatcher on resume. When that happens, it forgets
     // previously registered items. We subscribe to NameOwnerChanged for the watcher name so we
     // can re-register ourselves immediately.
+    if (dbus_message_is_signal(msg, DBUS_INTERFACE_LOCAL, "Disconnected")) {
+        ScheduleReconnect("dbus disconnected", std::chrono::milliseconds(0));
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
     if (!dbus_message_is_signal(msg, kIfaceDBus, "NameOwnerChanged")) {
         return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
     }
@@ -402,7 +379,7 @@ DBusHandlerResult TrayIcon::HandleMessage(DBusConnection *conn, DBusMessage *msg
         dbus_message_is_method_call(msg, kIfaceSNI, "ContextMenu") ||
         dbus_message_is_method_call(msg, kIfaceSNI, "Scroll")) {
         if (dbus_message_is_method_call(msg, kIfaceSNI, "Activate")) {
-            m_OpenUiRequested.store(true);
+            RaiseRequest(m_OpenUiRequested);
         }
         // ContextMenu / SecondaryActivate should be handled by the host by showing our
         // DBusMenu from the Menu property. We intentionally do not trigger actions here.
@@ -432,7 +409,14 @@ void TrayIcon::RegisterWithWatcher() {
 
     DBusError err;
     dbus_error_init(&err);
-    DBusMessage *reply = dbus_connection_send_with_reply_and_block(conn, msg, 1000, &err);
+    DBusMessage *reply = nullptr;
+    {
+        static auto &timing = Metrics::Instance().GetHistogram(
+            "concentrate_dbus_call_duration_seconds", "Blocking DBus round trips.",
+            Metrics::Labels({{"call", "RegisterStatusNotifierItem"}}));
+        Metrics::ScopedTimer timer(timing);
+        reply = dbus_connection_send_with_reply_and_block(conn, msg, 1000, &err);
+    }
     if (!reply) {
         // Watcher may not exist; that's fine.
         if (dbus_error_is_set(&err)) {
@@ -592,6 +576,9 @@ bool TrayIcon::SetupConnection() {
         m_Conn = conn;
     }
 
+    if (!DBusDispatch::Attach(*m_Reactor, conn)) {
+        spdlog::warn("Tray: DBus messages will not be dispatched; menu calls will time out");
+    }
     return true;
 }
 
@@ -603,6 +590,8 @@ void TrayIcon::TeardownConnection(DBusConnection *conn) {
 
     // Clean teardown required for reconnect robustness.
     // Suspend/resume may leave the old connection in a half-dead state; explicitly unexport.
+    DBusDispatch::Detach(conn);
+    dbus_connection_remove_filter(conn, &TrayIcon::FilterHandler, this);
     dbus_connection_unregister_object_path(conn, kMenuPath);
     dbus_connection_unregister_object_path(conn, kObjPath);
     dbus_connection_unref(conn);
@@ -1016,9 +1005,9 @@ void TrayIcon::ReplyMenuEvent(DBusConnection *conn, DBusMessage *msg) {
     if (eventId &&
         (std::strcmp(eventId, "clicked") == 0 || std::strcmp(eventId, "activated") == 0)) {
         if (id == kMenuOpenUiId) {
-            m_OpenUiRequested.store(true);
+            RaiseRequest(m_OpenUiRequested);
         } else if (id == kMenuExitId) {
-            m_ExitRequested.store(true);
+            RaiseRequest(m_ExitRequested);
         }
     }
 
@@ -2,11 +2,12 @@
 
 #include <dbus/dbus.h>
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <string>
-#include <thread>
 
 #include "common.hpp"
+#include "reactor.hpp"
 
 class TrayIcon {
   public:
@@ -14,8 +15,9 @@ class TrayIcon {
     ~TrayIcon();
 
     TrayIcon(const TrayIcon &) = delete;
-    bool Start(std::string title);
-    void Poll();
+    // DBus traffic is dispatched on `reactor`; `onRequest` runs there whenever one of the
+    // requests below is raised.
+    bool Start(std::string title, Reactor &reactor, std::function<void()> onRequest);
     void SetTrayIcon(FocusState state);
 
     // Non-blocking, edge-triggered requests coming from tray interactions.
@@ -53,6 +55,8 @@ class TrayIcon {
     bool SetupConnection();
     void TeardownConnection(DBusConnection *conn);
     bool Reconnect(const char *reason);
+    void ScheduleReconnect(const char *reason, std::chrono::milliseconds delay);
+    void RaiseRequest(std::atomic<bool> &flag);
 
     // Install the NameOwnerChanged match rule for org.kde.StatusNotifierWatcher.
     void AddWatcherOwnerChangedMatch(DBusConnection *conn);
@@ -76,8 +80,9 @@ class TrayIcon {
     FocusState m_FocusState = IDLE;
     bool m_Started = false;
 
-    std::atomic<bool> m_StopDispatch{false};
-    std::thread m_DispatchThread;
+    Reactor *m_Reactor = nullptr;
+    std::function<void()> m_OnRequest;
+    Reactor::TimerId m_ReconnectTimer = 0;
 
     std::atomic<bool> m_OpenUiRequested{false};
     std::atomic<bool> m_ExitRequested{false};
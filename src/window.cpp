@@ -1,7 +1,27 @@
 #include "window.hpp"
 
+#include "metrics.hpp"
+
 #include <spdlog/spdlog.h>
 
+// Events the tracker subscribes to; the rest of each stream is dropped by the backend.
+static const std::vector<std::string> kNiriEvents = {
+    "WindowsChanged",
+    "WindowFocusChanged",
+    "WindowOpenedOrChanged",
+    "WindowClosed",
+    "WorkspaceActivated",
+};
+static const std::vector<std::string> kHyprlandEvents = {
+    "activewindow",
+    "activewindowv2",
+    "openwindow",
+    "closewindow",
+    // Title changes need windowtitlev2: the v1 event carries only the address, so it would
+    // wake the tracker without changing the window table.
+    "windowtitlev2",
+};
+
 // ─────────────────────────────────────
 Window::Window() {
     if (m_Niri.IsAvailable()) {
@@ -16,11 +36,20 @@ Window::Window() {
         return;
     }
 
+    if (m_Sway.IsAvailable()) {
+        m_WM = SWAY;
+        spdlog::info("Window manager detected: SWAY");
+        return;
+    }
+
     // Window manager IPC not available at startup; allow fallback behavior.
     m_WM = NIRI;
     spdlog::warn("No supported window manager IPC detected; focus tracking will fall back to idle/polling");
 }
 
+// ─────────────────────────────────────
+Window::Window(WM wm) : m_WM(wm) {}
+
 // ─────────────────────────────────────
 Window::~Window() {
     StopEventStream();
@@ -33,6 +62,8 @@ FocusedWindow Window::GetFocusedWindow() {
         return GetNiriFocusedWindow();
     case HYPRLAND:
         return GetHyprlandFocusedWindow();
+    case SWAY:
+        return GetSwayFocusedWindow();
     default:
         spdlog::error("No supported window manager selected");
         break;
@@ -40,27 +71,22 @@ FocusedWindow Window::GetFocusedWindow() {
     return {};
 }
 
-bool Window::StartEventStream(const std::function<void()> &on_relevant_event) {
+bool Window::StartEventStream(Reactor &reactor, const std::function<void()> &on_relevant_event) {
     if (m_WM == NIRI) {
         if (!m_Niri.IsAvailable()) {
             return false;
         }
 
-        // Subscribe only to the events we care about.
-        const std::vector<std::string> only = {
-            "WindowFocusChanged",
-            "WindowOpenedOrChanged",
-            "WindowClosed",
-            "WorkspaceActivated",
-        };
-
+        // Subscribe only to the events we care about. The stream also keeps NiriIPC's window
+        // table current (WindowsChanged seeds it), so focus reads need no query.
         return m_Niri.StartEventStream(
+            reactor,
             [on_relevant_event](const nlohmann::json &) {
                 if (on_relevant_event) {
                     on_relevant_event();
                 }
             },
-            only);
+            kNiriEvents);
     }
 
     if (m_WM == HYPRLAND) {
@@ -68,22 +94,29 @@ bool Window::StartEventStream(const std::function<void()> &on_relevant_event) {
             return false;
         }
 
-        const std::vector<std::string> only = {
-            "activewindow",
-            "activewindowv2",
-            "openwindow",
-            "closewindow",
-            "windowtitle",
-            "windowtitlev2",
-        };
-
         return m_Hypr.StartEventStream(
+            reactor,
             [on_relevant_event](const std::string &) {
                 if (on_relevant_event) {
                     on_relevant_event();
                 }
             },
-            only);
+            kHyprlandEvents);
+    }
+
+    if (m_WM == SWAY) {
+        if (!m_Sway.IsAvailable()) {
+            return false;
+        }
+
+        // Sway has no per-event filter; the subscription is already limited to window and
+        // workspace events.
+        return m_Sway.StartEventStream(reactor,
+                                       [on_relevant_event](std::uint32_t, const nlohmann::json &) {
+                                           if (on_relevant_event) {
+                                               on_relevant_event();
+                                           }
+                                       });
     }
 
     return false;
@@ -94,6 +127,8 @@ void Window::StopEventStream() {
         m_Niri.StopEventStream();
     } else if (m_WM == HYPRLAND) {
         m_Hypr.StopEventStream();
+    } else if (m_WM == SWAY) {
+        m_Sway.StopEventStream();
     }
 }
 
@@ -104,6 +139,9 @@ bool Window::IsEventStreamRunning() const {
     if (m_WM == HYPRLAND) {
         return m_Hypr.IsEventStreamRunning();
     }
+    if (m_WM == SWAY) {
+        return m_Sway.IsEventStreamRunning();
+    }
     return false;
 }
 
@@ -114,13 +152,114 @@ bool Window::IsAvailable() const {
     if (m_WM == HYPRLAND) {
         return m_Hypr.IsAvailable();
     }
+    if (m_WM == SWAY) {
+        return m_Sway.IsAvailable();
+    }
     return false;
 }
 
+// ─────────────────────────────────────
+const char *Window::BackendName() const {
+    switch (m_WM) {
+    case NIRI:
+        return "niri";
+    case HYPRLAND:
+        return "hyprland";
+    case SWAY:
+        return "sway";
+    case GNOME:
+        return "gnome";
+    case KDE:
+        return "kde";
+    }
+    return "unknown";
+}
+
+// ─────────────────────────────────────
+std::optional<Window::WM> Window::ParseBackendName(std::string_view name) {
+    if (name == "niri") {
+        return NIRI;
+    }
+    if (name == "hyprland") {
+        return HYPRLAND;
+    }
+    return std::nullopt;
+}
+
+// ─────────────────────────────────────
+bool Window::SupportsTape() const {
+    return m_WM == NIRI || m_WM == HYPRLAND;
+}
+
+// ─────────────────────────────────────
+void Window::SetRecorder(IpcTape::Recorder *recorder) {
+    if (m_WM == NIRI) {
+        m_Niri.SetRecorder(recorder);
+    } else if (m_WM == HYPRLAND) {
+        m_Hypr.SetRecorder(recorder);
+    }
+}
+
+// ─────────────────────────────────────
+bool Window::StartReplay(const std::function<void()> &on_relevant_event,
+                         IpcTape::ReplySource replies) {
+    if (m_WM == NIRI) {
+        m_Niri.StartReplay(
+            [on_relevant_event](const nlohmann::json &) {
+                if (on_relevant_event) {
+                    on_relevant_event();
+                }
+            },
+            kNiriEvents, std::move(replies));
+        return true;
+    }
+
+    if (m_WM == HYPRLAND) {
+        m_Hypr.StartReplay(
+            [on_relevant_event](const std::string &) {
+                if (on_relevant_event) {
+                    on_relevant_event();
+                }
+            },
+            kHyprlandEvents, std::move(replies));
+        return true;
+    }
+
+    return false;
+}
+
+// ─────────────────────────────────────
+void Window::ReplayEvent(std::string_view line) {
+    if (m_WM == NIRI) {
+        m_Niri.ReplayStreamLine(line);
+    } else if (m_WM == HYPRLAND) {
+        m_Hypr.ReplayStreamLine(line);
+    }
+}
+
 // ─────────────────────────────────────
 FocusedWindow Window::GetNiriFocusedWindow() {
+    static auto &fromTable = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "niri"}, {"source", "table"}}));
+    static auto &fromQuery = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "niri"}, {"source", "query"}}));
+
     FocusedWindow focus;
 
+    if (const auto table = m_Niri.GetWindowTable()) {
+        fromTable.Inc();
+        if (const NiriWindow *w = table->Focused()) {
+            focus.window_id = static_cast<int>(w->id);
+            focus.app_id = w->app_id;
+            focus.title = w->title;
+            focus.valid = true;
+        }
+        return focus;
+    }
+
+    fromQuery.Inc();
     const auto root_opt = m_Niri.SendEnumRequest("FocusedWindow");
     if (!root_opt.has_value()) {
         spdlog::debug("No response from niri FocusedWindow IPC");
@@ -165,8 +304,25 @@ FocusedWindow Window::GetNiriFocusedWindow() {
 
 // ─────────────────────────────────────
 FocusedWindow Window::GetHyprlandFocusedWindow() {
+    static auto &fromTable = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "hyprland"}, {"source", "table"}}));
+    static auto &fromQuery = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "hyprland"}, {"source", "query"}}));
+
     FocusedWindow focus;
 
+    if (const auto table = m_Hypr.GetWindowTable()) {
+        fromTable.Inc();
+        auto [cls, title] = table->Active();
+        focus.app_id = std::move(cls);
+        focus.title = std::move(title);
+        focus.valid = (!focus.app_id.empty() || !focus.title.empty());
+        return focus;
+    }
+
+    fromQuery.Inc();
     const auto ct = m_Hypr.GetActiveClassAndTitle();
     if (!ct.has_value()) {
         spdlog::debug("No response from Hyprland IPC (active window)");
@@ -178,3 +334,39 @@ FocusedWindow Window::GetHyprlandFocusedWindow() {
     focus.valid = (!focus.app_id.empty() || !focus.title.empty());
     return focus;
 }
+
+// ─────────────────────────────────────
+FocusedWindow Window::GetSwayFocusedWindow() {
+    static auto &fromTable = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "sway"}, {"source", "table"}}));
+    static auto &fromQuery = Metrics::Instance().GetCounter(
+        "concentrate_focus_lookups_total", "Focused window lookups by source.",
+        Metrics::Labels({{"backend", "sway"}, {"source", "query"}}));
+
+    FocusedWindow focus;
+    std::optional<SwayContainer> focused;
+
+    if (const auto cached = m_Sway.GetFocus()) {
+        fromTable.Inc();
+        focused = cached->focused;
+    } else {
+        fromQuery.Inc();
+        const auto tree = m_Sway.SendMessage(SwayIPC::GET_TREE);
+        if (!tree.has_value()) {
+            spdlog::debug("No response from sway GET_TREE IPC");
+            return focus;
+        }
+        focused = SwayIPC::FindFocused(*tree);
+    }
+
+    if (!focused) {
+        return focus;
+    }
+
+    focus.window_id = static_cast<int>(focused->id);
+    focus.app_id = std::move(focused->app_id);
+    focus.title = std::move(focused->title);
+    focus.valid = true;
+    return focus;
+}
@@ -8,25 +8,45 @@
 #include "common.hpp"
 #include "niri.hpp"
 #include "hyprland.hpp"
+#include "sway.hpp"
+#include "ipctape.hpp"
 
 #include <functional>
+#include <optional>
+#include <string_view>
 
 class Window {
   public:
+    enum WM { NIRI, SWAY, HYPRLAND, GNOME, KDE };
+
     Window();
+    // For replay: uses `wm` without looking for a running compositor.
+    explicit Window(WM wm);
     ~Window();
     FocusedWindow GetFocusedWindow();
-    bool StartEventStream(const std::function<void()> &on_relevant_event);
+    // The stream runs on `reactor`; `on_relevant_event` is called from the reactor thread.
+    bool StartEventStream(Reactor &reactor, const std::function<void()> &on_relevant_event);
     void StopEventStream();
     bool IsEventStreamRunning() const;
     bool IsAvailable() const;
     void setLastActivity(std::chrono::steady_clock::time_point lastActivity);
-    enum WM { NIRI, SWAY, HYPRLAND, GNOME, KDE };
+
+    // Record-and-replay of the compositor IPC (see IpcTape); niri and Hyprland only.
+    const char *BackendName() const;
+    static std::optional<WM> ParseBackendName(std::string_view name);
+    bool SupportsTape() const;
+    // Set before StartEventStream; `recorder` must outlive the stream.
+    void SetRecorder(IpcTape::Recorder *recorder);
+    // Instead of StartEventStream: events come from ReplayEvent() and queries from `replies`.
+    bool StartReplay(const std::function<void()> &on_relevant_event, IpcTape::ReplySource replies);
+    void ReplayEvent(std::string_view line);
 
   private:
     FocusedWindow GetNiriFocusedWindow();
     FocusedWindow GetHyprlandFocusedWindow();
+    FocusedWindow GetSwayFocusedWindow();
     WM m_WM;
     NiriIPC m_Niri;
     HyprlandIPC m_Hypr;
+    SwayIPC m_Sway;
 };
@@ -0,0 +1,170 @@
+// LineFramer checks: random chunk splits against a reference splitter, oversized lines, and a
+// throughput loop. Built with -DCONCENTRATE_BUILD_TESTS=ON, run by ctest.
+
+#include "lineframer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int g_Failures = 0;
+
+#define CHECK(cond)                                                                                \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);          \
+            ++g_Failures;                                                                          \
+        }                                                                                          \
+    } while (0)
+
+// ─────────────────────────────────────
+static std::vector<std::string> ReferenceSplit(const std::string &stream) {
+    std::vector<std::string> lines;
+    std::size_t begin = 0;
+    for (std::size_t nl = stream.find('\n'); nl != std::string::npos;
+         nl = stream.find('\n', begin)) {
+        lines.push_back(stream.substr(begin, nl - begin));
+        begin = nl + 1;
+    }
+    return lines;
+}
+
+// ─────────────────────────────────────
+static std::string RandomStream(std::mt19937 &rng, std::size_t lines) {
+    std::uniform_int_distribution<int> length(0, 300);
+    std::uniform_int_distribution<int> byte('a', 'z');
+    std::string stream;
+    for (std::size_t i = 0; i < lines; ++i) {
+        const int n = length(rng);
+        for (int c = 0; c < n; ++c) {
+            stream.push_back(static_cast<char>(byte(rng)));
+        }
+        stream.push_back('\n');
+    }
+    // An unterminated tail must stay buffered.
+    stream += "partial";
+    return stream;
+}
+
+// ─────────────────────────────────────
+static void TestRandomSplits() {
+    std::mt19937 rng(1234);
+    for (int round = 0; round < 200; ++round) {
+        const std::string stream = RandomStream(rng, 50);
+        const std::vector<std::string> expected = ReferenceSplit(stream);
+
+        LineFramer framer;
+        std::vector<std::string> got;
+        std::uniform_int_distribution<std::size_t> chunk(1, 700);
+        for (std::size_t at = 0; at < stream.size();) {
+            const std::size_t n = std::min(chunk(rng), stream.size() - at);
+            framer.Append(std::string_view(stream).substr(at, n));
+            at += n;
+            while (auto line = framer.Next()) {
+                got.emplace_back(*line);
+            }
+        }
+        CHECK(got == expected);
+        CHECK(framer.Buffered() == std::string_view("partial").size());
+    }
+}
+
+// ─────────────────────────────────────
+static void TestSocketSplits() {
+    std::mt19937 rng(99);
+    const std::string stream = RandomStream(rng, 500);
+    const std::vector<std::string> expected = ReferenceSplit(stream);
+
+    int fds[2];
+    CHECK(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+    LineFramer framer;
+    std::vector<std::string> got;
+    std::uniform_int_distribution<std::size_t> chunk(1, 4096);
+    for (std::size_t at = 0; at < stream.size();) {
+        const std::size_t n = std::min(chunk(rng), stream.size() - at);
+        CHECK(::send(fds[1], stream.data() + at, n, 0) == static_cast<ssize_t>(n));
+        at += n;
+        const auto result =
+            framer.Drain(fds[0], [&](std::string_view line) { got.emplace_back(line); });
+        CHECK(result == LineFramer::Result::Timeout);
+    }
+    CHECK(got == expected);
+
+    ::close(fds[1]);
+    CHECK(framer.Drain(fds[0], [](std::string_view) {}) == LineFramer::Result::Closed);
+    ::close(fds[0]);
+}
+
+// ─────────────────────────────────────
+static void TestTooLong() {
+    LineFramer framer(64);
+    int fds[2];
+    CHECK(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    const std::string ok = std::string(64, 'x') + "\n";
+    CHECK(::send(fds[1], ok.data(), ok.size(), 0) == static_cast<ssize_t>(ok.size()));
+    std::string_view line;
+    CHECK(framer.ReadLine(fds[0], std::chrono::milliseconds(100), line) ==
+          LineFramer::Result::Line);
+    CHECK(line.size() == 64);
+
+    const std::string huge(1000, 'y');
+    CHECK(::send(fds[1], huge.data(), huge.size(), 0) == static_cast<ssize_t>(huge.size()));
+    CHECK(framer.ReadLine(fds[0], std::chrono::milliseconds(100), line) ==
+          LineFramer::Result::TooLong);
+
+    framer.Clear();
+    CHECK(framer.Buffered() == 0);
+    CHECK(framer.ReadLine(fds[0], std::chrono::milliseconds(10), line) ==
+          LineFramer::Result::Timeout);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+// ─────────────────────────────────────
+static void Throughput() {
+    std::mt19937 rng(7);
+    const std::string stream = RandomStream(rng, 20000);
+    constexpr int kRounds = 50;
+    constexpr std::size_t kChunk = 64 * 1024;
+
+    LineFramer framer;
+    std::size_t lines = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (std::size_t at = 0; at < stream.size(); at += kChunk) {
+            framer.Append(std::string_view(stream).substr(at, kChunk));
+            while (framer.Next()) {
+                ++lines;
+            }
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(lines > 0);
+    std::printf("throughput: %zu lines, %.1f MiB/s\n", lines,
+                static_cast<double>(stream.size()) * kRounds / (1024.0 * 1024.0) /
+                    elapsed.count());
+}
+
+// ─────────────────────────────────────
+int main() {
+    TestRandomSplits();
+    TestSocketSplits();
+    TestTooLong();
+    Throughput();
+    if (g_Failures > 0) {
+        std::fprintf(stderr, "%d checks failed\n", g_Failures);
+        return 1;
+    }
+    std::printf("all lineframer checks passed\n");
+    return 0;
+}
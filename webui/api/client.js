@@ -7,14 +7,36 @@ async function readTextSafe(res) {
 }
 
 // ─────────────────────────────────────
+// `loading` is set while the server has no task snapshot yet (503); `fresh` tells whether the
+// snapshot is up to date (X-Cache) or a background refresh is still pending.
 export async function loadAnytypeTasks() {
     const res = await fetch("/api/v1/anytype/tasks", { cache: "no-store" });
     if (!res.ok) {
         const text = await readTextSafe(res);
-        return { ok: false, errorText: text || "Failed to load Anytype tasks.", tasks: [] };
+        return {
+            ok: false,
+            loading: res.status === 503,
+            fresh: false,
+            errorText: text || "Failed to load Anytype tasks.",
+            tasks: [],
+        };
     }
     const tasks = await res.json();
-    return { ok: true, errorText: "", tasks: Array.isArray(tasks) ? tasks : [] };
+    return {
+        ok: true,
+        loading: false,
+        fresh: res.headers.get("X-Cache") === "fresh",
+        errorText: "",
+        tasks: Array.isArray(tasks) ? tasks : [],
+    };
+}
+
+// ─────────────────────────────────────
+// The current task as resolved by the server: { id, title, markdown }.
+export async function loadCurrentTask() {
+    const res = await fetch("/api/v1/anytype/current_task", { cache: "no-store" });
+    if (!res.ok) return null;
+    return await res.json();
 }
 
 // ─────────────────────────────────────
@@ -120,7 +142,7 @@ export async function loadEvents() {
 
 // ─────────────────────────────────────
 export async function loadHistoryRaw() {
-    const res = await fetch("/api/v1/history", { cache: "no-store" });
+    const res = await fetch("/api/v1/history", { cache: "no-cache" });
     if (!res.ok) return [];
     const history = await res.json();
     return Array.isArray(history) ? history : [];
@@ -174,7 +196,7 @@ export async function loadFocusCategoryPercentages(days) {
     const res = await fetch(`/api/v1/focus/category-percentages?days=${days}`, {
         method: "GET",
         headers: { "Content-Type": "application/json" },
-        cache: "no-store",
+        cache: "no-cache",
     });
     if (!res.ok) return [];
     const rows = await res.json();
@@ -198,14 +220,14 @@ export async function loadFocusToday(days) {
 
 // ─────────────────────────────────────
 export async function loadFocusAppUsage(days) {
-    const res = await fetch(`/api/v1/focus/app-usage?days=${days}`, { cache: "no-store" });
+    const res = await fetch(`/api/v1/focus/app-usage?days=${days}`, { cache: "no-cache" });
     if (!res.ok) return { ok: false, data: null };
     return { ok: true, data: await res.json() };
 }
 
 // ─────────────────────────────────────
 export async function loadHistoryCategoryTime(days) {
-    const res = await fetch(`/api/v1/history/category-time?days=${days}`, { cache: "no-store" });
+    const res = await fetch(`/api/v1/history/category-time?days=${days}`, { cache: "no-cache" });
     if (!res.ok) return { ok: false, rows: [] };
     const data = await res.json();
     return { ok: true, rows: Array.isArray(data) ? data : [] };
@@ -213,7 +235,7 @@ export async function loadHistoryCategoryTime(days) {
 
 // ─────────────────────────────────────
 export async function loadHistoryCategoryFocus(days) {
-    const res = await fetch(`/api/v1/history/category-focus?days=${days}`, { cache: "no-store" });
+    const res = await fetch(`/api/v1/history/category-focus?days=${days}`, { cache: "no-cache" });
     if (!res.ok) return { ok: false, rows: [] };
     const data = await res.json();
     return { ok: true, rows: Array.isArray(data) ? data : [] };
@@ -324,7 +346,7 @@ export async function saveAnytypeConfig(apiKey, spaceId) {
 }
 
 // ─────────────────────────────────────
-// BUG: Not implemented on the server
+// Only starts the refresh (202); follow it with loadAnytypeTasks().fresh.
 export async function refreshAnytypeCache() {
     const res = await fetch("/api/v1/anytype/refresh", { method: "POST" });
     if (!res.ok) return { ok: false, errorText: await readTextSafe(res) };
@@ -37,9 +37,16 @@ export class AnytypeManager {
     async loadTasks() {
         this.anytypeError = null;
         try {
-            const { ok, errorText, tasks } = await API.loadAnytypeTasks();
+            const { ok, loading, errorText, tasks } = await API.loadAnytypeTasks();
             if (!ok) {
                 this.anytypeError = errorText || "Failed to load Anytype tasks.";
+                // The first sync is still running on the server; ask again shortly.
+                if (loading && !this.anytypeLoadRetry) {
+                    this.anytypeLoadRetry = setTimeout(() => {
+                        this.anytypeLoadRetry = null;
+                        this.refreshAll();
+                    }, 2000);
+                }
                 return [];
             }
             if (!Array.isArray(tasks)) return [];
@@ -288,7 +295,13 @@ export class AnytypeManager {
                 if (status) status.textContent = errorText || "Failed to update.";
                 return;
             }
-            if (status) status.textContent = "Updated.";
+            // The refresh runs in the background; wait (up to 30 s) for a fresh snapshot.
+            let fresh = false;
+            for (let i = 0; i < 30 && !fresh; i++) {
+                await new Promise((resolve) => setTimeout(resolve, 1000));
+                ({ fresh } = await API.loadAnytypeTasks());
+            }
+            if (status) status.textContent = fresh ? "Updated." : "Still updating in the background…";
             await this.refreshAll();
         } catch (err) {
             console.error("Failed to refresh Anytype cache", err);
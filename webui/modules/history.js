@@ -112,8 +112,8 @@ export class HistoryManager {
             }
 
             const [timeRes, focusRes] = await Promise.all([
-                fetch(`/api/v1/history/category-time?days=${days}`, { cache: "no-store" }),
-                fetch(`/api/v1/history/category-focus?days=${days}`, { cache: "no-store" }),
+                fetch(`/api/v1/history/category-time?days=${days}`, { cache: "no-cache" }),
+                fetch(`/api/v1/history/category-focus?days=${days}`, { cache: "no-cache" }),
             ]);
 
             const timeFrag = document.createDocumentFragment();
@@ -254,7 +254,7 @@ export class HistoryManager {
         startLoading(list);
 
         const res = await fetch(`/api/v1/focus/app-usage?days=${days}`, {
-            cache: "no-store",
+            cache: "no-cache",
         });
 
         if (!res.ok) {
@@ -252,7 +252,7 @@ export class TaskView {
                     );
                 }
 
-                if (isCurrent && task.markdown) {
+                if (isCurrent) {
                     setTimeout(() => {
                         this.renderTaskMarkdown(task);
                     }, 0);
@@ -278,9 +278,13 @@ export class TaskView {
     }
 
     async renderTaskMarkdown(task) {
-        if (!task?.markdown) return;
+        if (!task?.id) return;
 
-        const markdown = task.markdown;
+        // The task list carries no bodies; the server keeps the current task's.
+        const current = await API.loadCurrentTask();
+        if (!current || String(current.id) !== String(task.id) || !current.markdown) return;
+
+        const markdown = current.markdown;
         const match = markdown.match(/## TO-DO[\s\S]*$/);
         if (!match) return null;
 